@@ -62,6 +62,7 @@ static ocl_context_t ocl_open(int32_t ix, ocl_override_t* ov) {
     c.c = clCreateContext(properties, 1, &id, ocl_error_notify, null, &r);
     not_null(c.c, r);
     c.q = ocl_create_queue(&c, ocl.is_profiling(&c));
+    c.t = ocl_create_queue(&c, ocl.is_profiling(&c));
     return c;
 }
 
@@ -91,14 +92,17 @@ static void* ocl_create_queue(ocl_context_t* c, bool profiling) {
 }
 
 static void ocl_flush(ocl_context_t* c) {
+    call(clFlush((cl_command_queue)c->t));
     call(clFlush((cl_command_queue)c->q));
 }
 
 static void ocl_finish(ocl_context_t* c) {
+    call(clFinish((cl_command_queue)c->t));
     call(clFinish((cl_command_queue)c->q));
 }
 
 static void ocl_dispose_queue(ocl_context_t* c) {
+    call(clReleaseCommandQueue((cl_command_queue)c->t));
     call(clReleaseCommandQueue((cl_command_queue)c->q));
 }
 
@@ -140,6 +144,157 @@ static void  ocl_unmap(ocl_context_t* c, ocl_memory_t m, const void* a) {
         0, null, null));
 }
 
+static ocl_event_t ocl_write(ocl_context_t* c, ocl_memory_t m, size_t offset,
+        size_t bytes, const void* data) {
+    cl_event done = null;
+    call(clEnqueueWriteBuffer((cl_command_queue)c->q, (cl_mem)m,
+        /*blocking_write: */ false, offset, bytes, data, 0, null, &done));
+    return (ocl_event_t)done;
+}
+
+static ocl_event_t ocl_read(ocl_context_t* c, ocl_memory_t m, size_t offset,
+        size_t bytes, void* data) {
+    cl_event done = null;
+    call(clEnqueueReadBuffer((cl_command_queue)c->q, (cl_mem)m,
+        /*blocking_read: */ false, offset, bytes, data, 0, null, &done));
+    return (ocl_event_t)done;
+}
+
+static ocl_event_t ocl_upload(ocl_context_t* c, ocl_memory_t m,
+        size_t offset, size_t bytes, const void* data,
+        int waits, const ocl_event_t wait[]) {
+    assert(waits >= 0 && (waits == 0) == (wait == null));
+    cl_event done = null;
+    call(clEnqueueWriteBuffer((cl_command_queue)c->t, (cl_mem)m,
+        /*blocking_write: */ false, offset, bytes, data,
+        (cl_uint)waits, (const cl_event*)wait, &done));
+    call(clFlush((cl_command_queue)c->t)); // start copy now
+    return (ocl_event_t)done;
+}
+
+static void ocl_double_buffer_init(ocl_double_buffer_t* db,
+        ocl_context_t* c, ocl_memory_t b0, ocl_memory_t b1,
+        ocl_memory_t s0, ocl_memory_t s1, size_t bytes) {
+    memset(db, 0, sizeof(*db));
+    db->c = c;
+    db->buffer[0] = b0;
+    db->buffer[1] = b1;
+    db->staging[0] = s0;
+    db->staging[1] = s1;
+    for (int i = 0; i < 2; i++) {
+        if (db->staging[i] != null) {
+            db->pinned[i] = ocl.map(c, CL_MAP_WRITE_INVALIDATE_REGION,
+                db->staging[i], 0, bytes);
+            fatal_if(db->pinned[i] == null, "map staging[%d] failed", i);
+        }
+    }
+}
+
+static ocl_memory_t ocl_double_buffer_upload(ocl_double_buffer_t* db,
+        const void* data, size_t bytes, ocl_event_t* uploaded) {
+    const int32_t i = db->ix;
+    fatal_if(db->buffer[i] == null, "buffer[%d] is null", i);
+    ocl_event_t* wait = db->consumed[i] != null ? &db->consumed[i] : null;
+    if (db->pinned[i] != null) {
+        // previous upload from pinned[i] must be complete before
+        // it is overwritten:
+        if (db->uploaded[i] != null) { ocl.wait(&db->uploaded[i], 1); }
+        memcpy(db->pinned[i], data, bytes);
+        data = db->pinned[i];
+    }
+    if (db->uploaded[i] != null) { ocl.release_event(db->uploaded[i]); }
+    db->uploaded[i] = ocl.upload(db->c, db->buffer[i], 0, bytes, data,
+        wait != null ? 1 : 0, wait);
+    *uploaded = db->uploaded[i];
+    return db->buffer[i];
+}
+
+static void ocl_double_buffer_consumed(ocl_double_buffer_t* db,
+        ocl_event_t e) {
+    const int32_t i = db->ix;
+    if (db->consumed[i] != null) { ocl.release_event(db->consumed[i]); }
+    ocl.retain_event(e);
+    db->consumed[i] = e;
+    db->ix = i ^ 1;
+}
+
+static void ocl_double_buffer_fini(ocl_double_buffer_t* db) {
+    for (int i = 0; i < 2; i++) {
+        if (db->consumed[i] != null) {
+            ocl.wait(&db->consumed[i], 1);
+            ocl.release_event(db->consumed[i]);
+        }
+        if (db->uploaded[i] != null) {
+            ocl.wait(&db->uploaded[i], 1);
+            ocl.release_event(db->uploaded[i]);
+        }
+        if (db->pinned[i] != null) {
+            ocl.unmap(db->c, db->staging[i], db->pinned[i]);
+        }
+    }
+    memset(db, 0, sizeof(*db));
+}
+
+static int64_t ocl_pool_class(size_t bytes) {
+    int64_t s = 256; // smallest class
+    while (s < (int64_t)bytes) { s <<= 1; }
+    if (s > MB) { // limit waste to 1/8 for large buffers
+        const int64_t q = s / 8;
+        s = ((int64_t)bytes + q - 1) / q * q;
+    }
+    return s;
+}
+
+static void ocl_pool_init(ocl_pool_t* p, ocl_context_t* c, int64_t capacity) {
+    memset(p, 0, sizeof(*p));
+    p->c = c;
+    p->capacity = capacity;
+}
+
+static ocl_memory_t ocl_pool_get(ocl_pool_t* p, int access, size_t bytes) {
+    const int64_t s = ocl_pool_class(bytes);
+    for (int32_t i = 0; i < p->count; i++) {
+        if (p->idle[i].access == access && p->idle[i].bytes == s) {
+            ocl_memory_t m = p->idle[i].m;
+            p->bytes -= s;
+            p->idle[i] = p->idle[--p->count];
+            p->hits++;
+            return m;
+        }
+    }
+    p->misses++;
+    return ocl.allocate(p->c, access, (size_t)s);
+}
+
+static void ocl_pool_put(ocl_pool_t* p, ocl_memory_t m) {
+    if (m != null) {
+        size_t bytes = 0;
+        cl_mem_flags flags = 0;
+        call(clGetMemObjectInfo((cl_mem)m, CL_MEM_SIZE, sizeof(bytes),
+            &bytes, null));
+        call(clGetMemObjectInfo((cl_mem)m, CL_MEM_FLAGS, sizeof(flags),
+            &flags, null));
+        const int64_t s = (int64_t)bytes;
+        const bool sized = ocl_pool_class(bytes) == s; // not from pool_get()?
+        if (sized && p->count < ocl_pool_slots && p->bytes + s <= p->capacity) {
+            // allocate() adds CL_MEM_ALLOC_HOST_PTR to the access flags:
+            p->idle[p->count].access = (int32_t)(flags & ~CL_MEM_ALLOC_HOST_PTR);
+            p->idle[p->count].bytes = s;
+            p->idle[p->count].m = m;
+            p->count++;
+            p->bytes += s;
+        } else {
+            ocl.deallocate(m);
+        }
+    }
+}
+
+static void ocl_pool_fini(ocl_pool_t* p) {
+    for (int32_t i = 0; i < p->count; i++) { ocl.deallocate(p->idle[i].m); }
+    p->count = 0;
+    p->bytes = 0;
+}
+
 static ocl_shared_t ocl_alloc_shared(ocl_context_t* c, int access, size_t bytes) {
     ocl_shared_t s = {
         .access = access,
@@ -268,6 +423,36 @@ static ocl_event_t ocl_enqueue_args(ocl_context_t* c,
     return (ocl_event_t)done;
 }
 
+static ocl_event_t ocl_enqueue_wait(ocl_context_t* c, ocl_kernel_t k,
+        int dimensions, const int64_t global[], const int64_t local[],
+        int argc, ocl_arg_t argv[], int waits, const ocl_event_t wait[]) {
+    assert(1 <= dimensions && dimensions <= 3);
+    assert(waits >= 0 && (waits == 0) == (wait == null));
+    for (int i = 0; i < argc; i++) {
+        call(clSetKernelArg((cl_kernel)k, i, argv[i].bytes, argv[i].p));
+    }
+    size_t global_work_size[3] = {0};
+    size_t local_work_size[3] = {0};
+    for (int i = 0; i < dimensions; i++) {
+        assert(global[i] > 0);
+        global_work_size[i] = (size_t)global[i];
+        if (local != null) { local_work_size[i] = (size_t)local[i]; }
+    }
+    cl_event done = null;
+    call(clEnqueueNDRangeKernel((cl_command_queue)c->q, (cl_kernel)k,
+            dimensions, null, global_work_size,
+            local != null ? local_work_size : null,
+            (cl_uint)waits, (const cl_event*)wait, &done));
+    return (ocl_event_t)done;
+}
+
+static ocl_event_t ocl_enqueue_range(ocl_context_t* c, ocl_kernel_t k,
+        int dimensions, const int64_t global[], const int64_t local[],
+        int argc, ocl_arg_t argv[]) {
+    return ocl_enqueue_wait(c, k, dimensions, global, local, argc, argv,
+        0, null);
+}
+
 static ocl_event_t ocl_enqueue(ocl_context_t* c, ocl_kernel_t k, int64_t n,
         ...) {
     va_list vl;
@@ -330,6 +515,13 @@ static void ocl_wait(ocl_event_t* events, int count) {
     call(clWaitForEvents(count, (cl_event*)events));
 }
 
+static bool ocl_is_complete(ocl_event_t e) {
+    cl_int status = CL_QUEUED;
+    call(clGetEventInfo((cl_event)e, CL_EVENT_COMMAND_EXECUTION_STATUS,
+        sizeof(status), &status, null));
+    return status <= CL_COMPLETE; // CL_COMPLETE == 0, errors are negative
+}
+
 static void ocl_retain_event(ocl_event_t e) {
     call(clRetainEvent((cl_event)e));
 }
@@ -355,8 +547,12 @@ static void ocl_kernel_info(ocl_context_t* c, ocl_kernel_t kernel,
     get_val(CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE,
         info->preferred_work_group_multiple);
     get_val(CL_KERNEL_PRIVATE_MEM_SIZE, info->private_mem_size);
-    get_val(CL_KERNEL_GLOBAL_WORK_SIZE, info->global_work_size);
     #pragma pop_macro("get_val")
+    // CL_KERNEL_GLOBAL_WORK_SIZE is only valid for custom devices and
+    // built-in kernels (CL_INVALID_VALUE otherwise):
+    info->global_work_size = 0;
+    (void)clGetKernelWorkGroupInfo(k, device_id, CL_KERNEL_GLOBAL_WORK_SIZE,
+        sizeof(info->global_work_size), &info->global_work_size, null);
 }
 
 static void ocl_close(ocl_context_t* c) {
@@ -729,6 +925,17 @@ ocl_if ocl = {
     .access_to_map = ocl_access_to_map,
     .map = ocl_map,
     .unmap = ocl_unmap,
+    .write = ocl_write,
+    .read = ocl_read,
+    .upload = ocl_upload,
+    .double_buffer_init = ocl_double_buffer_init,
+    .double_buffer_upload = ocl_double_buffer_upload,
+    .double_buffer_consumed = ocl_double_buffer_consumed,
+    .double_buffer_fini = ocl_double_buffer_fini,
+    .pool_init = ocl_pool_init,
+    .pool_get = ocl_pool_get,
+    .pool_put = ocl_pool_put,
+    .pool_fini = ocl_pool_fini,
     .alloc_shared = ocl_alloc_shared,
     .map_shared = ocl_map_shared,
     .unmap_shared = ocl_unmap_shared,
@@ -738,7 +945,10 @@ ocl_if ocl = {
     .kernel_info = ocl_kernel_info,
     .enqueue_args = ocl_enqueue_args,
     .enqueue = ocl_enqueue,
+    .enqueue_range = ocl_enqueue_range,
+    .enqueue_wait = ocl_enqueue_wait,
     .wait = ocl_wait,
+    .is_complete = ocl_is_complete,
     .profile_add = ocl_profile_add,
     .profile = ocl_profile,
     .retain_event = ocl_retain_event,
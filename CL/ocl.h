@@ -128,6 +128,7 @@ typedef struct ocl_context_s {
     int32_t ix; // device index
     void*   c; // OpenCL context
     void*   q; // OpenCL command queue
+    void*   t; // transfer queue: upload() runs concurrently with "q"
     ocl_override_t* ov;
 } ocl_context_t;
 
@@ -148,6 +149,45 @@ typedef struct ocl_shared_s {  // TODO: if double mapping is not necessary delet
     int32_t access; // CL_MEM_READ_WRITE, CL_MEM_WRITE_ONLY, CL_MEM_READ_ONLY
 } ocl_shared_t;
 
+// Pool of device buffers for temporaries. Requested sizes are rounded up
+// to size classes (powers of 2, above 1MB multiples of 1/8 of the power
+// of 2) so recycled buffers may be larger than requested. Up to "capacity"
+// bytes of idle buffers are kept, pool_put() beyond it deallocates.
+
+enum { ocl_pool_slots = 64 }; // max number of idle buffers
+
+typedef struct ocl_pool_s {
+    ocl_context_t* c;
+    int64_t capacity; // max idle bytes, 0 - no recycling (may be changed)
+    int64_t bytes;    // idle bytes
+    int64_t hits;     // pool_get() recycled an idle buffer
+    int64_t misses;   // pool_get() allocated a new buffer
+    int32_t count;    // number of idle buffers
+    struct {
+        ocl_memory_t m;
+        int32_t access;
+        int64_t bytes; // size class
+    } idle[ocl_pool_slots];
+} ocl_pool_t;
+
+// Double buffered upload: while kernel reads buffer[i] the next upload()
+// fills buffer[i ^ 1] on the transfer queue. upload() waits (on device)
+// for the kernels that read the buffer two uploads ago (see consumed()).
+// With staging buffers data is first copied to mapped (pinned) staging[i]
+// and DMA transfers it from there: pageable host memory is not uploaded
+// directly and the host copy of the next tile overlaps with the transfer
+// and the kernel of the previous one.
+
+typedef struct ocl_double_buffer_s {
+    ocl_context_t* c;
+    ocl_memory_t buffer[2]; // owned by caller
+    ocl_memory_t staging[2]; // owned by caller, null: no staging
+    void* pinned[2]; // mapped staging[i]
+    ocl_event_t uploaded[2]; // upload into buffer[i] is complete
+    ocl_event_t consumed[2]; // last kernel reading buffer[i] is complete
+    int32_t ix; // buffer of next upload()
+} ocl_double_buffer_t;
+
 // alloc/allocate/alloc_shared access flags:
 // CL_MEM_READ_WRITE .. CL_MEM_KERNEL_READ_AND_WRITE
 // map/map_shared mapping flags
@@ -174,6 +214,37 @@ typedef struct ocl_if {
         size_t offset, size_t bytes); // may return null
     // memory must be unmapped before the kernel is executed
     void (*unmap)(ocl_context_t* c, ocl_memory_t m, const void* address);
+    // non-blocking host to device copy: data[bytes] must stay intact
+    // until returned event is complete. Caller must release_event()
+    ocl_event_t (*write)(ocl_context_t* c, ocl_memory_t m, size_t offset,
+        size_t bytes, const void* data);
+    // non-blocking device to host copy ordered after queued kernels:
+    // data[bytes] is valid when returned event is complete (or finish())
+    ocl_event_t (*read)(ocl_context_t* c, ocl_memory_t m, size_t offset,
+        size_t bytes, void* data);
+    // write() on the transfer queue after wait[waits] events complete.
+    // Kernels must wait for returned event (it is not ordered with "q"):
+    ocl_event_t (*upload)(ocl_context_t* c, ocl_memory_t m, size_t offset,
+        size_t bytes, const void* data, int waits, const ocl_event_t wait[]);
+    // double_buffer_upload() returns the buffer data[bytes] is uploaded to
+    // and event kernels must wait for (owned by double buffer).
+    // consumed(e) must follow with the event of the last kernel reading
+    // that buffer (retained by double buffer, caller still must release).
+    // s0, s1 - optional (null) pinned alloc() staging buffers of "bytes"
+    // (at least the largest upload) mapped until double_buffer_fini():
+    void (*double_buffer_init)(ocl_double_buffer_t* db, ocl_context_t* c,
+        ocl_memory_t b0, ocl_memory_t b1,
+        ocl_memory_t s0, ocl_memory_t s1, size_t bytes);
+    ocl_memory_t (*double_buffer_upload)(ocl_double_buffer_t* db,
+        const void* data, size_t bytes, ocl_event_t* uploaded);
+    void (*double_buffer_consumed)(ocl_double_buffer_t* db, ocl_event_t e);
+    void (*double_buffer_fini)(ocl_double_buffer_t* db); // waits for all
+    // pool_get() never returns null, pool_put(null) is OK.
+    // pool_fini() deallocates all idle buffers.
+    void (*pool_init)(ocl_pool_t* p, ocl_context_t* c, int64_t capacity);
+    ocl_memory_t (*pool_get)(ocl_pool_t* p, int access, size_t bytes);
+    void (*pool_put)(ocl_pool_t* p, ocl_memory_t m);
+    void (*pool_fini)(ocl_pool_t* p);
     // device/host shared memory (w/o fine-grained access/atomics)
     // alloc_shared().a and .m will be null if failed
     // experimentally NVIDIA GPU only allows 1GB mapping... :(
@@ -193,9 +264,21 @@ typedef struct ocl_if {
         int64_t n, ...); // void*, size_t bytes, ... terminate with null, 0
     ocl_event_t (*enqueue_args)(ocl_context_t* c, ocl_kernel_t k,
         int64_t n, int argc, ocl_arg_t argv[]);
+    // 1..3 dimensional range kernel: global[dimensions] work items in
+    // groups of local[dimensions] (local == null - implementation defined)
+    ocl_event_t (*enqueue_range)(ocl_context_t* c, ocl_kernel_t k,
+        int dimensions, const int64_t global[], const int64_t local[],
+        int argc, ocl_arg_t argv[]);
+    // enqueue_range() that starts after all wait[waits] events complete
+    // (waits == 0 and wait == null - no dependencies):
+    ocl_event_t (*enqueue_wait)(ocl_context_t* c, ocl_kernel_t k,
+        int dimensions, const int64_t global[], const int64_t local[],
+        int argc, ocl_arg_t argv[], int waits, const ocl_event_t wait[]);
     // appends queued event to array of profiling events;
     ocl_profiling_t* (*profile_add)(ocl_context_t* c, ocl_event_t e);
     void (*wait)(ocl_event_t* events, int count);
+    // non-blocking: true when command of event "e" is complete (or failed)
+    bool (*is_complete)(ocl_event_t e);
     void (*flush)(ocl_context_t* c); // all queued command to GPU
     void (*finish)(ocl_context_t* c); // waits for all commands to finish
     // must wait(&p->e, 1) or call .finish() before calling profile(p)
@@ -243,6 +326,6 @@ extern ocl_if ocl;
   that all work-items have completed their previous work-items before
   continuing execution.
 
-  enqueue_range_kernel is 1-dimensional version of clEnqueueNDRangeKernel.
-  enqueue_range_kernel_2D/3D can be exposed if needed.
+  enqueue() is 1-dimensional version of clEnqueueNDRangeKernel.
+  enqueue_range() exposes 2D/3D ranges with explicit work-group sizes.
 */
\ No newline at end of file
@@ -36,159 +36,145 @@ static void blast_unmap(blast_memory_t* bm) {
     bm->m = null;
 }
 
-// Think about what is known in at compiler time for Parallel Reduction
-// (e.g. sum of vector elements).
-// https://developer.download.nvidia.com/assets/cuda/files/reduction.pdf
+enum { blast_pool_capacity = 16 * 1024 * 1024 }; // default bytes
 
+// Parallel Reduction (e.g. sum of vector elements) is done in work group
+// local memory, see blast.cl dot_reduce() and sum_reduce().
+// https://developer.download.nvidia.com/assets/cuda/files/reduction.pdf
+// n elements take one launch for n <= reduce_items and two otherwise.
 
-// TODO: there are permutations not addressed here:
-// s0 == 1  v1 s1 != 1 (both can be addressed wiht single kernel with
-// s0 != 1  v1 s1 == 1  swapped arguments)
-// and same for offsets because address + offset still take 1 to 2 cpu
-// cycles (int32_t or int64_t)
-// all in all, there are 8 combinations with only simplest two implemented
-// at the moment. Other can be easily added on AS NEEDED basis for later
-// optimization.
-// The main goal of blast is to implement gemv(fp16_t) for huge LLM GPT
-// and where dot() optimizations may turn to be irrelevant and better
-// handled by AVX2/AVX512.
-
-static void blast_dot_compact(int64_t n,
-        blast_memory_t* v0, blast_memory_t* v1, blast_memory_t* r, int fpp) {
-    blast_t* b = v0->b;
-    ocl_context_t* c = b->c;
-    double user = ocl.is_profiling(c) ? seconds() : 0;
-    ocl_event_t e = ocl.enqueue(c,
-        b->dot_c[fpp], n,
-            &v0->h, sizeof(ocl_memory_t),
-            &v1->h, sizeof(ocl_memory_t),
-            &r->h,  sizeof(ocl_memory_t),
-            null, 0
-    );
-    user = ocl.is_profiling(c) ? (seconds() - user) : 0;
-    if (ocl.is_profiling(c)) {
+static ocl_event_t blast_reduce(ocl_context_t* c, ocl_kernel_t k,
+        int64_t groups, int64_t items, int64_t count, int64_t fops,
+        int argc, ocl_arg_t argv[], bool profile,
+        int waits, const ocl_event_t wait[]) {
+    const int64_t global[1] = { groups * items };
+    const int64_t local[1]  = { items };
+    double user = profile ? seconds() : 0;
+    ocl_event_t e = ocl.enqueue_wait(c, k, 1, global, local, argc, argv,
+        waits, wait);
+    user = profile ? (seconds() - user) : 0;
+    if (profile) {
         ocl_profiling_t* p = ocl.profile_add(c, e);
         p->user = user;
-        p->count = n;
-        p->fops = 1;
+        p->count = count;
+        p->fops = fops;
+        p->i32ops = 0;
     }
-    ocl.release_event(e);
+    return e;
 }
 
-static void blast_dot_strided(int64_t n,
-        blast_memory_t* v0, int64_t o0, int64_t s0,
-        blast_memory_t* v1, int64_t o1, int64_t s1,
-        blast_memory_t* r,  int fpp) {
-    blast_t* b = v0->b;
-    ocl_context_t* c = b->c;
-    double user = ocl.is_profiling(c) ? seconds() : 0;
-    ocl_event_t e = ocl.enqueue(c, b->dot_os[fpp], n,
-        &v0->h, sizeof(ocl_memory_t),
-        &o0,    sizeof(int32_t),
-        &s0,    sizeof(int32_t),
-        &v1->h, sizeof(ocl_memory_t),
-        &o1,    sizeof(int32_t),
-        &s1,    sizeof(int32_t),
-        &r->h,  sizeof(ocl_memory_t),
-        null, 0
-    );
-    user = ocl.is_profiling(c) ? (seconds() - user) : 0;
-    if (ocl.is_profiling(c)) {
-        ocl_profiling_t* p = ocl.profile_add(c, e);
-        p->user = user;
-        p->count = n;
-        p->fops = 1;
-        p->i32ops = 4;
+static int64_t blast_accu_bytes(int fpp) {
+    // fp16_t partial sums are fp32_t (see accu_t in blast.cl):
+    return fpp == ocl_fpp16 ? 4 : ocl_fpp_bytes[fpp];
+}
+
+static void blast_reclaim(blast_t* b) { // returns complete held to pool
+    for (int i = 0; i < b->holding; i++) {
+        if (ocl.is_complete(b->held[i].e)) {
+            ocl.release_event(b->held[i].e);
+            ocl.pool_put(&b->pool, b->held[i].m);
+            b->held[i] = b->held[--b->holding];
+            i--;
+        }
     }
-    ocl.release_event(e);
 }
 
-static fp64_t read_1xfp_from_memory(blast_memory_t* m, int fpp) {
-    fp64_t v = 0;
-    void* a = blast.map(m, CL_MAP_READ, 0, ocl_fpp_bytes[fpp]);
-    switch (fpp) {
-        case ocl_fpp16: v = fp16to32(*(fp16_t*)a); break;
-        case ocl_fpp32: v = *(fp32_t*)a; break;
-        case ocl_fpp64: v = *(fp64_t*)a; break;
-        default: fatal_if("fpp", "%d", fpp); break;
+static void blast_hold(blast_t* b, ocl_memory_t m, ocl_event_t e) {
+    if (b->holding == countof(b->held)) { // wait for one to complete
+        ocl.wait(&b->held[0].e, 1);
+        blast_reclaim(b);
     }
-    blast.unmap(m);
-    return v;
+    ocl.retain_event(e);
+    b->held[b->holding].m = m;
+    b->held[b->holding].e = e;
+    b->holding++;
 }
 
-static fp64_t sum_and_finish(blast_memory_t* v, int64_t ne, int fpp) {
-    blast_t* b = v->b;
+static void blast_release_held(blast_t* b) { // waits for all held
+    for (int i = 0; i < b->holding; i++) {
+        ocl.wait(&b->held[i].e, 1);
+        ocl.release_event(b->held[i].e);
+        ocl.pool_put(&b->pool, b->held[i].m);
+    }
+    b->holding = 0;
+}
+
+static ocl_event_t blast_dot_enqueue(
+        blast_memory_t* v0, int64_t o0, int64_t s0,
+        blast_memory_t* v1, int64_t o1, int64_t s1, int64_t n,
+        ocl_memory_t r, int64_t offset_r, int fpp, bool profile,
+        int waits, const ocl_event_t wait[]) {
+    fatal_if(v0->b != v1->b, "foreign vectors");
+    fatal_if(fpp < ocl_fpp16 || ocl_fpp64 < fpp, "fpp: %d", fpp);
+    blast_t* b = v0->b;
     ocl_context_t* c = b->c;
-    fp64_t sum = 0;
-    if (ne == 1) {
-        ocl.finish(c);
-        sum = read_1xfp_from_memory(v, fpp);
-    } else {
-        int64_t n = ne;
-        int64_t m = n / 2;
-        int64_t bytes = ne * ocl_fpp_bytes[fpp] / 2; // odd "ne" truncated
-        enum { read_only  = CL_MEM_READ_ONLY|CL_MEM_HOST_READ_ONLY };
-        blast_memory_t  s = blast.allocate(v->b, read_only, bytes);
-        blast_memory_t* v0 = v;
-        blast_memory_t* v1 = &s;
-        while (m >= 1) {
-            ocl_kernel_t k = n % 2 == 0 ? b->sum_even[fpp] : b->sum_odd[fpp];
-            double user = ocl.is_profiling(c) ? seconds() : 0;
-            ocl_event_t e = ocl.enqueue(c, k, m,
-                &v0->h,  sizeof(ocl_memory_t),
-                &v1->h,  sizeof(ocl_memory_t),
-                null, 0
-            );
-            user = ocl.is_profiling(c) ? (seconds() - user) : 0;
-            if (ocl.is_profiling(c)) {
-                ocl_profiling_t* p = ocl.profile_add(c, e);
-                p->user = user;
-                p->count = ne;
-                p->fops   = 1;
-                p->i32ops = 0;
-            }
-            ocl.release_event(e);
-            blast_memory_t* swap = v0; v0 = v1; v1 = swap;
-            n  = m;
-            m /= 2;
-        }
-        ocl.finish(c); // same as waiting for chain of events
-        sum = read_1xfp_from_memory(v0, fpp);
-        blast.deallocate(&s);
+    blast_reclaim(b);
+    const int64_t accu_bytes = blast_accu_bytes(fpp);
+    const int64_t items  = b->reduce_items[fpp];
+    int64_t groups = min(ocl.devices[c->ix].max_groups,
+                         max((n + items - 1) / items, 1));
+    // single group writes r[offset_r] directly, otherwise partial sums
+    // go to a pooled temporary held until sum_reduce() is done with it:
+    enum { device_only = CL_MEM_READ_WRITE|CL_MEM_HOST_NO_ACCESS };
+    ocl_memory_t p = groups > 1 ?
+        ocl.pool_get(&b->pool, device_only, (size_t)(groups * accu_bytes)) : r;
+    int64_t offset_p = groups > 1 ? 0 : offset_r;
+    ocl_arg_t dot_argv[] = {
+        { &v0->h,    sizeof(ocl_memory_t) },
+        { &o0,       sizeof(int64_t) },
+        { &s0,       sizeof(int64_t) },
+        { &v1->h,    sizeof(ocl_memory_t) },
+        { &o1,       sizeof(int64_t) },
+        { &s1,       sizeof(int64_t) },
+        { &n,        sizeof(int64_t) },
+        { &p,        sizeof(ocl_memory_t) },
+        { &offset_p, sizeof(int64_t) },
+        { null,      items * accu_bytes } // __local accu_t sm[items]
+    };
+    ocl_event_t e = blast_reduce(c, b->dot_reduce[fpp], groups, items, n,
+        2, countof(dot_argv), dot_argv, profile, waits, wait);
+    if (groups > 1) { // r[offset_r] = sum(p[0..groups - 1])
+        ocl_arg_t sum_argv[] = {
+            { &p,        sizeof(ocl_memory_t) },
+            { &groups,   sizeof(int32_t) },
+            { &r,        sizeof(ocl_memory_t) },
+            { &offset_r, sizeof(int64_t) },
+            { null,      items * accu_bytes }
+        };
+        ocl_event_t s = blast_reduce(c, b->sum_reduce[fpp], 1, items,
+            groups, 1, countof(sum_argv), sum_argv, profile, 1, &e);
+        ocl.release_event(e);
+        e = s;
+        blast_hold(b, p, e);
     }
-    return sum;
+    return e;
+}
+
+static fp64_t blast_dot_result(blast_memory_t* r, int64_t offset, int fpp,
+        ocl_event_t done) {
+    if (done != null) { ocl.wait(&done, 1); }
+    const int64_t accu_bytes = blast_accu_bytes(fpp);
+    void* a = blast.map(r, CL_MAP_READ, offset * accu_bytes, accu_bytes);
+    fp64_t s = accu_bytes == 4 ? *(fp32_t*)a : *(fp64_t*)a;
+    blast.unmap(r);
+    return s;
 }
 
 static fp64_t blast_dot(
         blast_memory_t* v0, int64_t o0, int64_t s0,
         blast_memory_t* v1, int64_t o1, int64_t s1, int64_t n,
         int fpp) { // ocl_fpp16, ocl_fpp32, ocl_fpp64
-    fatal_if(v0->b != v1->b, "foreign vectors");
-    fatal_if(fpp < ocl_fpp16 || ocl_fpp64 < fpp, "fpp: %d", fpp);
     blast_t* b = v0->b;
     ocl_context_t* c = b->c;
-    fp64_t s = 0;
-    const int64_t max_groups = ocl.devices[c->ix].max_groups;
-    const int64_t max_items  = ocl.devices[c->ix].max_items[0];
     if (ocl.is_profiling(c)) { c->ov->profiling_count = 0; }
-    size_t bytes = ocl_fpp_bytes[fpp];
-    while (n > 0) {
-        int64_t ne = min(max_items * max_groups, n);
-        enum { read_only = CL_MEM_READ_ONLY|CL_MEM_HOST_READ_ONLY };
-        blast_memory_t r = blast.allocate(b, read_only, ne * bytes);
-//      ocl.migrate_undefined(r.b->c, r.h);
-        if (o0 == 0 && s0 == 1 && o1 == 0 && s1 == 1) {
-            blast_dot_compact(ne, v0, v1, &r, fpp);
-        } else {
-//          println("offsets: %8lld %8lld strides: %lld %lld ne: %8lld", o0, o1, s0, s1, ne);
-            blast_dot_strided(ne, v0, o0, s0, v1, o1, s1, &r, fpp);
-        }
-        s += sum_and_finish(&r, ne, fpp);
-        blast.deallocate(&r);
-        n  -= ne;
-        o0 += ne * s0;
-        o1 += ne * s1;
-    }
+    enum { host_read = CL_MEM_READ_WRITE|CL_MEM_HOST_READ_ONLY };
+    blast_memory_t r = { .b = b, .s = blast_accu_bytes(fpp) };
+    r.h = ocl.pool_get(&b->pool, host_read, (size_t)r.s);
+    ocl_event_t e = blast_dot_enqueue(v0, o0, s0, v1, o1, s1, n,
+        (ocl_memory_t)r.h, 0, fpp, ocl.is_profiling(c), 0, null);
+    fp64_t s = blast_dot_result(&r, 0, fpp, e);
+    ocl.release_event(e);
+    ocl.pool_put(&b->pool, (ocl_memory_t)r.h);
     if (ocl.is_profiling(c) && c->ov->profiling_count) {
         ocl_profiling_t* p = &c->ov->profiling[0];
         ocl.profile(&p[0]);
@@ -225,6 +211,145 @@ static fp64_t blast_dot_fp64(
     return blast_dot(v0, o0, s0, v1, o1, s1, n, ocl_fpp64);
 }
 
+static ocl_event_t blast_dot_async_fp16(
+        blast_memory_t* v0, int64_t o0, int64_t s0,
+        blast_memory_t* v1, int64_t o1, int64_t s1, int64_t n,
+        blast_memory_t* r, int64_t offset_r,
+        int waits, const ocl_event_t wait[]) {
+    return blast_dot_enqueue(v0, o0, s0, v1, o1, s1, n,
+        (ocl_memory_t)r->h, offset_r, ocl_fpp16, false, waits, wait);
+}
+
+static ocl_event_t blast_dot_async_fp32(
+        blast_memory_t* v0, int64_t o0, int64_t s0,
+        blast_memory_t* v1, int64_t o1, int64_t s1, int64_t n,
+        blast_memory_t* r, int64_t offset_r,
+        int waits, const ocl_event_t wait[]) {
+    return blast_dot_enqueue(v0, o0, s0, v1, o1, s1, n,
+        (ocl_memory_t)r->h, offset_r, ocl_fpp32, false, waits, wait);
+}
+
+static ocl_event_t blast_dot_async_fp64(
+        blast_memory_t* v0, int64_t o0, int64_t s0,
+        blast_memory_t* v1, int64_t o1, int64_t s1, int64_t n,
+        blast_memory_t* r, int64_t offset_r,
+        int waits, const ocl_event_t wait[]) {
+    return blast_dot_enqueue(v0, o0, s0, v1, o1, s1, n,
+        (ocl_memory_t)r->h, offset_r, ocl_fpp64, false, waits, wait);
+}
+
+enum { // must match TSM, TSN, WPTM, WPTN in blast.cl
+    blast_gemm_tsm  = 64, blast_gemm_tsn  = 64,
+    blast_gemm_rtsm = 16, blast_gemm_rtsn = 16
+};
+
+static ocl_event_t blast_gemm_enqueue(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k, int fpp, bool profile,
+        int waits, const ocl_event_t wait[]) {
+    fatal_if(a->b != b->b || a->b != c->b, "foreign matrices");
+    fatal_if(fpp < ocl_fpp16 || ocl_fpp64 < fpp, "fpp: %d", fpp);
+    blast_t* bl = a->b;
+    ocl_context_t* oc = bl->c;
+    const int64_t global[2] = {
+        (m + blast_gemm_tsm - 1) / blast_gemm_tsm * blast_gemm_rtsm,
+        (n + blast_gemm_tsn - 1) / blast_gemm_tsn * blast_gemm_rtsn
+    };
+    const int64_t local[2] = { blast_gemm_rtsm, blast_gemm_rtsn };
+    ocl_arg_t argv[] = {
+        { &a->h,     sizeof(ocl_memory_t) },
+        { &offset_a, sizeof(int64_t) },
+        { &b->h,     sizeof(ocl_memory_t) },
+        { &offset_b, sizeof(int64_t) },
+        { &c->h,     sizeof(ocl_memory_t) },
+        { &offset_c, sizeof(int64_t) },
+        { &m,        sizeof(int64_t) },
+        { &n,        sizeof(int64_t) },
+        { &k,        sizeof(int64_t) }
+    };
+    double user = profile ? seconds() : 0;
+    ocl_event_t e = ocl.enqueue_wait(oc, bl->gemm_c[fpp], 2, global, local,
+        countof(argv), argv, waits, wait);
+    user = profile ? (seconds() - user) : 0;
+    if (profile) {
+        ocl_profiling_t* p = ocl.profile_add(oc, e);
+        p->user = user;
+        p->count = 1;
+        p->fops = m * n * k * 2;
+    }
+    return e;
+}
+
+static void blast_gemm(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k, int fpp) {
+    ocl_context_t* oc = a->b->c;
+    if (ocl.is_profiling(oc)) { oc->ov->profiling_count = 0; }
+    ocl_event_t e = blast_gemm_enqueue(a, offset_a, b, offset_b, c, offset_c,
+        m, n, k, fpp, ocl.is_profiling(oc), 0, null);
+    ocl.finish(oc);
+    ocl.release_event(e);
+    if (ocl.is_profiling(oc)) { ocl.profile(&oc->ov->profiling[0]); }
+}
+
+static void blast_gemm_fp16(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k) {
+    blast_gemm(a, offset_a, b, offset_b, c, offset_c, m, n, k, ocl_fpp16);
+}
+
+static void blast_gemm_fp32(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k) {
+    blast_gemm(a, offset_a, b, offset_b, c, offset_c, m, n, k, ocl_fpp32);
+}
+
+static void blast_gemm_fp64(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k) {
+    blast_gemm(a, offset_a, b, offset_b, c, offset_c, m, n, k, ocl_fpp64);
+}
+
+static ocl_event_t blast_gemm_async_fp16(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k,
+        int waits, const ocl_event_t wait[]) {
+    return blast_gemm_enqueue(a, offset_a, b, offset_b, c, offset_c,
+        m, n, k, ocl_fpp16, false, waits, wait);
+}
+
+static ocl_event_t blast_gemm_async_fp32(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k,
+        int waits, const ocl_event_t wait[]) {
+    return blast_gemm_enqueue(a, offset_a, b, offset_b, c, offset_c,
+        m, n, k, ocl_fpp32, false, waits, wait);
+}
+
+static ocl_event_t blast_gemm_async_fp64(
+        blast_memory_t* a, int64_t offset_a,
+        blast_memory_t* b, int64_t offset_b,
+        blast_memory_t* c, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k,
+        int waits, const ocl_event_t wait[]) {
+    return blast_gemm_enqueue(a, offset_a, b, offset_b, c, offset_c,
+        m, n, k, ocl_fpp64, false, waits, wait);
+}
+
 static const char* blast_program_options(blast_t* b, int fpp) {
     static const char* type_t[] = {"half", "float", "double"};
     static const char* suffix[] = {"fp16", "fp32", "fp64"};
@@ -261,6 +386,8 @@ static ocl_program_t blast_compile(blast_t* b, int fpp,
 
 static void blast_init(blast_t* b, ocl_context_t* c) {
     b->c = c;
+    b->holding = 0;
+    ocl.pool_init(&b->pool, c, blast_pool_capacity);
     void* code = null;
     int64_t bytes = 0;
     int r = memmap_resource("blast_cl", &code, &bytes);
@@ -273,29 +400,61 @@ static void blast_init(blast_t* b, ocl_context_t* c) {
         ocl.has_fpp(b->c, ocl_fpp64) ? 
             blast_compile(b, ocl_fpp64, code, bytes) : null
     };
-    static const char* sum_odd[]     = {"sum_odd_fp16",     "sum_odd_fp32",     "sum_odd_fp64"};
-    static const char* sum_odd_os[]  = {"sum_odd_os_fp16",  "sum_odd_os_fp32",  "sum_odd_os_fp64"};
-    static const char* sum_even[]    = {"sum_even_fp16",    "sum_even_fp32",    "sum_even_fp64"};
-    static const char* sum_even_os[] = {"sum_even_os_fp16", "sum_even_os_fp32", "sum_even_os_fp64"};
-    static const char* dot[]         = {"dot_fp16",         "dot_fp32",         "dot_fp64"};
-    static const char* dot_os[]      = {"dot_os_fp16",      "dot_os_fp32",      "dot_os_fp64"};
+    static const char* dot_reduce[]  = {"dot_reduce_fp16",  "dot_reduce_fp32",  "dot_reduce_fp64"};
+    static const char* sum_reduce[]  = {"sum_reduce_fp16",  "sum_reduce_fp32",  "sum_reduce_fp64"};
     static const char* gemv[]        = {"gemv_fp16",        "gemv_fp32",        "gemv_fp64"};
     static const char* gemv_os[]     = {"gemv_os_fp16",     "gemv_os_fp32",     "gemv_os_fp64"};
+    static const char* gemm[]        = {"gemm_fp16",        "gemm_fp32",        "gemm_fp64"};
     for (int fp = ocl_fpp16; fp <= ocl_fpp64; fp++) {
         if (p[fp] != null) {
-            b->sum_odd[fp]     = ocl.create_kernel(p[fp], sum_odd[fp]);
-            b->sum_odd_os[fp]  = ocl.create_kernel(p[fp], sum_odd_os[fp]);
-            b->sum_even[fp]    = ocl.create_kernel(p[fp], sum_even[fp]);
-            b->sum_even_os[fp] = ocl.create_kernel(p[fp], sum_even_os[fp]);
-            b->dot_c[fp]       = ocl.create_kernel(p[fp], dot[fp]);
-            b->dot_os[fp]      = ocl.create_kernel(p[fp], dot_os[fp]);
+            b->dot_reduce[fp]  = ocl.create_kernel(p[fp], dot_reduce[fp]);
+            b->sum_reduce[fp]  = ocl.create_kernel(p[fp], sum_reduce[fp]);
             b->gemv_c[fp]      = ocl.create_kernel(p[fp], gemv[fp]);
             b->gemv_os[fp]     = ocl.create_kernel(p[fp], gemv_os[fp]);
+            b->gemm_c[fp]      = ocl.create_kernel(p[fp], gemm[fp]);
             ocl.release_program(p[fp]);
+            // reduction work group: largest power of 2 that fits both kernels
+            ocl_kernel_info_t dk = {0};
+            ocl_kernel_info_t sk = {0};
+            ocl.kernel_info(c, b->dot_reduce[fp], &dk);
+            ocl.kernel_info(c, b->sum_reduce[fp], &sk);
+            int64_t limit = min(min(dk.work_group, sk.work_group),
+                                min(ocl.devices[c->ix].max_items[0], 256));
+            b->reduce_items[fp] = 1;
+            while (b->reduce_items[fp] * 2 <= limit) { b->reduce_items[fp] *= 2; }
+            // gemm needs RTSM x RTSN work group:
+            ocl_kernel_info_t ki = {0};
+            ocl.kernel_info(c, b->gemm_c[fp], &ki);
+            if (ki.work_group >= blast_gemm_rtsm * blast_gemm_rtsn) {
+                switch (fp) {
+                    case ocl_fpp16:
+                        b->gemm[fp] = blast_gemm_fp16;
+                        b->gemm_async[fp] = blast_gemm_async_fp16;
+                        break;
+                    case ocl_fpp32:
+                        b->gemm[fp] = blast_gemm_fp32;
+                        b->gemm_async[fp] = blast_gemm_async_fp32;
+                        break;
+                    case ocl_fpp64:
+                        b->gemm[fp] = blast_gemm_fp64;
+                        b->gemm_async[fp] = blast_gemm_async_fp64;
+                        break;
+                    default: fatal_if("never");
+                }
+            }
             switch (fp) {
-                case ocl_fpp16: b->dot[fp] = blast_dot_fp16; break;
-                case ocl_fpp32: b->dot[fp] = blast_dot_fp32; break;
-                case ocl_fpp64: b->dot[fp] = blast_dot_fp64; break;
+                case ocl_fpp16:
+                    b->dot[fp] = blast_dot_fp16;
+                    b->dot_async[fp] = blast_dot_async_fp16;
+                    break;
+                case ocl_fpp32:
+                    b->dot[fp] = blast_dot_fp32;
+                    b->dot_async[fp] = blast_dot_async_fp32;
+                    break;
+                case ocl_fpp64:
+                    b->dot[fp] = blast_dot_fp64;
+                    b->dot_async[fp] = blast_dot_async_fp64;
+                    break;
                 default: fatal_if("never");
             }
         }
@@ -308,15 +467,14 @@ static void blast_release_kernel(ocl_kernel_t k) {
 
 static void blast_fini(blast_t* b) {
     for (int fp = ocl_fpp16; fp <= ocl_fpp64; fp++) {
-        blast_release_kernel(b->sum_odd[fp]);
-        blast_release_kernel(b->sum_odd_os[fp]);
-        blast_release_kernel(b->sum_even[fp]);
-        blast_release_kernel(b->sum_even_os[fp]);
-        blast_release_kernel(b->dot_c[fp]);
-        blast_release_kernel(b->dot_os[fp]);
+        blast_release_kernel(b->dot_reduce[fp]);
+        blast_release_kernel(b->sum_reduce[fp]);
         blast_release_kernel(b->gemv_c[fp]);
         blast_release_kernel(b->gemv_os[fp]);
+        blast_release_kernel(b->gemm_c[fp]);
     }
+    blast_release_held(b);
+    ocl.pool_fini(&b->pool);
 }
 
 blast_if blast = {
@@ -325,5 +483,6 @@ blast_if blast = {
     .deallocate = blast_deallocate,
     .map        = blast_map,
     .unmap      = blast_unmap,
+    .dot_result = blast_dot_result,
     .fini       = blast_fini
 };
@@ -58,60 +58,54 @@
 #define fp_ro_t __global const fp_t* // pointer to read only elements
 #define fp_wr_t __global fp_t*       // pointer to write only elements
 
-__kernel void name(sum_odd, suffix)(fp_ro_t const v, fp_wr_t r) {
-    const int32_t i = get_global_id(0);
-    const int32_t m = get_global_size(0); // middle
-    const int32_t e = get_global_size(0) * 2; // end
-    if (i == 0) { // extra one for odd for first element only
-        r[0] = v[0] + v[m] + v[e];
-    } else {
-        r[i] = v[i] + v[i + m];
-    }
-}
+// dot_reduce() does parallel reduction of the products in a single launch:
+// every work item accumulates grid strided products in a register, the work
+// group sums them up in local memory and writes one partial
+// r[offset_r + group]. For more than one group sum_reduce() is enqueued as
+// a single work group to sum up partials into r[offset_r].
+// Work group size (get_local_size(0)) must be power of 2.
+// See: https://developer.download.nvidia.com/assets/cuda/files/reduction.pdf
 
-__kernel void name(sum_even, suffix)(fp_ro_t const v, fp_wr_t r) {
-    const int32_t i = get_global_id(0);
-    const int32_t m = get_global_size(0);
-    r[i] = v[i] + v[(i + m)];
-}
+#if fpp == 16
+#define accu_t float // fp16 partial sums are accumulated in fp32
+#else
+#define accu_t fp_t
+#endif
 
-__kernel void name(sum_odd_os, suffix)(fp_ro_t v,
-        const int32_t offset, const int32_t stride, fp_wr_t r) {
-    const int32_t i = get_global_id(0);
-    const int32_t m = get_global_size(0); // middle
-    const int32_t e = get_global_size(0) * 2; // end
-    if (i == 0) {
-        r[i] = v[offset + i * stride] + v[offset + (i + m) * stride] +
-               v[offset + e * stride]; // extra one for odd
-    } else {
-        r[i] = v[offset + i * stride] + v[offset + (i + m) * stride];
-    }
-}
+#define accu_wr_t __global accu_t*
 
-__kernel void name(sum_even_os, suffix)(fp_ro_t const v,
-        const int32_t offset, const int32_t stride, fp_wr_t r) {
-    const int32_t i = get_global_id(0);
-    const int32_t m = get_global_size(0);
-    r[i] = v[offset + i * stride] + v[offset + (i + m) * stride];
+void name(reduce, suffix)(accu_t s, __local accu_t* sm, accu_wr_t r) {
+    const int32_t lid = get_local_id(0);
+    sm[lid] = s;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (int32_t i = get_local_size(0) / 2; i > 0; i /= 2) {
+        if (lid < i) { sm[lid] += sm[lid + i]; }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (lid == 0) { r[get_group_id(0)] = sm[0]; }
 }
 
-// for n = groups * items:
-// dot(x, y, r) does not do summation and to complete operation
-// sum_xxx(r, s[n / 2]), sum_xxx(r, n / 4) ...
-// must be chained after initial dot()
-// _xxx must be _odd or _even depending on oddness of "n" not "n / 2"
-
-__kernel void name(dot, suffix)(fp_ro_t const v0, fp_ro_t const v1, fp_wr_t r) {
-    const int32_t i = get_global_id(0); // (0) of dimension zero out of 3
-    r[i] = v0[i] * v1[i];
+__kernel void name(dot_reduce, suffix)(
+        fp_ro_t const v0, const int64_t offset0, const int64_t stride0,
+        fp_ro_t const v1, const int64_t offset1, const int64_t stride1,
+        const int64_t n, accu_wr_t r, const int64_t offset_r,
+        __local accu_t* sm) {
+    accu_t s = 0;
+    for (int64_t i = get_global_id(0); i < n; i += get_global_size(0)) {
+        s += (accu_t)v0[offset0 + i * stride0] *
+             (accu_t)v1[offset1 + i * stride1];
+    }
+    name(reduce, suffix)(s, sm, r + offset_r);
 }
 
-__kernel void name(dot_os, suffix)(
-        fp_ro_t const v0, const int32_t offset0, const int32_t stride0,
-        fp_ro_t const v1, const int32_t offset1, const int32_t stride1,
-        fp_wr_t r) {
-    const int32_t i = get_global_id(0);
-    r[i] = v0[offset0 + i * stride0] * v1[offset1 + i * stride1];
+__kernel void name(sum_reduce, suffix)(__global const accu_t* v,
+        const int32_t n, accu_wr_t r, const int64_t offset_r,
+        __local accu_t* sm) {
+    accu_t s = 0;
+    for (int32_t i = get_global_id(0); i < n; i += get_global_size(0)) {
+        s += v[i];
+    }
+    name(reduce, suffix)(s, sm, r + offset_r);
 }
 
 // TODO: dot16_fp16(), dot4_fp32(), dot4_fp4() future optimization
@@ -192,6 +186,81 @@ __kernel void name(gemv_os, suffix)(
     r[i] = s;
 }
 
+// gemm General Matrix Multiplication c[m][n] = a[m][k] * b[k][n]
+// (all row major). Each work group computes TSM x TSN tile of "c" and
+// each work item WPTM x WPTN elements of it in registers (register
+// blocking). Tiles of "a" and "b" TSK deep are staged in local memory
+// so every element loaded from global memory is reused TSN (TSM) times.
+// Host must enqueue 2D range of (m + TSM - 1) / TSM * RTSM by
+// (n + TSN - 1) / TSN * RTSN work items in groups of RTSM x RTSN.
+// fp16_t is accumulated in fp32_t.
+
+#define TSM  64 // tile rows
+#define TSN  64 // tile columns
+#define TSK  16 // tile depth
+#define WPTM  4 // work per thread (rows)
+#define WPTN  4 // work per thread (columns)
+#define RTSM (TSM / WPTM) // work group dimension 0
+#define RTSN (TSN / WPTN) // work group dimension 1
+
+__kernel
+__attribute__((reqd_work_group_size(RTSM, RTSN, 1)))
+void name(gemm, suffix)(
+        fp_ro_t a, const int64_t offset_a,
+        fp_ro_t b, const int64_t offset_b,
+        fp_wr_t c, const int64_t offset_c,
+        const int64_t m, const int64_t n, const int64_t k) {
+    __local fp_t ta[TSK][TSM];
+    __local fp_t tb[TSK][TSN];
+    const int32_t tr = get_local_id(0);
+    const int32_t tc = get_local_id(1);
+    const int32_t lid = tc * RTSM + tr;
+    // matrices may have more than 2^31 elements: 64-bit indices
+    const int64_t row = (int64_t)get_group_id(0) * TSM;
+    const int64_t col = (int64_t)get_group_id(1) * TSN;
+    a += offset_a;
+    b += offset_b;
+    c += offset_c;
+    accu_t acc[WPTM][WPTN];
+    for (int32_t wm = 0; wm < WPTM; wm++) {
+        for (int32_t wn = 0; wn < WPTN; wn++) { acc[wm][wn] = 0; }
+    }
+    for (int64_t t = 0; t < k; t += TSK) {
+        // consecutive work items load consecutive addresses (coalesced),
+        // outside of the matrices tiles are padded with zeros:
+        for (int32_t l = lid; l < TSK * TSM; l += RTSM * RTSN) {
+            const int64_t y = row + l / TSK;
+            const int64_t x = t + l % TSK;
+            ta[l % TSK][l / TSK] = y < m && x < k ? a[y * k + x] : 0;
+        }
+        for (int32_t l = lid; l < TSK * TSN; l += RTSM * RTSN) {
+            const int64_t y = t + l / TSN;
+            const int64_t x = col + l % TSN;
+            tb[l / TSN][l % TSN] = y < k && x < n ? b[y * n + x] : 0;
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (int32_t kk = 0; kk < TSK; kk++) {
+            accu_t ra[WPTM];
+            accu_t rb[WPTN];
+            for (int32_t wm = 0; wm < WPTM; wm++) { ra[wm] = ta[kk][tr + wm * RTSM]; }
+            for (int32_t wn = 0; wn < WPTN; wn++) { rb[wn] = tb[kk][tc + wn * RTSN]; }
+            for (int32_t wm = 0; wm < WPTM; wm++) {
+                for (int32_t wn = 0; wn < WPTN; wn++) {
+                    acc[wm][wn] += ra[wm] * rb[wn];
+                }
+            }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    for (int32_t wm = 0; wm < WPTM; wm++) {
+        const int64_t y = row + tr + wm * RTSM;
+        for (int32_t wn = 0; wn < WPTN; wn++) {
+            const int64_t x = col + tc + wn * RTSN;
+            if (y < m && x < n) { c[y * n + x] = (fp_t)acc[wm][wn]; }
+        }
+    }
+}
+
 #if defined(fp16_t) && defined(fp16_surrogate)
 
 #define fp16ro_t __global const fp16_t*
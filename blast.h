@@ -17,6 +17,13 @@ typedef struct blast_memory_s { // treat as read only, will change don't cache
 
 typedef struct blast_s {
     ocl_context_t* c;
+    // temporaries (e.g. dot() partial sums) are recycled via pool,
+    // pool.capacity may be changed after init, pool.hits/misses counters:
+    ocl_pool_t pool;
+    // dot_async() partial sums are held until their sum_reduce() event
+    // completes and only then returned to the pool:
+    struct { ocl_memory_t m; ocl_event_t e; } held[ocl_pool_slots];
+    int32_t holding;
     // BLAS like operations
     // The offset parameters could be useful when multiple tensors reside in
     // a single memory region.
@@ -25,20 +32,42 @@ typedef struct blast_s {
     fp64_t (*dot[3])(
         blast_memory_t* v0, int64_t offset0, int64_t stride0,
         blast_memory_t* v1, int64_t offset1, int64_t stride1, int64_t n);
+    // Non-blocking variants start after wait[waits] events (0, null - no
+    // dependencies) and return event of completion that caller must
+    // release. dot_async() result lands in r[offset_r] on the device as
+    // accu_t (fp32_t for fp16, otherwise same as vectors elements),
+    // blast.dot_result() waits and reads it back:
+    ocl_event_t (*dot_async[3])(
+        blast_memory_t* v0, int64_t offset0, int64_t stride0,
+        blast_memory_t* v1, int64_t offset1, int64_t stride1, int64_t n,
+        blast_memory_t* r, int64_t offset_r,
+        int waits, const ocl_event_t wait[]);
     // gemv()
     void (*gemv[3])(
         blast_memory_t* matrix/*[m][n]*/, int64_t offset_m, int64_t stride_m,
         blast_memory_t* vector/*[n]*/,    int64_t offset_v, int64_t stride_v,
         blast_memory_t* result/*[m]*/, int64_t m, int64_t n);
+    // gemm() c[m][n] = a[m][k] * b[k][n] row major, offsets in elements.
+    // gemm[fpp] and gemm_async[fpp] are also null when the device cannot
+    // run the 16 x 16 work group the local memory tiled kernel requires:
+    void (*gemm[3])(
+        blast_memory_t* a/*[m][k]*/, int64_t offset_a,
+        blast_memory_t* b/*[k][n]*/, int64_t offset_b,
+        blast_memory_t* c/*[m][n]*/, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k);
+    ocl_event_t (*gemm_async[3])(
+        blast_memory_t* a/*[m][k]*/, int64_t offset_a,
+        blast_memory_t* b/*[k][n]*/, int64_t offset_b,
+        blast_memory_t* c/*[m][n]*/, int64_t offset_c,
+        int64_t m, int64_t n, int64_t k,
+        int waits, const ocl_event_t wait[]);
     // kernels are properties of c.c ocl_context:
-    ocl_kernel_t dot_c[3];   // compact
-    ocl_kernel_t dot_os[3];  // offset + stride
-    ocl_kernel_t sum_odd[3];
-    ocl_kernel_t sum_odd_os[3];
-    ocl_kernel_t sum_even[3];
-    ocl_kernel_t sum_even_os[3];
+    ocl_kernel_t dot_reduce[3]; // partial sum of products per work group
+    ocl_kernel_t sum_reduce[3]; // sum of partials in single work group
+    int64_t reduce_items[3];    // power of 2 work group size for *_reduce
     ocl_kernel_t gemv_c[3];
     ocl_kernel_t gemv_os[3];
+    ocl_kernel_t gemm_c[3];  // local memory tiled
     // TODO:
     // TODO:
     ocl_kernel_t copy[3]; // for performance measurements
@@ -58,6 +87,10 @@ typedef struct blast_if {
     // and unmap before invocation of any other blast operation
     void* (*map)(blast_memory_t* gm, int access, int64_t offset, int64_t bytes);
     void  (*unmap)(blast_memory_t* gm);
+    // waits for done (if not null) and reads dot_async() result r[offset]
+    // (r must be unmapped and allocated with host read access):
+    fp64_t (*dot_result)(blast_memory_t* r, int64_t offset, int fpp,
+        ocl_event_t done);
     void (*fini)(blast_t* b);
 } blast_if;
 
@@ -93,7 +126,7 @@ extern blast_if blast;
         sbmv
 
     Level 3 BLAS (4 subprograms)
-        gemm
+    [x] gemm
         symm
         hemm
         syrk
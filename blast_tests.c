@@ -47,6 +47,24 @@ static void test_dot_free(test_dot_t* td) {
     blast.deallocate(&td->v1);
 }
 
+static void test_set(int fpp, void* p, int64_t i, fp64_t v) { // fp_t p[i] = v
+    switch (fpp) {
+        case ocl_fpp16: ((fp16_t*)p)[i] = fp32to16((fp32_t)v); break;
+        case ocl_fpp32: ((fp32_t*)p)[i] = (fp32_t)v; break;
+        case ocl_fpp64: ((fp64_t*)p)[i] = v; break;
+        default: fatal_if("fpp", "%d", fpp);
+    }
+}
+
+static fp64_t test_get(int fpp, const void* p, int64_t i) { // fp_t p[i]
+    switch (fpp) {
+        case ocl_fpp16: return fp16to32(((const fp16_t*)p)[i]);
+        case ocl_fpp32: return ((const fp32_t*)p)[i];
+        case ocl_fpp64: return ((const fp64_t*)p)[i];
+        default: fatal_if("fpp", "%d", fpp); return 0;
+    }
+}
+
 static void test_first_n(blast_t* b, int64_t n, int fpp,
         int64_t o0, int64_t s0, int64_t o1, int64_t s1, bool verbose) {
     assert(1 <= n && n <= 16);
@@ -159,6 +177,121 @@ static void test_performance(blast_t* b, const int32_t n) {
     assert(fabs(res - sum) <= FLT_EPSILON, "res: %.7e != %.7e\n", res, sum);
 }
 
+static fp64_t test_gemm(blast_t* b, int fpp, int64_t m, int64_t n, int64_t k,
+        int64_t o) {
+    // c[m][n] = a[m][k] * b[k][n] vs fp64 reference; returns max error
+    enum { write_only = CL_MEM_WRITE_ONLY|CL_MEM_HOST_WRITE_ONLY };
+    enum { read_only  = CL_MEM_READ_ONLY|CL_MEM_HOST_READ_ONLY };
+    const int64_t bytes = sizes[fpp];
+    blast_memory_t ma = blast.allocate(b, write_only, (o + m * k) * bytes);
+    blast_memory_t mb = blast.allocate(b, write_only, (o + k * n) * bytes);
+    blast_memory_t mc = blast.allocate(b, read_only,  (o + m * n) * bytes);
+    fp64_t* ra = (fp64_t*)malloc(m * k * sizeof(fp64_t));
+    fp64_t* rb = (fp64_t*)malloc(k * n * sizeof(fp64_t));
+    fatal_if(ra == null || rb == null);
+    // small integers are exact in fp16_t and products sums are exact too
+    for (int64_t i = 0; i < m * k; i++) { ra[i] = (fp64_t)(random32(&seed) % 5) - 2; }
+    for (int64_t i = 0; i < k * n; i++) { rb[i] = (fp64_t)(random32(&seed) % 5) - 2; }
+    void* pa = blast.map(&ma, CL_MAP_WRITE_INVALIDATE_REGION, 0, (o + m * k) * bytes);
+    void* pb = blast.map(&mb, CL_MAP_WRITE_INVALIDATE_REGION, 0, (o + k * n) * bytes);
+    for (int64_t i = 0; i < m * k; i++) { test_set(fpp, pa, o + i, ra[i]); }
+    for (int64_t i = 0; i < k * n; i++) { test_set(fpp, pb, o + i, rb[i]); }
+    blast.unmap(&mb);
+    blast.unmap(&ma);
+    b->gemm[fpp](&ma, o, &mb, o, &mc, o, m, n, k);
+    const void* pc = blast.map(&mc, CL_MAP_READ, 0, (o + m * n) * bytes);
+    fp64_t error = 0;
+    for (int64_t y = 0; y < m; y++) {
+        for (int64_t x = 0; x < n; x++) {
+            fp64_t s = 0;
+            for (int64_t i = 0; i < k; i++) { s += ra[y * k + i] * rb[i * n + x]; }
+            const fp64_t r = test_get(fpp, pc, o + y * n + x);
+            error = max(error, fabs(r - s));
+        }
+    }
+    blast.unmap(&mc);
+    free(rb);
+    free(ra);
+    blast.deallocate(&mc);
+    blast.deallocate(&mb);
+    blast.deallocate(&ma);
+    return error;
+}
+
+static void test_gemm_permutations(blast_t* b) {
+    static const int64_t dims[] = { 1, 3, 16, 63, 64, 65, 130 };
+    for (int fpp = ocl_fpp16; fpp <= ocl_fpp64; fpp++) {
+        if (b->gemm[fpp] != null) {
+            for (int i = 0; i < countof(dims); i++) {
+                for (int j = 0; j < countof(dims); j++) {
+                    for (int l = 0; l < countof(dims); l++) {
+                        // fp16_t results must be exact up to 2048
+                        fp64_t e = test_gemm(b, fpp, dims[i], dims[j], dims[l],
+                            (i + j + l) % 3);
+                        fatal_if(e != 0, "%s %lld x %lld x %lld error: %g",
+                            ocl_fpp_names[fpp], dims[i], dims[j], dims[l], e);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void test_pool(blast_t* b) {
+    // dot() temporaries are recycled after the first call:
+    int64_t hits = b->pool.hits;
+    int64_t misses = b->pool.misses;
+    for (int i = 0; i < 16; i++) {
+        test_first_n(b, 16, ocl_fpp32, 0, 1, 0, 1, false);
+    }
+    fatal_if(b->pool.misses - misses > 1 || b->pool.hits - hits < 15,
+        "hits: %lld misses: %lld", b->pool.hits - hits, b->pool.misses - misses);
+    // capacity 0 disables recycling:
+    const int64_t capacity = b->pool.capacity;
+    b->pool.capacity = 0;
+    ocl.pool_fini(&b->pool);
+    hits = b->pool.hits;
+    test_first_n(b, 16, ocl_fpp32, 0, 1, 0, 1, false);
+    test_first_n(b, 16, ocl_fpp32, 0, 1, 0, 1, false);
+    fatal_if(b->pool.hits != hits || b->pool.count != 0);
+    b->pool.capacity = capacity;
+}
+
+static void test_dot_async(blast_t* b, int fpp) {
+    // queue dot products of growing length without blocking, each one
+    // after previous, results land in r[] and are read back at the end:
+    enum { n = 64 * 1024, count = 8 };
+    test_dot_t td = test_dot_alloc(b, fpp, n, n);
+    test_dot_map(&td);
+    for (int64_t i = 0; i < n; i++) {
+        test_set(fpp, td.a0, i, (fp64_t)(i % 3));
+        test_set(fpp, td.a1, i, (fp64_t)(i % 5));
+    }
+    test_dot_unmap(&td);
+    enum { host_read = CL_MEM_READ_WRITE|CL_MEM_HOST_READ_ONLY };
+    blast_memory_t r = blast.allocate(b, host_read, count * sizeof(fp64_t));
+    ocl_event_t e = null;
+    for (int i = 0; i < count; i++) {
+        const int64_t k = n / count * (i + 1);
+        ocl_event_t next = b->dot_async[fpp](&td.v0, 0, 1, &td.v1, 0, 1, k,
+            &r, i, e != null ? 1 : 0, e != null ? &e : null);
+        if (e != null) { ocl.release_event(e); }
+        e = next;
+    }
+    ocl.wait(&e, 1);
+    ocl.release_event(e);
+    for (int i = 0; i < count; i++) {
+        const int64_t k = n / count * (i + 1);
+        fp64_t expected = 0;
+        for (int64_t j = 0; j < k; j++) { expected += (j % 3) * (j % 5); }
+        const fp64_t s = blast.dot_result(&r, i, fpp, null);
+        fatal_if(s != expected, "%s dot_async[%d] %.17g expected: %.17g",
+            ocl_fpp_names[fpp], i, s, expected);
+    }
+    blast.deallocate(&r);
+    test_dot_free(&td);
+}
+
 static void test_dot_compare_gpu_avx(blast_t* b,
         const ocl_profiling_t* p) {
     enum { n = 16 * 1024 * 1024 };
@@ -201,6 +334,11 @@ static void tests() {
         blast_t b = { 0 };
         blast.init(&b, &c);
         test_permutations(&b);
+        if (b.dot[ocl_fpp32] != null) { test_pool(&b); }
+        for (int fpp = ocl_fpp16; fpp <= ocl_fpp64; fpp++) {
+            if (b.dot_async[fpp] != null) { test_dot_async(&b, fpp); }
+        }
+        test_gemm_permutations(&b);
         blast.fini(&b);
         ocl.close(&c);
     }
@@ -221,6 +359,15 @@ static void tests() {
         test_performance(&b, n);
         println("dot_fp32 x %d: %7.3f user: %7.3f (ms) GFlops: %7.3f", n,
             p[0].time * MSEC_IN_SEC, p[0].user * MSEC_IN_SEC, p[0].gflops);
+        for (int fpp = ocl_fpp16; fpp <= ocl_fpp64; fpp++) {
+            if (b.gemm[fpp] != null) {
+                enum { k = 1024 };
+                test_gemm(&b, fpp, k, k, k, 0);
+                println("gemm_%s %dx%dx%d: %7.3f (ms) GFlops: %7.3f",
+                    ocl_fpp_names[fpp], k, k, k, p[0].time * MSEC_IN_SEC,
+                    p[0].gflops);
+            }
+        }
         blast.fini(&b);
         ocl.close(&c);
     }
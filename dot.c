@@ -5,12 +5,43 @@
 #include <immintrin.h>
 #include "dot.h"
 
-// prefetch2_L1L2L3 - reportedly on 11th gen Intel processors it is 64 bytes (512 bits)
-#define prefetch2_L1L2L3(v0, v1) do {             \
-    _mm_prefetch((const char*)(v0), _MM_HINT_T0); \
-    _mm_prefetch((const char*)(v1), _MM_HINT_T0); \
+// dot_prefetch2 - streaming kernels prefetch pf.lines cache lines ahead
+// of v0 and v1 with pf.hint (dot_prefetch_t0...) see dot_prefetch_of()
+// one prefetch per cache line of the n elements the iteration consumed
+// keeps the distance pf.lines. dot_prefetch2n() is for quantized kernels
+// consuming n0 and n1 elements of different size (fp32 x q4 blocks) and
+// less than a cache line per iteration (34 bytes q8_t: a line may be
+// prefetched twice but none is skipped).
+// _mm_prefetch() hint must be an immediate thus the switch:
+#define dot_prefetch1(hint, p) do {                                           \
+    switch (hint) {                                                          \
+        case dot_prefetch_t1:  _mm_prefetch((p), _MM_HINT_T1);  break;       \
+        case dot_prefetch_t2:  _mm_prefetch((p), _MM_HINT_T2);  break;       \
+        case dot_prefetch_nta: _mm_prefetch((p), _MM_HINT_NTA); break;       \
+        default:               _mm_prefetch((p), _MM_HINT_T0);  break;       \
+    }                                                                        \
 } while (0)
 
+#define dot_prefetch2n(pf, v0, n0, v1, n1) do {                              \
+    if ((pf).lines > 0) {                                                    \
+        const int64_t ahead = (pf).lines * dot_cache_line;                   \
+        const char* p0 = (const char*)(v0) + ahead;                          \
+        const char* p1 = (const char*)(v1) + ahead;                          \
+        const char* e0 = p0 + (n0) * (int64_t)sizeof(*(v0));                 \
+        const char* e1 = p1 + (n1) * (int64_t)sizeof(*(v1));                 \
+        while (p0 < e0) {                                                    \
+            dot_prefetch1((pf).hint, p0); p0 += dot_cache_line;              \
+        }                                                                    \
+        while (p1 < e1) {                                                    \
+            dot_prefetch1((pf).hint, p1); p1 += dot_cache_line;              \
+        }                                                                    \
+    }                                                                        \
+} while (0)
+
+#define dot_prefetch2(pf, v0, v1, n) dot_prefetch2n(pf, v0, n, v1, n)
+
+enum { dot_cache_line = 64 };
+
 // AVX2 / AVX512 optimized dot product functions:
 
 enum { // bit order differs from cpuid registers bits
@@ -21,7 +52,9 @@ enum { // bit order differs from cpuid registers bits
     avx512_bf16      = 1U << 4,  // BFloat16 Instructions
     avx512_fp16      = 1U << 5,  // FP16 (Half-Precision) Instructions
     avx512_vl        = 1U << 6,  // Vector Length Extensions
-    avx512_vnni      = 1U << 7   // Vector Neural Network Instructions
+    avx512_vnni      = 1U << 7,  // Vector Neural Network Instructions
+    avx_vnni         = 1U << 8,  // VEX encoded VNNI (Alder Lake and later)
+    avx512_bw        = 1U << 9   // Byte and Word Instructions
 };
 
 // (*) avx_fp16c AVX FP16 conversion instructions introduced on the
@@ -40,6 +73,26 @@ typedef struct avx2_if {
     fp64_t (*dot32x16bf)(const fp32_t* restrict v0, const bf16_t* restrict v1, int64_t n);
     fp64_t (*dot32)(const fp32_t* restrict v0, const fp32_t* restrict v1, int64_t n);
     fp64_t (*dot64)(const fp64_t* restrict v0, const fp64_t* restrict v1, int64_t n);
+    // strided v0[i * s0] . v1[i * s1] using gathers:
+    fp64_t (*dot16_s)(const fp16_t* restrict v0, int64_t s0, const fp16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32x16_s)(const fp32_t* restrict v0, int64_t s0, const fp16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot16bf_s)(const bf16_t* restrict v0, int64_t s0, const bf16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32x16bf_s)(const fp32_t* restrict v0, int64_t s0, const bf16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32_s)(const fp32_t* restrict v0, int64_t s0, const fp32_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot64_s)(const fp64_t* restrict v0, int64_t s0, const fp64_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32_compensated)(const fp32_t* restrict v0, const fp32_t* restrict v1, int64_t n);
+    fp64_t (*dotq8)(const q8_t* restrict v0, const q8_t* restrict v1, int64_t blocks);
+    void   (*quantize_q8)(const fp32_t* restrict v, q8_t* restrict q, int64_t blocks);
+    // Q4 row q[blocks] times fp32 or Q8 vector v[blocks * q4_block]:
+    fp64_t (*dot32xq4)(const fp32_t* restrict v, const q4_t* restrict q, int64_t blocks);
+    fp64_t (*dot32xq4m)(const fp32_t* restrict v, const q4m_t* restrict q, int64_t blocks);
+    fp64_t (*dotq8xq4)(const q8_t* restrict v, const q4_t* restrict q, int64_t blocks);
+    fp64_t (*dotq8xq4m)(const q8_t* restrict v, const q4m_t* restrict q, int64_t blocks);
+    // 4 rows mx[0..3][n] (stride elements apart) times the same vector v[n]:
+    void (*dot32x16_x4)(const fp32_t* restrict v, const fp16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs);
+    void (*dot32x16bf_x4)(const fp32_t* restrict v, const bf16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs);
 } avx2_if;
 
 typedef struct avx512_if {
@@ -50,6 +103,23 @@ typedef struct avx512_if {
     fp64_t (*dot32x16bf)(const fp32_t* restrict v0, const bf16_t* restrict v1, int64_t n);
     fp64_t (*dot32)(const fp32_t* restrict v0, const fp32_t* restrict v1, int64_t n);
     fp64_t (*dot64)(const fp64_t* restrict v0, const fp64_t* restrict v1, int64_t n);
+    // fp16 accumulation (AVX512_FP16), only used by dot.fp16_native():
+    fp64_t (*dot16_native)(const fp16_t* restrict v0, const fp16_t* restrict v1, int64_t n);
+    // strided v0[i * s0] . v1[i * s1] using gathers:
+    fp64_t (*dot16_s)(const fp16_t* restrict v0, int64_t s0, const fp16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32x16_s)(const fp32_t* restrict v0, int64_t s0, const fp16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot16bf_s)(const bf16_t* restrict v0, int64_t s0, const bf16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32x16bf_s)(const fp32_t* restrict v0, int64_t s0, const bf16_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32_s)(const fp32_t* restrict v0, int64_t s0, const fp32_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot64_s)(const fp64_t* restrict v0, int64_t s0, const fp64_t* restrict v1, int64_t s1, int64_t n);
+    fp64_t (*dot32_compensated)(const fp32_t* restrict v0, const fp32_t* restrict v1, int64_t n);
+    fp64_t (*dotq8)(const q8_t* restrict v0, const q8_t* restrict v1, int64_t blocks);
+    fp64_t (*dot32xq4)(const fp32_t* restrict v, const q4_t* restrict q, int64_t blocks);
+    fp64_t (*dot32xq4m)(const fp32_t* restrict v, const q4m_t* restrict q, int64_t blocks);
+    void (*dot32x16_x4)(const fp32_t* restrict v, const fp16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs);
+    void (*dot32x16bf_x4)(const fp32_t* restrict v, const bf16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs);
 } avx512_if;
 
 // _MM_HINT_T0 (temporal data)  prefetch data into all levels of the caches.
@@ -66,11 +136,109 @@ typedef struct avx512_if {
 static void avx_init(void);
 static void avx2_init(void);
 static void avx512_init(void);
+static void dot_calibrate(void);
 
 static avx_if    avx    = { .init = avx_init };
 static avx2_if   avx2   = { .init = avx2_init };
 static avx512_if avx512 = { .init = avx512_init };
 
+// DOT_FP16_LUT: C code paths (AVX kernels tails, strided dot products and
+// Q8/Q4 scales) convert fp16 to fp32 by looking up 256KB table built in
+// dot_init() instead of bit manipulating branchy fp16to32()
+#ifndef DOT_FP16_LUT
+#define DOT_FP16_LUT 1
+#endif
+
+#if DOT_FP16_LUT
+static fp32_t dot_fp16_lut[64 * 1024];
+#define dot_fp16to32(v) (dot_fp16_lut[(v).bytes])
+#else
+#define dot_fp16to32(v) fp16to32(v)
+#endif
+
+// AVX512 is not always faster than AVX2 (see fp32 and fp64 RAM numbers for
+// 11th gen Intel at the end of this file). Dispatch uses the shipped
+// dot_calibration_default unless calibration is requested: then both
+// kernels of each element type are timed on L1, L2 and (cache flushed)
+// RAM sized vectors and dispatch picks the faster one.
+// DOT_CALIBRATION environment variable:
+//   not set, "off" or "0" - shipped defaults, no measurements
+//   "on" or "1"           - calibrate in dot_init() (4MB, ~0.25 seconds)
+//   file name             - read calibration from the file, if the file is
+//                           missing or was written on a different CPU
+//                           calibrate and save it
+
+enum { dot_fp16, dot_fp32x16, dot_bf16, dot_bf32x16, dot_fp32, dot_fp64,
+       dot_types };
+
+enum { dot_l1, dot_l2, dot_ram, dot_tiers };
+
+enum { dot_calibration_magic = 0x63746F64 }; // "dotc"
+
+typedef struct dot_calibration_s {
+    uint32_t magic;    // dot_calibration_magic
+    uint32_t features; // avx.features calibration was measured with
+    uint8_t  avx2[dot_types][dot_tiers]; // 1 if AVX2 is faster than AVX512
+} dot_calibration_t;
+
+// 11th gen Intel measurements: AVX2 streams fp32 and fp64 from RAM faster
+static const dot_calibration_t dot_calibration_default = {
+    .magic = dot_calibration_magic,
+    .avx2  = { [dot_fp32] = { [dot_ram] = 1 }, [dot_fp64] = { [dot_ram] = 1 } }
+};
+
+static dot_calibration_t dot_calibration;
+
+static inline int32_t dot_tier(int64_t bytes) { // v0 + v1
+    return bytes <= 16 * 1024 ? dot_l1 : (bytes <= 512 * 1024 ? dot_l2 : dot_ram);
+}
+
+static inline bool dot_prefer_avx2(int32_t type, int64_t bytes) {
+    return dot_calibration.avx2[type][dot_tier(bytes)] != 0;
+}
+
+// Software prefetch distance and hint per vectors size tier. Measured:
+// prefetch is a liability for L1 resident vectors (26 vs 22 GFlops on
+// 11th gen Intel) and for L2 (36 vs 33 GFlops on Sapphire Rapids) and
+// helps streaming from RAM only when it is issued far enough ahead
+// (fp32 AVX512: 1..2 lines 28 GFlops, none 30, 32 lines 31.5 GFlops).
+// See prefetch_test_performance() sweep.
+
+typedef struct dot_prefetch_s {
+    int32_t lines; // cache lines ahead, 0 - no prefetch
+    int32_t hint;  // dot_prefetch_t0, dot_prefetch_t1, ...
+} dot_prefetch_t;
+
+static dot_prefetch_t dot_prefetch_tiers[dot_tiers] = {
+    [dot_l1]  = { .lines =  0, .hint = dot_prefetch_t0 },
+    [dot_l2]  = { .lines =  0, .hint = dot_prefetch_t0 },
+    [dot_ram] = { .lines = 32, .hint = dot_prefetch_t0 },
+};
+
+static inline dot_prefetch_t dot_prefetch_of(int64_t bytes) {
+    return dot_prefetch_tiers[dot_tier(bytes)];
+}
+
+// Not synchronized: tiers are read without locks by every streaming kernel
+// and gemv thread, setters must not race with running dot/gemv calls.
+static void dot_set_prefetch(int64_t bytes, int32_t lines, int32_t hint) {
+    assert(0 <= lines && lines <= 1024);
+    assert(dot_prefetch_t0 <= hint && hint <= dot_prefetch_nta);
+    dot_prefetch_tiers[dot_tier(bytes)] = (dot_prefetch_t){ .lines = lines, .hint = hint };
+}
+
+// gemv: matrix rows stream from RAM even when a single row fits into L2
+// thus first cache lines of the next row are prefetched with dot_ram
+// tier settings while current row is computed:
+static inline void gemv_prefetch_row(const void* row, int64_t bytes) {
+    const dot_prefetch_t pf = dot_prefetch_tiers[dot_ram];
+    const int64_t lines = min(pf.lines, (bytes + dot_cache_line - 1) / dot_cache_line);
+    const char* p = (const char*)row;
+    for (int64_t i = 0; i < lines; i++) {
+        dot_prefetch1(pf.hint, p + i * dot_cache_line);
+    }
+}
+
 // <stdatomic.h> is still experimental in MSVC
 // static atomic_bool dot_initialized;
  static bool dot_initialized;
@@ -84,9 +252,15 @@ static void dot_init() {
 //  if (atomic_compare_exchange_strong(&initialize, &expected, true)) {
     if (!initialize) {
         initialize = true;
+        #if DOT_FP16_LUT
+            for (int32_t i = 0; i < countof(dot_fp16_lut); i++) {
+                dot_fp16_lut[i] = fp16to32(fp16x((uint16_t)i));
+            }
+        #endif
         avx.init();
         avx2.init();
         avx512.init();
+        dot_calibrate();
         dot_initialized = true;
 //      atomic_store(&dot_initialized, true);
     } else { // the least fortunate thread will have to spin:
@@ -98,7 +272,7 @@ static inline fp64_t cpu_dot16_c(const fp16_t* restrict v0,
         const fp16_t* restrict v1, int64_t n) {
     fp64_t sum = 0; // "_c" compact vector
     const fp16_t* e = v0 + n;
-    while (v0 < e) { sum += fp16to32(*v0++) * fp16to32(*v1++); }
+    while (v0 < e) { sum += dot_fp16to32(*v0++) * dot_fp16to32(*v1++); }
     return sum;
 }
 
@@ -106,7 +280,7 @@ static inline fp64_t cpu_dot32x16_c(const fp32_t* restrict v0,
         const fp16_t* restrict v1, int64_t n) {
     fp64_t sum = 0; // "_c" compact vector
     const fp32_t* e = v0 + n;
-    while (v0 < e) { sum += *v0++ * fp16to32(*v1++); }
+    while (v0 < e) { sum += *v0++ * dot_fp16to32(*v1++); }
     return sum;
 }
 
@@ -127,7 +301,7 @@ static fp64_t cpu_dot32x16bf_c(const fp32_t* v0, const bf16_t* v1, int64_t n) {
 }
 
 static fp64_t cpu_dot16bf_s(const bf16_t* v0, int64_t s0, const bf16_t* v1, int64_t s1, int64_t n) {
-    assert(s0 > 1 && s1 > 1);
+    assert(s0 >= 1 && s1 >= 1);
     fp64_t s = 0;
     for (int64_t i = 0; i < n; i++) {
         s += (fp64_t)bf16to32(*(v0 + i * s0)) * (fp64_t)bf16to32(*(v1 + i * s1));
@@ -136,7 +310,7 @@ static fp64_t cpu_dot16bf_s(const bf16_t* v0, int64_t s0, const bf16_t* v1, int6
 }
 
 static fp64_t cpu_dot32x16bf_s(const fp32_t* v0, int64_t s0, const bf16_t* v1, int64_t s1, int64_t n) {
-    assert(s0 > 1 && s1 > 1);
+    assert(s0 >= 1 && s1 >= 1);
     fp64_t s = 0;
     for (int64_t i = 0; i < n; i++) {
         s += (fp64_t)*(v0 + i * s0) * (fp64_t)bf16to32(*(v1 + i * s1));
@@ -147,14 +321,14 @@ static fp64_t cpu_dot32x16bf_s(const fp32_t* v0, int64_t s0, const bf16_t* v1, i
 static inline fp64_t cpu_dot16_s(const fp16_t* restrict v0, int64_t s0,
         const fp16_t* restrict v1, int64_t s1, int64_t n) {
     fp64_t sum = 0; // "_s" strided vector
-    while (n > 0) { sum += fp16to32(*v0) * fp16to32(*v1); v0 += s0; v1 += s1; n--; }
+    while (n > 0) { sum += dot_fp16to32(*v0) * dot_fp16to32(*v1); v0 += s0; v1 += s1; n--; }
     return sum;
 }
 
 static inline fp64_t cpu_dot32x16_s(const fp32_t* restrict v0, int64_t s0,
         const fp16_t* restrict v1, int64_t s1, int64_t n) {
     fp64_t sum = 0; // "_s" strided vector
-    while (n > 0) { sum += *v0 * fp16to32(*v1); v0 += s0; v1 += s1; n--; }
+    while (n > 0) { sum += *v0 * dot_fp16to32(*v1); v0 += s0; v1 += s1; n--; }
     return sum;
 }
 
@@ -166,6 +340,16 @@ static inline fp64_t cpu_dot32_c(const fp32_t* restrict v0, const fp32_t* restri
     return sum;
 }
 
+// fp32 products are exact in fp64 and their fp64 sum needs no compensation:
+#pragma float_control(precise, on, push) // dot.c is built with /fp:fast
+static fp64_t cpu_dot32_compensated(const fp32_t* restrict v0, int64_t s0,
+        const fp32_t* restrict v1, int64_t s1, int64_t n) {
+    fp64_t sum = 0;
+    for (int64_t i = 0; i < n; i++) { sum += (fp64_t)v0[i * s0] * v1[i * s1]; }
+    return sum;
+}
+#pragma float_control(pop)
+
 static inline fp64_t cpu_dot32_s(const fp32_t* restrict v0, int64_t s0,
         const fp32_t* restrict v1, int64_t s1, int64_t n) {
     fp64_t sum = 0;
@@ -188,9 +372,79 @@ static inline fp64_t cpu_dot64_s(const fp64_t* restrict v0, int64_t s0,
     return sum;
 }
 
+static fp64_t cpu_dotq8_c(const q8_t* restrict v0, const q8_t* restrict v1,
+        int64_t blocks) {
+    fp64_t sum = 0;
+    for (int64_t b = 0; b < blocks; b++) {
+        int32_t s = 0;
+        for (int i = 0; i < q8_block; i++) { s += v0[b].q[i] * v1[b].q[i]; }
+        sum += s * (fp64_t)dot_fp16to32(v0[b].scale) * dot_fp16to32(v1[b].scale);
+    }
+    return sum;
+}
+
+static void cpu_quantize_q8(const fp32_t* restrict v, q8_t* restrict q,
+        int64_t blocks) {
+    for (int64_t b = 0; b < blocks; b++) { fp32toq8(v + b * q8_block, q + b); }
+}
+
+static fp64_t cpu_dot32xq4_c(const fp32_t* restrict v, const q4_t* restrict q,
+        int64_t blocks) {
+    fp64_t sum = 0;
+    for (int64_t b = 0; b < blocks; b++) {
+        fp32_t s = 0;
+        for (int i = 0; i < q4_block; i++) { s += v[i] * (q4_nibble(q[b].q, i) - 8); }
+        sum += s * (fp64_t)dot_fp16to32(q[b].scale);
+        v += q4_block;
+    }
+    return sum;
+}
+
+static fp64_t cpu_dot32xq4m_c(const fp32_t* restrict v, const q4m_t* restrict q,
+        int64_t blocks) {
+    fp64_t sum = 0;
+    for (int64_t b = 0; b < blocks; b++) {
+        fp32_t s = 0;
+        fp32_t sv = 0; // sum(v) is multiplied by min
+        for (int i = 0; i < q4_block; i++) {
+            s += v[i] * q4_nibble(q[b].q, i);
+            sv += v[i];
+        }
+        sum += s * (fp64_t)dot_fp16to32(q[b].scale) + sv * (fp64_t)dot_fp16to32(q[b].min);
+        v += q4_block;
+    }
+    return sum;
+}
+
+static fp64_t cpu_dotq8xq4_c(const q8_t* restrict v, const q4_t* restrict q,
+        int64_t blocks) {
+    fp64_t sum = 0;
+    for (int64_t b = 0; b < blocks; b++) {
+        int32_t s = 0;
+        for (int i = 0; i < q4_block; i++) { s += v[b].q[i] * (q4_nibble(q[b].q, i) - 8); }
+        sum += s * (fp64_t)dot_fp16to32(v[b].scale) * dot_fp16to32(q[b].scale);
+    }
+    return sum;
+}
+
+static fp64_t cpu_dotq8xq4m_c(const q8_t* restrict v, const q4m_t* restrict q,
+        int64_t blocks) {
+    fp64_t sum = 0;
+    for (int64_t b = 0; b < blocks; b++) {
+        int32_t s = 0;
+        int32_t sv = 0;
+        for (int i = 0; i < q4_block; i++) {
+            s += v[b].q[i] * q4_nibble(q[b].q, i);
+            sv += v[b].q[i];
+        }
+        sum += dot_fp16to32(v[b].scale) * (s * (fp64_t)dot_fp16to32(q[b].scale) +
+                                           sv * (fp64_t)dot_fp16to32(q[b].min));
+    }
+    return sum;
+}
+
 static fp64_t dot16_c(const fp16_t *v0, const fp16_t* v1, int64_t n) {
-    prefetch2_L1L2L3(v0, v1);
-    if (n >= 16 && avx512.dot16 != null) {
+    if (n >= 16 && avx512.dot16 != null && !dot_prefer_avx2(dot_fp16, n * 4)) {
         return avx512.dot16(v0, v1, n);
     } else if (n >= 8 && avx2.dot16 != null) {
         return avx2.dot16(v0, v1, n);
@@ -200,8 +454,8 @@ static fp64_t dot16_c(const fp16_t *v0, const fp16_t* v1, int64_t n) {
 }
 
 static fp64_t dot32x16_c(const fp32_t *v0, const fp16_t* v1, int64_t n) {
-    prefetch2_L1L2L3(v0, v1);
-    if (n >= 16 && avx512.dot32x16 != null) {
+    if (n >= 16 && avx512.dot32x16 != null &&
+        !dot_prefer_avx2(dot_fp32x16, n * 6)) {
         return avx512.dot32x16(v0, v1, n);
     } else if (n >= 8 && avx2.dot32x16 != null) {
         return avx2.dot32x16(v0, v1, n);
@@ -211,7 +465,7 @@ static fp64_t dot32x16_c(const fp32_t *v0, const fp16_t* v1, int64_t n) {
 }
 
 static fp64_t dot16bf_c(const bf16_t* v0, const bf16_t* v1, int64_t n) {
-    if (n >= 8 && avx512.dot16bf != null) {
+    if (n >= 8 && avx512.dot16bf != null && !dot_prefer_avx2(dot_bf16, n * 4)) {
         return avx512.dot16bf(v0, v1, n);
     } else if (n >= 4 && avx2.dot16bf != null) {
         return avx2.dot16bf(v0, v1, n);
@@ -221,7 +475,8 @@ static fp64_t dot16bf_c(const bf16_t* v0, const bf16_t* v1, int64_t n) {
 }
 
 static fp64_t dot32x16bf_c(const fp32_t* v0, const bf16_t* v1, int64_t n) {
-    if (n >= 8 && avx512.dot32x16bf != null) {
+    if (n >= 8 && avx512.dot32x16bf != null &&
+        !dot_prefer_avx2(dot_bf32x16, n * 6)) {
         return avx512.dot32x16bf(v0, v1, n);
     } else if (n >= 4 && avx2.dot32x16bf != null) {
         return avx2.dot32x16bf(v0, v1, n);
@@ -231,8 +486,7 @@ static fp64_t dot32x16bf_c(const fp32_t* v0, const bf16_t* v1, int64_t n) {
 }
 
 static fp64_t dot32_c(const fp32_t *v0, const fp32_t* v1, int64_t n) {
-    prefetch2_L1L2L3(v0, v1);
-    if (n >= 16 && avx512.dot32 != null) {
+    if (n >= 16 && avx512.dot32 != null && !dot_prefer_avx2(dot_fp32, n * 8)) {
         return avx512.dot32(v0, v1, n);
     } else if (n >= 8 && avx2.dot32 != null) {
         return avx2.dot32(v0, v1, n);
@@ -242,8 +496,7 @@ static fp64_t dot32_c(const fp32_t *v0, const fp32_t* v1, int64_t n) {
 }
 
 static fp64_t dot64_c(const fp64_t *v0, const fp64_t* v1, int64_t n) {
-    prefetch2_L1L2L3(v0, v1);
-    if (n >= 8 && avx512.dot64 != null) {
+    if (n >= 8 && avx512.dot64 != null && !dot_prefer_avx2(dot_fp64, n * 16)) {
         return avx512.dot64(v0, v1, n);
     } else if (n >= 4 && avx2.dot64 != null) {
         return avx2.dot64(v0, v1, n);
@@ -252,11 +505,29 @@ static fp64_t dot64_c(const fp64_t *v0, const fp64_t* v1, int64_t n) {
     }
 }
 
+// gather indices [0..15] * stride must fit into int32_t:
+static inline bool dot_gather(int64_t s0, int64_t s1) {
+    return s0 <= INT32_MAX / 16 && s1 <= INT32_MAX / 16;
+}
+
+static fp64_t dot16_native(const fp16_t* v0, const fp16_t* v1, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    if (n >= 32 && avx512.dot16_native != null) {
+        return avx512.dot16_native(v0, v1, n);
+    } else {
+        return dot16_c(v0, v1, n);
+    }
+}
+
 static fp64_t dot16(const fp16_t* v0, int64_t s0, const fp16_t* v1, int64_t s1, int64_t n) {
     if (!dot_initialized) { dot_init(); }
     assert(s0 >= 1 && s1 >= 1);
     if (s0 == 1 && s1 == 1) {
         return dot16_c(v0, v1, n);
+    } else if (n > 16 && avx512.dot16_s != null && dot_gather(s0, s1)) {
+        return avx512.dot16_s(v0, s0, v1, s1, n);
+    } else if (n > 8 && avx2.dot16_s != null && dot_gather(s0, s1)) {
+        return avx2.dot16_s(v0, s0, v1, s1, n);
     } else {
         return cpu_dot16_s(v0, s0, v1, s1, n);
     }
@@ -268,6 +539,10 @@ static fp64_t dot16bf(const bf16_t* v0, int64_t s0, const bf16_t* v1, int64_t s1
     assert(s0 >= 1 && s1 >= 1);
     if (s0 == 1 && s1 == 1) {
         return dot16bf_c(v0, v1, n);
+    } else if (n > 16 && avx512.dot16bf_s != null && dot_gather(s0, s1)) {
+        return avx512.dot16bf_s(v0, s0, v1, s1, n);
+    } else if (n > 8 && avx2.dot16bf_s != null && dot_gather(s0, s1)) {
+        return avx2.dot16bf_s(v0, s0, v1, s1, n);
     } else {
         return cpu_dot16bf_s(v0, s0, v1, s1, n);
     }
@@ -278,6 +553,10 @@ static fp64_t dot32x16(const fp32_t* v0, int64_t s0, const fp16_t* v1, int64_t s
     assert(s0 >= 1 && s1 >= 1);
     if (s0 == 1 && s1 == 1) {
         return dot32x16_c(v0, v1, n);
+    } else if (n > 16 && avx512.dot32x16_s != null && dot_gather(s0, s1)) {
+        return avx512.dot32x16_s(v0, s0, v1, s1, n);
+    } else if (n > 8 && avx2.dot32x16_s != null && dot_gather(s0, s1)) {
+        return avx2.dot32x16_s(v0, s0, v1, s1, n);
     } else {
         return cpu_dot32x16_s(v0, s0, v1, s1, n);
     }
@@ -289,6 +568,10 @@ static fp64_t dot32x16bf(const fp32_t* v0, int64_t s0, const bf16_t* v1, int64_t
     assert(s0 >= 1 && s1 >= 1);
     if (s0 == 1 && s1 == 1) {
         return dot32x16bf_c(v0, v1, n);
+    } else if (n > 16 && avx512.dot32x16bf_s != null && dot_gather(s0, s1)) {
+        return avx512.dot32x16bf_s(v0, s0, v1, s1, n);
+    } else if (n > 8 && avx2.dot32x16bf_s != null && dot_gather(s0, s1)) {
+        return avx2.dot32x16bf_s(v0, s0, v1, s1, n);
     } else {
         return cpu_dot32x16bf_s(v0, s0, v1, s1, n);
     }
@@ -299,21 +582,557 @@ static fp64_t dot32(const fp32_t* v0, int64_t s0, const fp32_t* v1, int64_t s1,
     assert(s0 >= 1 && s1 >= 1);
     if (s0 == 1 && s1 == 1) {
         return dot32_c(v0, v1, n);
+    } else if (n > 16 && avx512.dot32_s != null && dot_gather(s0, s1)) {
+        return avx512.dot32_s(v0, s0, v1, s1, n);
+    } else if (n > 8 && avx2.dot32_s != null && dot_gather(s0, s1)) {
+        return avx2.dot32_s(v0, s0, v1, s1, n);
     } else {
         return cpu_dot32_s(v0, s0, v1, s1, n);
     }
 }
 
+static fp64_t dot32_compensated(const fp32_t* v0, int64_t s0,
+        const fp32_t* v1, int64_t s1, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    assert(s0 >= 1 && s1 >= 1);
+    if (s0 != 1 || s1 != 1) {
+        return cpu_dot32_compensated(v0, s0, v1, s1, n);
+    } else if (n >= 32 && avx512.dot32_compensated != null) {
+        return avx512.dot32_compensated(v0, v1, n);
+    } else if (n >= 16 && avx2.dot32_compensated != null) {
+        return avx2.dot32_compensated(v0, v1, n);
+    } else {
+        return cpu_dot32_compensated(v0, 1, v1, 1, n);
+    }
+}
+
 static fp64_t dot64(const fp64_t* v0, int64_t s0, const fp64_t* v1, int64_t s1, int64_t n) {
     if (!dot_initialized) { dot_init(); }
     assert(s0 >= 1 && s1 >= 1);
     if (s0 == 1 && s1 == 1) {
         return dot64_c(v0, v1, n);
+    } else if (n > 16 && avx512.dot64_s != null && dot_gather(s0, s1)) {
+        return avx512.dot64_s(v0, s0, v1, s1, n);
+    } else if (n > 8 && avx2.dot64_s != null && dot_gather(s0, s1)) {
+        return avx2.dot64_s(v0, s0, v1, s1, n);
     } else {
         return cpu_dot64_s(v0, s0, v1, s1, n);
     }
 }
 
+// Q8: n is number of elements and must be multiple of q8_block
+
+static fp64_t dotq8_c(const q8_t* v0, const q8_t* v1, int64_t blocks) {
+    if (blocks >= 2 && avx512.dotq8 != null) {
+        return avx512.dotq8(v0, v1, blocks);
+    } else if (avx2.dotq8 != null) {
+        return avx2.dotq8(v0, v1, blocks);
+    } else {
+        return cpu_dotq8_c(v0, v1, blocks);
+    }
+}
+
+static fp64_t dotq8(const q8_t* v0, const q8_t* v1, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    assert(n % q8_block == 0);
+    return dotq8_c(v0, v1, n / q8_block);
+}
+
+static void quantize_q8(const fp32_t* v, q8_t* q, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    assert(n % q8_block == 0);
+    if (avx2.quantize_q8 != null) {
+        avx2.quantize_q8(v, q, n / q8_block);
+    } else {
+        cpu_quantize_q8(v, q, n / q8_block);
+    }
+}
+
+// Q4: rows are q4_t/q4m_t, vector is fp32 or Q8. n is number of elements
+// and must be multiple of q4_block (== q8_block).
+
+static fp64_t dot32xq4_c(const fp32_t* v, const q4_t* q, int64_t blocks) {
+    if (avx512.dot32xq4 != null) {
+        return avx512.dot32xq4(v, q, blocks);
+    } else if (avx2.dot32xq4 != null) {
+        return avx2.dot32xq4(v, q, blocks);
+    } else {
+        return cpu_dot32xq4_c(v, q, blocks);
+    }
+}
+
+static fp64_t dot32xq4m_c(const fp32_t* v, const q4m_t* q, int64_t blocks) {
+    if (avx512.dot32xq4m != null) {
+        return avx512.dot32xq4m(v, q, blocks);
+    } else if (avx2.dot32xq4m != null) {
+        return avx2.dot32xq4m(v, q, blocks);
+    } else {
+        return cpu_dot32xq4m_c(v, q, blocks);
+    }
+}
+
+static fp64_t dotq8xq4_c(const q8_t* v, const q4_t* q, int64_t blocks) {
+    if (avx2.dotq8xq4 != null) {
+        return avx2.dotq8xq4(v, q, blocks);
+    } else {
+        return cpu_dotq8xq4_c(v, q, blocks);
+    }
+}
+
+static fp64_t dotq8xq4m_c(const q8_t* v, const q4m_t* q, int64_t blocks) {
+    if (avx2.dotq8xq4m != null) {
+        return avx2.dotq8xq4m(v, q, blocks);
+    } else {
+        return cpu_dotq8xq4m_c(v, q, blocks);
+    }
+}
+
+static fp64_t dot32xq4(const fp32_t* v, const q4_t* q, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    assert(n % q4_block == 0);
+    return dot32xq4_c(v, q, n / q4_block);
+}
+
+static fp64_t dot32xq4m(const fp32_t* v, const q4m_t* q, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    assert(n % q4_block == 0);
+    return dot32xq4m_c(v, q, n / q4_block);
+}
+
+static fp64_t dotq8xq4(const q8_t* v, const q4_t* q, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    assert(n % q4_block == 0);
+    return dotq8xq4_c(v, q, n / q4_block);
+}
+
+static fp64_t dotq8xq4m(const q8_t* v, const q4m_t* q, int64_t n) {
+    if (!dot_initialized) { dot_init(); }
+    assert(n % q4_block == 0);
+    return dotq8xq4m_c(v, q, n / q4_block);
+}
+
+// "many": one vector against many rows. Rows are processed 4 at a time so
+// each load (and conversion) of v[] is shared by 4 row accumulators.
+
+static void dot32x16_many(const fp32_t* v, const fp16_t* mx, int64_t stride,
+        fp32_t* rs, int64_t n, int64_t rows) {
+    if (!dot_initialized) { dot_init(); }
+    void (*x4)(const fp32_t* restrict v, const fp16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs) =
+        n >= 16 && avx512.dot32x16_x4 != null ? avx512.dot32x16_x4 :
+        n >=  8 && avx2.dot32x16_x4   != null ? avx2.dot32x16_x4 : null;
+    int64_t j = 0;
+    if (x4 != null) {
+        while (j + 4 <= rows) {
+            for (int64_t k = j + 4; k < j + 8 && k < rows; k++) {
+                gemv_prefetch_row(mx + k * stride, n * 2);
+            }
+            x4(v, mx + j * stride, stride, n, rs + j);
+            j += 4;
+        }
+    }
+    while (j < rows) { rs[j] = (fp32_t)dot32x16_c(v, mx + j * stride, n); j++; }
+}
+
+static void dot32x16bf_many(const fp32_t* v, const bf16_t* mx, int64_t stride,
+        fp32_t* rs, int64_t n, int64_t rows) {
+    if (!dot_initialized) { dot_init(); }
+    void (*x4)(const fp32_t* restrict v, const bf16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs) =
+        n >= 16 && avx512.dot32x16bf_x4 != null ? avx512.dot32x16bf_x4 :
+        n >=  8 && avx2.dot32x16bf_x4   != null ? avx2.dot32x16bf_x4 : null;
+    int64_t j = 0;
+    if (x4 != null) {
+        while (j + 4 <= rows) {
+            for (int64_t k = j + 4; k < j + 8 && k < rows; k++) {
+                gemv_prefetch_row(mx + k * stride, n * 2);
+            }
+            x4(v, mx + j * stride, stride, n, rs + j);
+            j += 4;
+        }
+    }
+    while (j < rows) { rs[j] = (fp32_t)dot32x16bf_c(v, mx + j * stride, n); j++; }
+}
+
+// gemv: rows of mx[m][n] are split into contiguous blocks, one block
+// per worker thread, so each core streams its own part of the matrix.
+
+typedef struct gemv_args_s {
+    const void* mx;
+    const void* vc;
+    void* rs;
+    int64_t n; // columns
+    int64_t m; // rows
+    int32_t blocks;
+    void (*rows)(struct gemv_args_s* a, int64_t j0, int64_t j1);
+} gemv_args_t;
+
+static void gemv_task(void* that, int32_t i) {
+    gemv_args_t* a = (gemv_args_t*)that;
+    // blocks start at multiples of 4 rows so that "many" kernels group
+    // rows the same way and results do not depend on number of threads:
+    const int64_t j0 = (a->m * i / a->blocks) & ~3LL;
+    const int64_t j1 = i == a->blocks - 1 ?
+        a->m : (a->m * (i + 1) / a->blocks) & ~3LL;
+    if (j0 < j1) { a->rows(a, j0, j1); }
+}
+
+// NUMA: dot.numa_alloc() places contiguous blocks of matrix rows on
+// consecutive nodes. gemv_run() recognizes such matrices and runs each
+// block of rows on worker threads bound to the node it is placed on, thus
+// no core reads the matrix across the interconnect. Output rows of the
+// nodes do not overlap and are written directly into rs[] (the vector is
+// small and is read from the caches of every node).
+
+enum { dot_numa_max_nodes = 64, dot_numa_max_matrices = 64 };
+
+typedef struct dot_numa_s {
+    void*   mx; // null for free slots
+    int64_t m;
+    int32_t nodes; // 0 when pages are interleaved across nodes
+    int64_t rows[dot_numa_max_nodes + 1]; // node k: [rows[k]..rows[k + 1] - 1]
+} dot_numa_t;
+
+// registry is guarded by dot_numa_mutex: matrices may be allocated and
+// freed on different threads while gemv_run() looks them up.
+static dot_numa_t dot_numa[dot_numa_max_matrices];
+static mutex_t dot_numa_mutex;
+
+// test only: > 0 splits matrices into this many nodes even on UMA systems
+// so that gemv_run_numa() is exercised (real node is k % numa_nodes()):
+static int32_t dot_numa_fake_nodes;
+
+static void* dot_numa_alloc(int64_t m, int64_t row_bytes, bool interleave) {
+    assert(m > 0 && row_bytes > 0);
+    const int64_t bytes = m * row_bytes;
+    const int32_t real  = numa_nodes();
+    const int32_t nodes = min(dot_numa_fake_nodes > 0 ? dot_numa_fake_nodes : real,
+                              (int32_t)dot_numa_max_nodes);
+    dot_numa_t* d = null;
+    mutex_lock(&dot_numa_mutex);
+    for (int32_t i = 0; i < countof(dot_numa) && d == null; i++) {
+        if (dot_numa[i].mx == null) { d = &dot_numa[i]; }
+    }
+    // reserve the slot before releasing the lock, see dot_numa_of():
+    if (d != null) { memset(d, 0, sizeof(*d)); d->mx = (void*)d; }
+    mutex_unlock(&dot_numa_mutex);
+    uint8_t* mx = d != null ? (uint8_t*)numa_reserve(bytes) : null;
+    if (mx != null) {
+        bool ok = true;
+        if (nodes <= 1) {
+            ok = numa_commit(mx, bytes, -1);
+        } else if (interleave) {
+            enum { chunk = 2 * 1024 * 1024 };
+            for (int64_t i = 0; ok && i < bytes; i += chunk) {
+                ok = numa_commit(mx + i, min(bytes - i, (int64_t)chunk),
+                                 (int32_t)(i / chunk % nodes % real));
+            }
+        } else {
+            // node blocks start at multiples of 4 rows (see gemv_task):
+            for (int32_t k = 0; k < nodes; k++) {
+                d->rows[k] = (m * k / nodes) & ~3LL;
+            }
+            d->rows[nodes] = m;
+            for (int32_t k = 0; ok && k < nodes; k++) {
+                const int64_t from = d->rows[k] * row_bytes;
+                const int64_t to   = d->rows[k + 1] * row_bytes;
+                if (from < to) { ok = numa_commit(mx + from, to - from, k % real); }
+            }
+            d->nodes = nodes;
+        }
+        if (!ok) {
+            numa_free(mx);
+            mx = null;
+        }
+    }
+    if (d != null) {
+        mutex_lock(&dot_numa_mutex);
+        if (mx != null) {
+            d->m  = m;
+            d->mx = mx;
+        } else {
+            memset(d, 0, sizeof(*d));
+        }
+        mutex_unlock(&dot_numa_mutex);
+    }
+    return mx;
+}
+
+static void dot_numa_free(void* mx) {
+    if (mx != null) {
+        dot_numa_t* d = null;
+        mutex_lock(&dot_numa_mutex);
+        for (int32_t i = 0; i < countof(dot_numa) && d == null; i++) {
+            if (dot_numa[i].mx == mx) { d = &dot_numa[i]; }
+        }
+        if (d != null) { memset(d, 0, sizeof(*d)); }
+        mutex_unlock(&dot_numa_mutex);
+        fatal_if(d == null, "%p was not allocated by dot.numa_alloc()", mx);
+        numa_free(mx);
+    }
+}
+
+// The returned entry stays valid while mx is in use by gemv: freeing a
+// matrix during gemv on it is a caller error.
+static const dot_numa_t* dot_numa_of(const void* mx, int64_t m) {
+    const dot_numa_t* d = null;
+    mutex_lock(&dot_numa_mutex);
+    for (int32_t i = 0; i < countof(dot_numa) && d == null; i++) {
+        if (dot_numa[i].mx == mx && dot_numa[i].m == m && dot_numa[i].nodes > 1) {
+            d = &dot_numa[i];
+        }
+    }
+    mutex_unlock(&dot_numa_mutex);
+    return d;
+}
+
+typedef struct gemv_numa_s {
+    gemv_args_t* a;
+    const dot_numa_t* numa;
+    int32_t real; // numa_nodes(), block k is placed on node k % real
+    int32_t task[dot_numa_max_nodes + 1]; // node k: [task[k]..task[k + 1] - 1]
+} gemv_numa_t;
+
+static void gemv_numa_task(void* that, int32_t i) {
+    gemv_numa_t* g = (gemv_numa_t*)that;
+    int32_t k = 0;
+    while (i >= g->task[k + 1]) { k++; }
+    const int32_t blocks = g->task[k + 1] - g->task[k];
+    const int32_t b = i - g->task[k];
+    const int64_t r0 = g->numa->rows[k]; // multiple of 4
+    const int64_t m  = g->numa->rows[k + 1] - r0;
+    const int64_t j0 = r0 + ((m * b / blocks) & ~3LL);
+    const int64_t j1 = b == blocks - 1 ?
+        r0 + m : r0 + ((m * (b + 1) / blocks) & ~3LL);
+    if (j0 < j1) {
+        numa_affinity_t previous = {0};
+        const bool bound = numa_bind(k % g->real, &previous);
+        g->a->rows(g->a, j0, j1);
+        if (bound) { numa_unbind(&previous); }
+    }
+}
+
+static void gemv_run_numa(gemv_args_t* a, const dot_numa_t* numa,
+        int64_t min_elements_per_block) {
+    gemv_numa_t g = { .a = a, .numa = numa, .real = numa_nodes() };
+    for (int32_t k = 0; k < numa->nodes; k++) {
+        int64_t blocks = (numa->rows[k + 1] - numa->rows[k]) * a->n /
+                          min_elements_per_block;
+        blocks = max(1, min(blocks, (int64_t)numa_cores(k % g.real)));
+        g.task[k + 1] = g.task[k] + (int32_t)blocks;
+    }
+    parallel(g.task[numa->nodes], gemv_numa_task, &g);
+}
+
+static void gemv_run(gemv_args_t* a) {
+    if (!dot_initialized) { dot_init(); }
+    // small matrices are not worth waking up the worker threads:
+    enum { min_elements_per_block = 64 * 1024 };
+    int64_t blocks = a->m * a->n / min_elements_per_block;
+    blocks = min(blocks, a->m);
+    blocks = min(blocks, (int64_t)cores());
+    const dot_numa_t* numa = blocks > 1 ? dot_numa_of(a->mx, a->m) : null;
+    if (blocks <= 1) {
+        a->rows(a, 0, a->m);
+    } else if (numa != null) {
+        gemv_run_numa(a, numa, min_elements_per_block);
+    } else {
+        a->blocks = (int32_t)blocks;
+        parallel(a->blocks, gemv_task, a);
+    }
+}
+
+static void gemv16_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const fp16_t* mx = (const fp16_t*)a->mx;
+    const fp16_t* vc = (const fp16_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * a->n, a->n * 2); }
+        rs[j] = (fp32_t)dot16_c(mx + j * a->n, vc, a->n);
+    }
+}
+
+static void gemv16bf_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const bf16_t* mx = (const bf16_t*)a->mx;
+    const bf16_t* vc = (const bf16_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * a->n, a->n * 2); }
+        rs[j] = (fp32_t)dot16bf_c(mx + j * a->n, vc, a->n);
+    }
+}
+
+static void gemv32x16_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const fp16_t* mx = (const fp16_t*)a->mx;
+    const fp32_t* vc = (const fp32_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    dot32x16_many(vc, mx + j0 * a->n, a->n, rs + j0, a->n, j1 - j0);
+}
+
+static void gemv32x16bf_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const bf16_t* mx = (const bf16_t*)a->mx;
+    const fp32_t* vc = (const fp32_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    dot32x16bf_many(vc, mx + j0 * a->n, a->n, rs + j0, a->n, j1 - j0);
+}
+
+static void gemv32_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const fp32_t* mx = (const fp32_t*)a->mx;
+    const fp32_t* vc = (const fp32_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * a->n, a->n * 4); }
+        rs[j] = (fp32_t)dot32_c(mx + j * a->n, vc, a->n);
+    }
+}
+
+static void gemv64_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const fp64_t* mx = (const fp64_t*)a->mx;
+    const fp64_t* vc = (const fp64_t*)a->vc;
+    fp64_t* rs = (fp64_t*)a->rs;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * a->n, a->n * 8); }
+        rs[j] = dot64_c(mx + j * a->n, vc, a->n);
+    }
+}
+
+static void gemvq8_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const q8_t* mx = (const q8_t*)a->mx;
+    const q8_t* vc = (const q8_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    const int64_t blocks = a->n / q8_block;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * blocks, blocks * sizeof(q8_t)); }
+        rs[j] = (fp32_t)dotq8_c(mx + j * blocks, vc, blocks);
+    }
+}
+
+static void gemv32xq4_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const q4_t* mx = (const q4_t*)a->mx;
+    const fp32_t* vc = (const fp32_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    const int64_t blocks = a->n / q4_block;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * blocks, blocks * sizeof(q4_t)); }
+        rs[j] = (fp32_t)dot32xq4_c(vc, mx + j * blocks, blocks);
+    }
+}
+
+static void gemv32xq4m_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const q4m_t* mx = (const q4m_t*)a->mx;
+    const fp32_t* vc = (const fp32_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    const int64_t blocks = a->n / q4_block;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * blocks, blocks * sizeof(q4m_t)); }
+        rs[j] = (fp32_t)dot32xq4m_c(vc, mx + j * blocks, blocks);
+    }
+}
+
+static void gemvq8xq4_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const q4_t* mx = (const q4_t*)a->mx;
+    const q8_t* vc = (const q8_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    const int64_t blocks = a->n / q4_block;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * blocks, blocks * sizeof(q4_t)); }
+        rs[j] = (fp32_t)dotq8xq4_c(vc, mx + j * blocks, blocks);
+    }
+}
+
+static void gemvq8xq4m_rows(gemv_args_t* a, int64_t j0, int64_t j1) {
+    const q4m_t* mx = (const q4m_t*)a->mx;
+    const q8_t* vc = (const q8_t*)a->vc;
+    fp32_t* rs = (fp32_t*)a->rs;
+    const int64_t blocks = a->n / q4_block;
+    for (int64_t j = j0; j < j1; j++) {
+        if (j + 1 < j1) { gemv_prefetch_row(mx + (j + 1) * blocks, blocks * sizeof(q4m_t)); }
+        rs[j] = (fp32_t)dotq8xq4m_c(vc, mx + j * blocks, blocks);
+    }
+}
+
+static void gemv16(const fp16_t* mx, const fp16_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv16_rows };
+    gemv_run(&a);
+}
+
+static void gemv16bf(const bf16_t* mx, const bf16_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv16bf_rows };
+    gemv_run(&a);
+}
+
+static void gemv32x16(const fp16_t* mx, const fp32_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv32x16_rows };
+    gemv_run(&a);
+}
+
+static void gemv32x16bf(const bf16_t* mx, const fp32_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv32x16bf_rows };
+    gemv_run(&a);
+}
+
+static void gemv32(const fp32_t* mx, const fp32_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv32_rows };
+    gemv_run(&a);
+}
+
+static void gemv64(const fp64_t* mx, const fp64_t* vc, fp64_t* rs,
+        int64_t n, int64_t m) {
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv64_rows };
+    gemv_run(&a);
+}
+
+static void gemvq8(const q8_t* mx, const q8_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    assert(n % q8_block == 0);
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemvq8_rows };
+    gemv_run(&a);
+}
+
+static void gemv32xq4(const q4_t* mx, const fp32_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    assert(n % q4_block == 0);
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv32xq4_rows };
+    gemv_run(&a);
+}
+
+static void gemv32xq4m(const q4m_t* mx, const fp32_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    assert(n % q4_block == 0);
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemv32xq4m_rows };
+    gemv_run(&a);
+}
+
+static void gemvq8xq4(const q4_t* mx, const q8_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    assert(n % q4_block == 0);
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemvq8xq4_rows };
+    gemv_run(&a);
+}
+
+static void gemvq8xq4m(const q4m_t* mx, const q8_t* vc, fp32_t* rs,
+        int64_t n, int64_t m) {
+    assert(n % q4_block == 0);
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = rs, .n = n, .m = m,
+                      .rows = gemvq8xq4m_rows };
+    gemv_run(&a);
+}
+
 // f64_t fp64_t
 #define f64x2_t __m128d
 #define f64x4_t __m256d
@@ -328,25 +1147,60 @@ static fp64_t dot64(const fp64_t* v0, int64_t s0, const fp64_t* v1, int64_t s1,
 #define f16x16_t __m256bh
 #define f16x32_t __m512bh
 
+// native half precision (AVX512_FP16) vector:
+#define h16x32_t __m512h
+
 static inline f32x8_t avx2_expand_bf16_to_fp32(__m128i v) {
     return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(v), 16));
 }
 
+static inline f32x8_t avx2_load_bf16(const bf16_t* p) { // 8 x bf16 -> fp32
+    return avx2_expand_bf16_to_fp32(_mm_lddqu_si128((void*)p));
+}
+
+static inline f32x8_t avx2_load_fp16(const fp16_t* p) { // 8 x fp16 -> fp32
+    return _mm256_cvtph_ps(_mm_lddqu_si128((void*)p));
+}
+
+static inline fp64_t avx2_reduce_add_ps(f32x8_t v) {
+    f32x4_t f32x4 = _mm_add_ps(
+        _mm256_castps256_ps128(v),       // 0,1,2,3
+        _mm256_extractf128_ps(v, 1));    // 4,5,6,7
+    return f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
+}
+
 static fp64_t avx2_dot16bf(const bf16_t* restrict v0, const bf16_t* restrict v1,
         int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 4);
     fp64_t sum = 0;
     if (n >= 8) {
-        f32x8_t mul_add_f32x8 = _mm256_setzero_ps();
+        // independent accumulators hide FMA latency:
+        f32x8_t mul_add0 = _mm256_setzero_ps();
+        f32x8_t mul_add1 = _mm256_setzero_ps();
+        f32x8_t mul_add2 = _mm256_setzero_ps();
+        f32x8_t mul_add3 = _mm256_setzero_ps();
+        while (n >= 32) {
+            mul_add0 = _mm256_fmadd_ps(avx2_load_bf16(v0),
+                avx2_load_bf16(v1), mul_add0);
+            mul_add1 = _mm256_fmadd_ps(avx2_load_bf16(v0 + 8),
+                avx2_load_bf16(v1 + 8), mul_add1);
+            mul_add2 = _mm256_fmadd_ps(avx2_load_bf16(v0 + 16),
+                avx2_load_bf16(v1 + 16), mul_add2);
+            mul_add3 = _mm256_fmadd_ps(avx2_load_bf16(v0 + 24),
+                avx2_load_bf16(v1 + 24), mul_add3);
+            n -= 32; v0 += 32; v1 += 32;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 32); }
+        }
         while (n >= 8) {
-            f32x8_t a = avx2_expand_bf16_to_fp32(_mm_lddqu_si128((void*)v0));
-            f32x8_t b = avx2_expand_bf16_to_fp32(_mm_lddqu_si128((void*)v1));
+            mul_add0 = _mm256_fmadd_ps(avx2_load_bf16(v0),
+                avx2_load_bf16(v1), mul_add0);
             n -= 8; v0 += 8; v1 += 8;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x8 = _mm256_fmadd_ps(a, b, mul_add_f32x8);
         }
+        f32x8_t mul_add = _mm256_add_ps(_mm256_add_ps(mul_add0, mul_add1),
+                                _mm256_add_ps(mul_add2, mul_add3));
         f32x4_t f32x4 = _mm_add_ps(
-            _mm256_extractf32x4_ps(mul_add_f32x8, 0),  // 0,1,2,3
-            _mm256_extractf32x4_ps(mul_add_f32x8, 1)); // 4,5,6,7
+            _mm256_extractf32x4_ps(mul_add, 0),  // 0,1,2,3
+            _mm256_extractf32x4_ps(mul_add, 1)); // 4,5,6,7
         sum = f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
     }
     if (n > 0) { sum += cpu_dot16bf_c(v0, v1, n); }
@@ -355,19 +1209,36 @@ static fp64_t avx2_dot16bf(const bf16_t* restrict v0, const bf16_t* restrict v1,
 
 static fp64_t avx2_dot32x16bf(const fp32_t* restrict v0, const bf16_t* restrict v1,
         int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 6);
     fp64_t sum = 0;
     if (n >= 8) {
-        f32x8_t mul_add_f32x8 = _mm256_setzero_ps();
+        // independent accumulators hide FMA latency:
+        f32x8_t mul_add0 = _mm256_setzero_ps();
+        f32x8_t mul_add1 = _mm256_setzero_ps();
+        f32x8_t mul_add2 = _mm256_setzero_ps();
+        f32x8_t mul_add3 = _mm256_setzero_ps();
+        while (n >= 32) {
+            mul_add0 = _mm256_fmadd_ps(_mm256_loadu_ps(v0),
+                avx2_load_bf16(v1), mul_add0);
+            mul_add1 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 8),
+                avx2_load_bf16(v1 + 8), mul_add1);
+            mul_add2 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 16),
+                avx2_load_bf16(v1 + 16), mul_add2);
+            mul_add3 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 24),
+                avx2_load_bf16(v1 + 24), mul_add3);
+            n -= 32; v0 += 32; v1 += 32;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 32); }
+        }
         while (n >= 8) {
-            f32x8_t a = _mm256_loadu_ps(v0);
-            f32x8_t b = avx2_expand_bf16_to_fp32(_mm_lddqu_si128((void*)v1));
+            mul_add0 = _mm256_fmadd_ps(_mm256_loadu_ps(v0),
+                avx2_load_bf16(v1), mul_add0);
             n -= 8; v0 += 8; v1 += 8;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x8 = _mm256_fmadd_ps(a, b, mul_add_f32x8);
         }
+        f32x8_t mul_add = _mm256_add_ps(_mm256_add_ps(mul_add0, mul_add1),
+                                _mm256_add_ps(mul_add2, mul_add3));
         f32x4_t f32x4 = _mm_add_ps(
-            _mm256_extractf32x4_ps(mul_add_f32x8, 0),  // 0,1,2,3
-            _mm256_extractf32x4_ps(mul_add_f32x8, 1)); // 4,5,6,7
+            _mm256_extractf32x4_ps(mul_add, 0),  // 0,1,2,3
+            _mm256_extractf32x4_ps(mul_add, 1)); // 4,5,6,7
         sum = f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
     }
     if (n > 0) { sum += cpu_dot32x16bf_c(v0, v1, n); }
@@ -376,86 +1247,617 @@ static fp64_t avx2_dot32x16bf(const fp32_t* restrict v0, const bf16_t* restrict
 
 static fp64_t avx2_dot16(const fp16_t* restrict v0, const fp16_t* restrict v1,
         int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 4);
     fp64_t sum = 0;
     if (n >= 8) {
-        f32x8_t mul_add_f32x8 = _mm256_setzero_ps();
+        // independent accumulators hide FMA latency:
+        f32x8_t mul_add0 = _mm256_setzero_ps();
+        f32x8_t mul_add1 = _mm256_setzero_ps();
+        f32x8_t mul_add2 = _mm256_setzero_ps();
+        f32x8_t mul_add3 = _mm256_setzero_ps();
+        while (n >= 32) {
+            mul_add0 = _mm256_fmadd_ps(avx2_load_fp16(v0),
+                avx2_load_fp16(v1), mul_add0);
+            mul_add1 = _mm256_fmadd_ps(avx2_load_fp16(v0 + 8),
+                avx2_load_fp16(v1 + 8), mul_add1);
+            mul_add2 = _mm256_fmadd_ps(avx2_load_fp16(v0 + 16),
+                avx2_load_fp16(v1 + 16), mul_add2);
+            mul_add3 = _mm256_fmadd_ps(avx2_load_fp16(v0 + 24),
+                avx2_load_fp16(v1 + 24), mul_add3);
+            n -= 32; v0 += 32; v1 += 32;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 32); }
+        }
         while (n >= 8) {
-            f32x8_t a = _mm256_cvtph_ps(_mm_lddqu_si128((void*)v0));
-            f32x8_t b = _mm256_cvtph_ps(_mm_lddqu_si128((void*)v1));
+            mul_add0 = _mm256_fmadd_ps(avx2_load_fp16(v0),
+                avx2_load_fp16(v1), mul_add0);
             n -= 8; v0 += 8; v1 += 8;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x8 = _mm256_fmadd_ps(a, b, mul_add_f32x8);
         }
+        f32x8_t mul_add = _mm256_add_ps(_mm256_add_ps(mul_add0, mul_add1),
+                                _mm256_add_ps(mul_add2, mul_add3));
         f32x4_t f32x4 = _mm_add_ps(
-            _mm256_extractf32x4_ps(mul_add_f32x8, 0),  // 0,1,2,3
-            _mm256_extractf32x4_ps(mul_add_f32x8, 1)); // 4,5,6,7
+            _mm256_extractf32x4_ps(mul_add, 0),  // 0,1,2,3
+            _mm256_extractf32x4_ps(mul_add, 1)); // 4,5,6,7
         sum = f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
     }
     if (n > 0) { sum += cpu_dot16_c(v0, v1, n); }
     return sum;
 }
 
-static fp64_t avx2_dot32x16(const fp32_t* restrict v0, const fp16_t* restrict v1,
-        int64_t n) {
-    fp64_t sum = 0;
-    if (n >= 8) {
-        f32x8_t mul_add_f32x8 = _mm256_setzero_ps();
-        while (n >= 8) {
-            f32x8_t a = _mm256_loadu_ps(v0);
-            f32x8_t b = _mm256_cvtph_ps(_mm_lddqu_si128((void*)v1));
-            n -= 8; v0 += 8; v1 += 8;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x8 = _mm256_fmadd_ps(a, b, mul_add_f32x8);
-        }
-        f32x4_t f32x4 = _mm_add_ps(
-            _mm256_extractf32x4_ps(mul_add_f32x8, 0),  // 0,1,2,3
-            _mm256_extractf32x4_ps(mul_add_f32x8, 1)); // 4,5,6,7
-        sum = f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
-    }
-    if (n > 0) { sum += cpu_dot32x16_c(v0, v1, n); }
-    return sum;
+static fp64_t avx2_dot32x16(const fp32_t* restrict v0, const fp16_t* restrict v1,
+        int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 6);
+    fp64_t sum = 0;
+    if (n >= 8) {
+        // independent accumulators hide FMA latency:
+        f32x8_t mul_add0 = _mm256_setzero_ps();
+        f32x8_t mul_add1 = _mm256_setzero_ps();
+        f32x8_t mul_add2 = _mm256_setzero_ps();
+        f32x8_t mul_add3 = _mm256_setzero_ps();
+        while (n >= 32) {
+            mul_add0 = _mm256_fmadd_ps(_mm256_loadu_ps(v0),
+                avx2_load_fp16(v1), mul_add0);
+            mul_add1 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 8),
+                avx2_load_fp16(v1 + 8), mul_add1);
+            mul_add2 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 16),
+                avx2_load_fp16(v1 + 16), mul_add2);
+            mul_add3 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 24),
+                avx2_load_fp16(v1 + 24), mul_add3);
+            n -= 32; v0 += 32; v1 += 32;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 32); }
+        }
+        while (n >= 8) {
+            mul_add0 = _mm256_fmadd_ps(_mm256_loadu_ps(v0),
+                avx2_load_fp16(v1), mul_add0);
+            n -= 8; v0 += 8; v1 += 8;
+        }
+        f32x8_t mul_add = _mm256_add_ps(_mm256_add_ps(mul_add0, mul_add1),
+                                _mm256_add_ps(mul_add2, mul_add3));
+        f32x4_t f32x4 = _mm_add_ps(
+            _mm256_extractf32x4_ps(mul_add, 0),  // 0,1,2,3
+            _mm256_extractf32x4_ps(mul_add, 1)); // 4,5,6,7
+        sum = f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
+    }
+    if (n > 0) { sum += cpu_dot32x16_c(v0, v1, n); }
+    return sum;
+}
+
+static fp64_t avx2_dot32(const fp32_t* restrict v0, const fp32_t* restrict v1,
+        int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 8);
+    fp64_t sum = 0;
+    if (n >= 8) {
+        // independent accumulators hide FMA latency:
+        f32x8_t mul_add0 = _mm256_setzero_ps();
+        f32x8_t mul_add1 = _mm256_setzero_ps();
+        f32x8_t mul_add2 = _mm256_setzero_ps();
+        f32x8_t mul_add3 = _mm256_setzero_ps();
+        while (n >= 32) {
+            mul_add0 = _mm256_fmadd_ps(_mm256_loadu_ps(v0),
+                _mm256_loadu_ps(v1), mul_add0);
+            mul_add1 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 8),
+                _mm256_loadu_ps(v1 + 8), mul_add1);
+            mul_add2 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 16),
+                _mm256_loadu_ps(v1 + 16), mul_add2);
+            mul_add3 = _mm256_fmadd_ps(_mm256_loadu_ps(v0 + 24),
+                _mm256_loadu_ps(v1 + 24), mul_add3);
+            n -= 32; v0 += 32; v1 += 32;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 32); }
+        }
+        while (n >= 8) {
+            mul_add0 = _mm256_fmadd_ps(_mm256_loadu_ps(v0),
+                _mm256_loadu_ps(v1), mul_add0);
+            n -= 8; v0 += 8; v1 += 8;
+        }
+        f32x8_t mul_add = _mm256_add_ps(_mm256_add_ps(mul_add0, mul_add1),
+                                _mm256_add_ps(mul_add2, mul_add3));
+        f32x4_t f32x4 = _mm_add_ps(
+            _mm256_extractf32x4_ps(mul_add, 0),  // 0,1,2,3
+            _mm256_extractf32x4_ps(mul_add, 1)); // 4,5,6,7
+        sum = f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
+    }
+    if (n > 0) { sum += cpu_dot32_c(v0, v1, n); }
+    return sum;
+}
+
+// Compensated dot product "Dot2" (Ogita, Rump, Oishi "Accurate Sum and
+// Dot Product" 2005): rounding errors of each product (TwoProduct via
+// FMA) and of each addition (branch free TwoSum) are accumulated in
+// separate fp32 lanes. Sums and compensations are flushed into fp64
+// lanes every dot2_block elements because fp32 compensation itself
+// loses precision after ~2^12 additions. 6 extra SIMD operations per FMA
+// still keep it memory bound for vectors that do not fit into L2.
+// TwoSum relies on exact IEEE evaluation order which /fp:fast (dot.c
+// build setting) is allowed to reassociate: Dot2 kernels are compiled
+// with float_control precise.
+
+enum { dot2_block = 4 * 1024 };
+
+#pragma float_control(precise, on, push)
+
+static inline void avx2_dot2(f32x8_t* s, f32x8_t* c, f32x8_t a, f32x8_t b) {
+    const f32x8_t p  = _mm256_mul_ps(a, b);
+    const f32x8_t ep = _mm256_fmsub_ps(a, b, p); // a * b - p exactly
+    const f32x8_t t  = _mm256_add_ps(*s, p);
+    const f32x8_t z  = _mm256_sub_ps(t, *s);
+    const f32x8_t es = _mm256_add_ps(_mm256_sub_ps(*s, _mm256_sub_ps(t, z)),
+                                     _mm256_sub_ps(p, z)); // *s + p - t
+    *s = t;
+    *c = _mm256_add_ps(*c, _mm256_add_ps(es, ep));
+}
+
+static inline f64x4_t avx2_add_ps_pd(f64x4_t sum, f32x8_t v) {
+    sum = _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+    return _mm256_add_pd(sum, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+}
+
+static fp64_t avx2_dot32_compensated(const fp32_t* restrict v0,
+        const fp32_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 8);
+    fp64_t sum = 0;
+    if (n >= 16) {
+        f64x4_t sum_pd = _mm256_setzero_pd();
+        while (n >= 16) {
+            // independent sum and compensation pairs hide latency:
+            f32x8_t s0 = _mm256_setzero_ps();
+            f32x8_t c0 = _mm256_setzero_ps();
+            f32x8_t s1 = _mm256_setzero_ps();
+            f32x8_t c1 = _mm256_setzero_ps();
+            int64_t k = min(n, (int64_t)dot2_block) / 16;
+            n -= k * 16;
+            while (k > 0) {
+                avx2_dot2(&s0, &c0, _mm256_loadu_ps(v0), _mm256_loadu_ps(v1));
+                avx2_dot2(&s1, &c1, _mm256_loadu_ps(v0 + 8), _mm256_loadu_ps(v1 + 8));
+                v0 += 16; v1 += 16; k--;
+                dot_prefetch2(pf, v0, v1, 16);
+            }
+            // s0 + s1 in fp32 would lose what c0 and c1 compensate:
+            sum_pd = avx2_add_ps_pd(sum_pd, s0);
+            sum_pd = avx2_add_ps_pd(sum_pd, s1);
+            sum_pd = avx2_add_ps_pd(sum_pd, _mm256_add_ps(c0, c1));
+        }
+        f64x2_t f64x2 = _mm_add_pd(_mm256_castpd256_pd128(sum_pd),
+                                   _mm256_extractf128_pd(sum_pd, 1));
+        sum = f64x2.m128d_f64[0] + f64x2.m128d_f64[1];
+    }
+    if (n > 0) { sum += cpu_dot32_compensated(v0, 1, v1, 1, n); }
+    return sum;
+}
+
+#pragma float_control(pop)
+
+static fp64_t avx2_dot64(const fp64_t* restrict v0,
+        const fp64_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 16);
+    fp64_t sum = 0;
+    if (n >= 4) {
+        // independent accumulators hide FMA latency:
+        f64x4_t mul_add0 = _mm256_setzero_pd();
+        f64x4_t mul_add1 = _mm256_setzero_pd();
+        f64x4_t mul_add2 = _mm256_setzero_pd();
+        f64x4_t mul_add3 = _mm256_setzero_pd();
+        while (n >= 16) {
+            mul_add0 = _mm256_fmadd_pd(_mm256_loadu_pd(v0),
+                _mm256_loadu_pd(v1), mul_add0);
+            mul_add1 = _mm256_fmadd_pd(_mm256_loadu_pd(v0 + 4),
+                _mm256_loadu_pd(v1 + 4), mul_add1);
+            mul_add2 = _mm256_fmadd_pd(_mm256_loadu_pd(v0 + 8),
+                _mm256_loadu_pd(v1 + 8), mul_add2);
+            mul_add3 = _mm256_fmadd_pd(_mm256_loadu_pd(v0 + 12),
+                _mm256_loadu_pd(v1 + 12), mul_add3);
+            n -= 16; v0 += 16; v1 += 16;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 16); }
+        }
+        while (n >= 4) {
+            mul_add0 = _mm256_fmadd_pd(_mm256_loadu_pd(v0),
+                _mm256_loadu_pd(v1), mul_add0);
+            n -= 4; v0 += 4; v1 += 4;
+        }
+        f64x4_t mul_add = _mm256_add_pd(_mm256_add_pd(mul_add0, mul_add1),
+                                _mm256_add_pd(mul_add2, mul_add3));
+        f64x2_t f64x2 = _mm_add_pd(
+            _mm256_castpd256_pd128(mul_add),     // 0, 1
+            _mm256_extractf64x2_pd(mul_add, 1)); // 2, 3
+        sum = f64x2.m128d_f64[0] + f64x2.m128d_f64[1];
+    }
+    if (n > 0) { sum += cpu_dot64_c(v0, v1, n); }
+    return sum;
+}
+
+static void avx2_dot32x16_x4(const fp32_t* restrict v, const fp16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs) {
+    const fp16_t* r0 = mx;
+    const fp16_t* r1 = r0 + stride;
+    const fp16_t* r2 = r1 + stride;
+    const fp16_t* r3 = r2 + stride;
+    f32x8_t mul_add0 = _mm256_setzero_ps();
+    f32x8_t mul_add1 = _mm256_setzero_ps();
+    f32x8_t mul_add2 = _mm256_setzero_ps();
+    f32x8_t mul_add3 = _mm256_setzero_ps();
+    int64_t i = 0;
+    while (i + 8 <= n) {
+        f32x8_t a = _mm256_loadu_ps(v + i); // loaded once for 4 rows
+        mul_add0 = _mm256_fmadd_ps(a, avx2_load_fp16(r0 + i), mul_add0);
+        mul_add1 = _mm256_fmadd_ps(a, avx2_load_fp16(r1 + i), mul_add1);
+        mul_add2 = _mm256_fmadd_ps(a, avx2_load_fp16(r2 + i), mul_add2);
+        mul_add3 = _mm256_fmadd_ps(a, avx2_load_fp16(r3 + i), mul_add3);
+        i += 8;
+    }
+    fp64_t s0 = avx2_reduce_add_ps(mul_add0);
+    fp64_t s1 = avx2_reduce_add_ps(mul_add1);
+    fp64_t s2 = avx2_reduce_add_ps(mul_add2);
+    fp64_t s3 = avx2_reduce_add_ps(mul_add3);
+    if (i < n) {
+        s0 += cpu_dot32x16_c(v + i, r0 + i, n - i);
+        s1 += cpu_dot32x16_c(v + i, r1 + i, n - i);
+        s2 += cpu_dot32x16_c(v + i, r2 + i, n - i);
+        s3 += cpu_dot32x16_c(v + i, r3 + i, n - i);
+    }
+    rs[0] = (fp32_t)s0; rs[1] = (fp32_t)s1; rs[2] = (fp32_t)s2; rs[3] = (fp32_t)s3;
+}
+
+static void avx2_dot32x16bf_x4(const fp32_t* restrict v, const bf16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs) {
+    const bf16_t* r0 = mx;
+    const bf16_t* r1 = r0 + stride;
+    const bf16_t* r2 = r1 + stride;
+    const bf16_t* r3 = r2 + stride;
+    f32x8_t mul_add0 = _mm256_setzero_ps();
+    f32x8_t mul_add1 = _mm256_setzero_ps();
+    f32x8_t mul_add2 = _mm256_setzero_ps();
+    f32x8_t mul_add3 = _mm256_setzero_ps();
+    int64_t i = 0;
+    while (i + 8 <= n) {
+        f32x8_t a = _mm256_loadu_ps(v + i); // loaded once for 4 rows
+        mul_add0 = _mm256_fmadd_ps(a, avx2_load_bf16(r0 + i), mul_add0);
+        mul_add1 = _mm256_fmadd_ps(a, avx2_load_bf16(r1 + i), mul_add1);
+        mul_add2 = _mm256_fmadd_ps(a, avx2_load_bf16(r2 + i), mul_add2);
+        mul_add3 = _mm256_fmadd_ps(a, avx2_load_bf16(r3 + i), mul_add3);
+        i += 8;
+    }
+    fp64_t s0 = avx2_reduce_add_ps(mul_add0);
+    fp64_t s1 = avx2_reduce_add_ps(mul_add1);
+    fp64_t s2 = avx2_reduce_add_ps(mul_add2);
+    fp64_t s3 = avx2_reduce_add_ps(mul_add3);
+    if (i < n) {
+        s0 += cpu_dot32x16bf_c(v + i, r0 + i, n - i);
+        s1 += cpu_dot32x16bf_c(v + i, r1 + i, n - i);
+        s2 += cpu_dot32x16bf_c(v + i, r2 + i, n - i);
+        s3 += cpu_dot32x16bf_c(v + i, r3 + i, n - i);
+    }
+    rs[0] = (fp32_t)s0; rs[1] = (fp32_t)s1; rs[2] = (fp32_t)s2; rs[3] = (fp32_t)s3;
+}
+
+// Q8 AVX2: int8 x int8 products via vpmaddubsw (unsigned x signed) using
+// |a| * (b * sign(a)) which is exact because q8 values are in [-127..127]
+
+static inline __m256i avx2_dot_i8x32(__m256i a, __m256i b) { // -> i32x8
+    const __m256i ax = _mm256_sign_epi8(a, a);
+    const __m256i sy = _mm256_sign_epi8(b, a);
+    const __m256i i16x16 = _mm256_maddubs_epi16(ax, sy); // |sum| <= 2 * 127^2
+    return _mm256_madd_epi16(i16x16, _mm256_set1_epi16(1));
+}
+
+static inline __m256i avx2_dot_i8x32_vnni(__m256i a, __m256i b) {
+    const __m256i ax = _mm256_sign_epi8(a, a);
+    const __m256i sy = _mm256_sign_epi8(b, a);
+    return _mm256_dpbusd_avx_epi32(_mm256_setzero_si256(), ax, sy);
+}
+
+static inline fp32_t avx2_q8_scale(const q8_t* v0, const q8_t* v1) {
+    return _cvtsh_ss(v0->scale.bytes) * _cvtsh_ss(v1->scale.bytes);
+}
+
+#pragma push_macro("avx2_dotq8_kernel")
+
+#define avx2_dotq8_kernel(name, dot_i8x32)                                   \
+static fp64_t name(const q8_t* restrict v0, const q8_t* restrict v1,          \
+        int64_t blocks) {                                                     \
+    const dot_prefetch_t pf =                                                 \
+        dot_prefetch_of(blocks * 2 * (int64_t)sizeof(q8_t));                  \
+    f32x8_t mul_add0 = _mm256_setzero_ps();                                   \
+    f32x8_t mul_add1 = _mm256_setzero_ps();                                   \
+    while (blocks >= 2) {                                                     \
+        __m256i d0 = dot_i8x32(_mm256_loadu_si256((void*)v0[0].q),            \
+                               _mm256_loadu_si256((void*)v1[0].q));           \
+        __m256i d1 = dot_i8x32(_mm256_loadu_si256((void*)v0[1].q),            \
+                               _mm256_loadu_si256((void*)v1[1].q));           \
+        mul_add0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(d0),                    \
+            _mm256_set1_ps(avx2_q8_scale(&v0[0], &v1[0])), mul_add0);         \
+        mul_add1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(d1),                    \
+            _mm256_set1_ps(avx2_q8_scale(&v0[1], &v1[1])), mul_add1);         \
+        blocks -= 2; v0 += 2; v1 += 2;                                        \
+        if (blocks > 0) { dot_prefetch2(pf, v0, v1, 2); }                     \
+    }                                                                         \
+    if (blocks > 0) {                                                         \
+        __m256i d0 = dot_i8x32(_mm256_loadu_si256((void*)v0[0].q),            \
+                               _mm256_loadu_si256((void*)v1[0].q));           \
+        mul_add0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(d0),                    \
+            _mm256_set1_ps(avx2_q8_scale(&v0[0], &v1[0])), mul_add0);         \
+    }                                                                         \
+    return avx2_reduce_add_ps(_mm256_add_ps(mul_add0, mul_add1));            \
+}
+
+avx2_dotq8_kernel(avx2_dotq8, avx2_dot_i8x32)
+avx2_dotq8_kernel(avx2_dotq8_vnni, avx2_dot_i8x32_vnni)
+
+#pragma pop_macro("avx2_dotq8_kernel")
+
+static void avx2_quantize_q8(const fp32_t* restrict v, q8_t* restrict q,
+        int64_t blocks) {
+    const f32x8_t sign = _mm256_set1_ps(-0.0f);
+    // packs_epi32/packs_epi16 interleave 128-bit lanes, this restores order:
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (int64_t b = 0; b < blocks; b++) {
+        f32x8_t x0 = _mm256_loadu_ps(v);
+        f32x8_t x1 = _mm256_loadu_ps(v + 8);
+        f32x8_t x2 = _mm256_loadu_ps(v + 16);
+        f32x8_t x3 = _mm256_loadu_ps(v + 24);
+        f32x8_t m8 = _mm256_max_ps(
+            _mm256_max_ps(_mm256_andnot_ps(sign, x0), _mm256_andnot_ps(sign, x1)),
+            _mm256_max_ps(_mm256_andnot_ps(sign, x2), _mm256_andnot_ps(sign, x3)));
+        f32x4_t m4 = _mm_max_ps(_mm256_castps256_ps128(m8),
+                                _mm256_extractf128_ps(m8, 1));
+        m4 = _mm_max_ps(m4, _mm_movehl_ps(m4, m4));
+        m4 = _mm_max_ss(m4, _mm_movehdup_ps(m4));
+        const fp32_t amax = _mm_cvtss_f32(m4);
+        const f32x8_t inv = _mm256_set1_ps(amax != 0 ? 127.0f / amax : 0);
+        __m256i i0 = _mm256_cvtps_epi32(_mm256_mul_ps(x0, inv));
+        __m256i i1 = _mm256_cvtps_epi32(_mm256_mul_ps(x1, inv));
+        __m256i i2 = _mm256_cvtps_epi32(_mm256_mul_ps(x2, inv));
+        __m256i i3 = _mm256_cvtps_epi32(_mm256_mul_ps(x3, inv));
+        __m256i i8 = _mm256_packs_epi16(_mm256_packs_epi32(i0, i1),
+                                        _mm256_packs_epi32(i2, i3));
+        i8 = _mm256_permutevar8x32_epi32(i8, order);
+        _mm256_storeu_si256((__m256i*)q->q, i8);
+        q->scale = fp32to16(amax / 127.0f); // same as fp32toq8()
+        v += q8_block;
+        q++;
+    }
+}
+
+// Q4 AVX2: 16 bytes of nibbles are unpacked in registers into 32 x u8 in
+// [0..15] (lo = values 0..15, hi = values 16..31) see q4_t in fp16.h
+
+static inline void avx2_unpack_q4(const uint8_t* q, __m128i* lo, __m128i* hi) {
+    const __m128i mask = _mm_set1_epi8(0xF);
+    const __m128i b = _mm_loadu_si128((const __m128i*)q);
+    *lo = _mm_and_si128(b, mask);
+    *hi = _mm_and_si128(_mm_srli_epi16(b, 4), mask);
+}
+
+static inline f32x8_t avx2_i8x8_ps(__m128i i8) { // low 8 bytes -> f32x8
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(i8));
+}
+
+static inline f32x8_t avx2_dot32x32i8(const fp32_t* v, __m128i lo, __m128i hi) {
+    f32x8_t d = _mm256_mul_ps(avx2_i8x8_ps(lo), _mm256_loadu_ps(v));
+    d = _mm256_fmadd_ps(avx2_i8x8_ps(_mm_srli_si128(lo, 8)), _mm256_loadu_ps(v +  8), d);
+    d = _mm256_fmadd_ps(avx2_i8x8_ps(hi), _mm256_loadu_ps(v + 16), d);
+    d = _mm256_fmadd_ps(avx2_i8x8_ps(_mm_srli_si128(hi, 8)), _mm256_loadu_ps(v + 24), d);
+    return d;
+}
+
+static fp64_t avx2_dot32xq4(const fp32_t* restrict v, const q4_t* restrict q,
+        int64_t blocks) {
+    const dot_prefetch_t pf = dot_prefetch_of(
+        blocks * (int64_t)(q4_block * sizeof(fp32_t) + sizeof(q4_t)));
+    const __m128i eight = _mm_set1_epi8(8);
+    f32x8_t mul_add0 = _mm256_setzero_ps();
+    f32x8_t mul_add1 = _mm256_setzero_ps();
+    while (blocks >= 2) {
+        __m128i lo0, hi0, lo1, hi1;
+        avx2_unpack_q4(q[0].q, &lo0, &hi0);
+        avx2_unpack_q4(q[1].q, &lo1, &hi1);
+        f32x8_t d0 = avx2_dot32x32i8(v, _mm_sub_epi8(lo0, eight),
+                                        _mm_sub_epi8(hi0, eight));
+        f32x8_t d1 = avx2_dot32x32i8(v + q4_block, _mm_sub_epi8(lo1, eight),
+                                                   _mm_sub_epi8(hi1, eight));
+        mul_add0 = _mm256_fmadd_ps(d0, _mm256_set1_ps(_cvtsh_ss(q[0].scale.bytes)), mul_add0);
+        mul_add1 = _mm256_fmadd_ps(d1, _mm256_set1_ps(_cvtsh_ss(q[1].scale.bytes)), mul_add1);
+        blocks -= 2; q += 2; v += q4_block * 2;
+        if (blocks > 0) { dot_prefetch2n(pf, v, q4_block * 2, q, 2); }
+    }
+    if (blocks > 0) {
+        __m128i lo0, hi0;
+        avx2_unpack_q4(q[0].q, &lo0, &hi0);
+        f32x8_t d0 = avx2_dot32x32i8(v, _mm_sub_epi8(lo0, eight),
+                                        _mm_sub_epi8(hi0, eight));
+        mul_add0 = _mm256_fmadd_ps(d0, _mm256_set1_ps(_cvtsh_ss(q[0].scale.bytes)), mul_add0);
+    }
+    return avx2_reduce_add_ps(_mm256_add_ps(mul_add0, mul_add1));
+}
+
+static fp64_t avx2_dot32xq4m(const fp32_t* restrict v, const q4m_t* restrict q,
+        int64_t blocks) {
+    // sum(v[i] * (q[i] * scale + min)) = scale * sum(v[i] * q[i]) + min * sum(v[i])
+    const dot_prefetch_t pf = dot_prefetch_of(
+        blocks * (int64_t)(q4_block * sizeof(fp32_t) + sizeof(q4m_t)));
+    f32x8_t mul_add0 = _mm256_setzero_ps();
+    f32x8_t mul_add1 = _mm256_setzero_ps();
+    while (blocks > 0) {
+        __m128i lo, hi;
+        avx2_unpack_q4(q->q, &lo, &hi);
+        f32x8_t d = avx2_dot32x32i8(v, lo, hi);
+        f32x8_t sv = _mm256_add_ps(
+            _mm256_add_ps(_mm256_loadu_ps(v),      _mm256_loadu_ps(v +  8)),
+            _mm256_add_ps(_mm256_loadu_ps(v + 16), _mm256_loadu_ps(v + 24)));
+        mul_add0 = _mm256_fmadd_ps(d,  _mm256_set1_ps(_cvtsh_ss(q->scale.bytes)), mul_add0);
+        mul_add1 = _mm256_fmadd_ps(sv, _mm256_set1_ps(_cvtsh_ss(q->min.bytes)), mul_add1);
+        blocks--; q++; v += q4_block;
+        if (blocks > 0) { dot_prefetch2n(pf, v, q4_block, q, 1); }
+    }
+    return avx2_reduce_add_ps(_mm256_add_ps(mul_add0, mul_add1));
+}
+
+// Q4 x Q8: q4_t nibbles minus 8 are in [-8..7] and reuse avx2_dot_i8x32();
+// q4m_t nibbles are unsigned and go directly into vpmaddubsw/vpdpbusd
+
+static inline __m256i avx2_dot_u8i8x32(__m256i a, __m256i b) { // -> i32x8
+    const __m256i i16x16 = _mm256_maddubs_epi16(a, b); // |sum| <= 2 * 255 * 127
+    return _mm256_madd_epi16(i16x16, _mm256_set1_epi16(1));
+}
+
+static inline __m256i avx2_dot_u8i8x32_vnni(__m256i a, __m256i b) {
+    return _mm256_dpbusd_avx_epi32(_mm256_setzero_si256(), a, b);
+}
+
+static inline __m256i avx2_load_q4(const q4_t* q) { // -> 32 x u8 [0..15]
+    __m128i lo, hi;
+    avx2_unpack_q4(q->q, &lo, &hi);
+    return _mm256_set_m128i(hi, lo);
+}
+
+static inline __m256i avx2_load_q4m(const q4m_t* q) {
+    __m128i lo, hi;
+    avx2_unpack_q4(q->q, &lo, &hi);
+    return _mm256_set_m128i(hi, lo);
+}
+
+#pragma push_macro("avx2_dotq8xq4_kernel")
+#pragma push_macro("avx2_dotq8xq4m_kernel")
+
+#define avx2_dotq8xq4_kernel(name, dot_i8x32)                                \
+static fp64_t name(const q8_t* restrict v, const q4_t* restrict q,            \
+        int64_t blocks) {                                                     \
+    const dot_prefetch_t pf = dot_prefetch_of(                                \
+        blocks * (int64_t)(sizeof(q8_t) + sizeof(q4_t)));                     \
+    const __m256i eight = _mm256_set1_epi8(8);                                \
+    f32x8_t mul_add0 = _mm256_setzero_ps();                                   \
+    f32x8_t mul_add1 = _mm256_setzero_ps();                                   \
+    while (blocks >= 2) {                                                     \
+        __m256i d0 = dot_i8x32(_mm256_sub_epi8(avx2_load_q4(&q[0]), eight),   \
+                               _mm256_loadu_si256((void*)v[0].q));            \
+        __m256i d1 = dot_i8x32(_mm256_sub_epi8(avx2_load_q4(&q[1]), eight),   \
+                               _mm256_loadu_si256((void*)v[1].q));            \
+        mul_add0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(d0), _mm256_set1_ps(    \
+            _cvtsh_ss(v[0].scale.bytes) * _cvtsh_ss(q[0].scale.bytes)),       \
+            mul_add0);                                                        \
+        mul_add1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(d1), _mm256_set1_ps(    \
+            _cvtsh_ss(v[1].scale.bytes) * _cvtsh_ss(q[1].scale.bytes)),       \
+            mul_add1);                                                        \
+        blocks -= 2; v += 2; q += 2;                                          \
+        if (blocks > 0) { dot_prefetch2(pf, v, q, 2); }                       \
+    }                                                                         \
+    if (blocks > 0) {                                                         \
+        __m256i d0 = dot_i8x32(_mm256_sub_epi8(avx2_load_q4(&q[0]), eight),   \
+                               _mm256_loadu_si256((void*)v[0].q));            \
+        mul_add0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(d0), _mm256_set1_ps(    \
+            _cvtsh_ss(v[0].scale.bytes) * _cvtsh_ss(q[0].scale.bytes)),       \
+            mul_add0);                                                        \
+    }                                                                         \
+    return avx2_reduce_add_ps(_mm256_add_ps(mul_add0, mul_add1));            \
+}
+
+#define avx2_dotq8xq4m_kernel(name, dot_u8i8x32)                             \
+static fp64_t name(const q8_t* restrict v, const q4m_t* restrict q,           \
+        int64_t blocks) {                                                     \
+    const dot_prefetch_t pf = dot_prefetch_of(                                \
+        blocks * (int64_t)(sizeof(q8_t) + sizeof(q4m_t)));                    \
+    const __m256i ones = _mm256_set1_epi8(1);                                 \
+    f32x8_t mul_add0 = _mm256_setzero_ps();                                   \
+    f32x8_t mul_add1 = _mm256_setzero_ps();                                   \
+    while (blocks > 0) {                                                      \
+        const __m256i y = _mm256_loadu_si256((void*)v->q);                    \
+        __m256i d = dot_u8i8x32(avx2_load_q4m(q), y);                         \
+        __m256i s = dot_u8i8x32(ones, y);                                     \
+        const fp32_t vs = _cvtsh_ss(v->scale.bytes);                          \
+        mul_add0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(d),                     \
+            _mm256_set1_ps(vs * _cvtsh_ss(q->scale.bytes)), mul_add0);        \
+        mul_add1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(s),                     \
+            _mm256_set1_ps(vs * _cvtsh_ss(q->min.bytes)), mul_add1);          \
+        blocks--; v++; q++;                                                   \
+        if (blocks > 0) { dot_prefetch2(pf, v, q, 1); }                       \
+    }                                                                         \
+    return avx2_reduce_add_ps(_mm256_add_ps(mul_add0, mul_add1));            \
+}
+
+avx2_dotq8xq4_kernel(avx2_dotq8xq4, avx2_dot_i8x32)
+avx2_dotq8xq4_kernel(avx2_dotq8xq4_vnni, avx2_dot_i8x32_vnni)
+avx2_dotq8xq4m_kernel(avx2_dotq8xq4m, avx2_dot_u8i8x32)
+avx2_dotq8xq4m_kernel(avx2_dotq8xq4m_vnni, avx2_dot_u8i8x32_vnni)
+
+#pragma pop_macro("avx2_dotq8xq4m_kernel")
+#pragma pop_macro("avx2_dotq8xq4_kernel")
+
+// Strided AVX2: gathers with 32-bit indices [0..7] * stride. 16 bit fp16
+// and bf16 elements are gathered as 32 bit dwords (upper half discarded)
+// thus the last element is always left to the C tail and the gather never
+// reads 2 bytes past the end of the vector.
+
+static inline __m256i avx2_stride_index(int64_t s) {
+    return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                              _mm256_set1_epi32((int32_t)s));
+}
+
+static inline f32x8_t avx2_gather_fp32(const fp32_t* p, int64_t s, __m256i ix) {
+    return s == 1 ? _mm256_loadu_ps(p) : _mm256_i32gather_ps(p, ix, 4);
 }
 
-static fp64_t avx2_dot32(const fp32_t* restrict v0, const fp32_t* restrict v1,
-        int64_t n) {
-    fp64_t sum = 0;
-    if (n >= 8) {
-        f32x8_t mul_add_f32x8 = _mm256_setzero_ps();
-        while (n >= 8) {
-            f32x8_t a = _mm256_loadu_ps(v0);
-            f32x8_t b = _mm256_loadu_ps(v1);
-            n -= 8; v0 += 8; v1 += 8;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x8 = _mm256_fmadd_ps(a, b, mul_add_f32x8);
-        }
-        f32x4_t f32x4 = _mm_add_ps(
-            _mm256_extractf32x4_ps(mul_add_f32x8, 0),  // 0,1,2,3
-            _mm256_extractf32x4_ps(mul_add_f32x8, 1)); // 4,5,6,7
-        sum = f32x4.m128_f32[0] + f32x4.m128_f32[1] + f32x4.m128_f32[2] + f32x4.m128_f32[3];
-    }
-    if (n > 0) { sum += cpu_dot32_c(v0, v1, n); }
-    return sum;
+static inline f32x8_t avx2_gather_fp16(const fp16_t* p, int64_t s, __m256i ix) {
+    if (s == 1) { return avx2_load_fp16(p); }
+    __m256i d = _mm256_and_si256(_mm256_i32gather_epi32((const int*)p, ix, 2),
+                                 _mm256_set1_epi32(0xFFFF));
+    // packus interleaves 128-bit lanes: d0..3 d0..3 d4..7 d4..7
+    d = _mm256_permute4x64_epi64(_mm256_packus_epi32(d, d), _MM_SHUFFLE(3, 1, 2, 0));
+    return _mm256_cvtph_ps(_mm256_castsi256_si128(d));
 }
 
-static fp64_t avx2_dot64(const fp64_t* restrict v0,
-        const fp64_t* restrict v1, int64_t n) {
-    fp64_t sum = 0;
-    if (n >= 4) {
-        f64x4_t mul_add_f64x4 = _mm256_setzero_pd();
-        while (n >= 4) {
-            f64x4_t a = _mm256_loadu_pd(v0);
-            f64x4_t b = _mm256_loadu_pd(v1);
-            n -= 4; v0 +=4; v1 += 4;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f64x4 = _mm256_fmadd_pd(a, b, mul_add_f64x4);
-        }
-        f64x2_t f64x2 = _mm_add_pd(
-            _mm256_castpd256_pd128(mul_add_f64x4),     // 0, 1
-            _mm256_extractf64x2_pd(mul_add_f64x4, 1)); // 2, 3
-        sum = f64x2.m128d_f64[0] + f64x2.m128d_f64[1];
+static inline f32x8_t avx2_gather_bf16(const bf16_t* p, int64_t s, __m256i ix) {
+    if (s == 1) { return avx2_load_bf16(p); }
+    return _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_i32gather_epi32((const int*)p, ix, 2), 16));
+}
+
+#pragma push_macro("avx2_dot_s_kernel")
+
+#define avx2_dot_s_kernel(name, t0, t1, gather0, gather1, tail)             \
+static fp64_t name(const t0* restrict v0, int64_t s0,                         \
+        const t1* restrict v1, int64_t s1, int64_t n) {                       \
+    const __m256i ix0 = avx2_stride_index(s0);                                \
+    const __m256i ix1 = avx2_stride_index(s1);                                \
+    f32x8_t mul_add0 = _mm256_setzero_ps();                                   \
+    f32x8_t mul_add1 = _mm256_setzero_ps();                                   \
+    while (n > 16) {                                                          \
+        mul_add0 = _mm256_fmadd_ps(gather0(v0, s0, ix0),                      \
+                                   gather1(v1, s1, ix1), mul_add0);           \
+        mul_add1 = _mm256_fmadd_ps(gather0(v0 + 8 * s0, s0, ix0),             \
+                                   gather1(v1 + 8 * s1, s1, ix1), mul_add1);  \
+        v0 += 16 * s0; v1 += 16 * s1; n -= 16;                                \
+    }                                                                         \
+    if (n > 8) {                                                              \
+        mul_add0 = _mm256_fmadd_ps(gather0(v0, s0, ix0),                      \
+                                   gather1(v1, s1, ix1), mul_add0);           \
+        v0 += 8 * s0; v1 += 8 * s1; n -= 8;                                   \
+    }                                                                         \
+    return avx2_reduce_add_ps(_mm256_add_ps(mul_add0, mul_add1)) +            \
+           tail(v0, s0, v1, s1, n);                                           \
+}
+
+avx2_dot_s_kernel(avx2_dot16_s,      fp16_t, fp16_t, avx2_gather_fp16, avx2_gather_fp16, cpu_dot16_s)
+avx2_dot_s_kernel(avx2_dot32x16_s,   fp32_t, fp16_t, avx2_gather_fp32, avx2_gather_fp16, cpu_dot32x16_s)
+avx2_dot_s_kernel(avx2_dot16bf_s,    bf16_t, bf16_t, avx2_gather_bf16, avx2_gather_bf16, cpu_dot16bf_s)
+avx2_dot_s_kernel(avx2_dot32x16bf_s, fp32_t, bf16_t, avx2_gather_fp32, avx2_gather_bf16, cpu_dot32x16bf_s)
+avx2_dot_s_kernel(avx2_dot32_s,      fp32_t, fp32_t, avx2_gather_fp32, avx2_gather_fp32, cpu_dot32_s)
+
+#pragma pop_macro("avx2_dot_s_kernel")
+
+static fp64_t avx2_dot64_s(const fp64_t* restrict v0, int64_t s0,
+        const fp64_t* restrict v1, int64_t s1, int64_t n) {
+    const __m256i ix0 = _mm256_setr_epi64x(0, s0, 2 * s0, 3 * s0);
+    const __m256i ix1 = _mm256_setr_epi64x(0, s1, 2 * s1, 3 * s1);
+    f64x4_t mul_add0 = _mm256_setzero_pd();
+    f64x4_t mul_add1 = _mm256_setzero_pd();
+    while (n >= 8) {
+        mul_add0 = _mm256_fmadd_pd(_mm256_i64gather_pd(v0, ix0, 8),
+                                   _mm256_i64gather_pd(v1, ix1, 8), mul_add0);
+        mul_add1 = _mm256_fmadd_pd(_mm256_i64gather_pd(v0 + 4 * s0, ix0, 8),
+                                   _mm256_i64gather_pd(v1 + 4 * s1, ix1, 8), mul_add1);
+        v0 += 8 * s0; v1 += 8 * s1; n -= 8;
     }
-    if (n > 0) { sum += cpu_dot64_c(v0, v1, n); }
-    return sum;
+    f64x4_t mul_add = _mm256_add_pd(mul_add0, mul_add1);
+    f64x2_t f64x2 = _mm_add_pd(_mm256_castpd256_pd128(mul_add),
+                               _mm256_extractf128_pd(mul_add, 1));
+    return f64x2.m128d_f64[0] + f64x2.m128d_f64[1] + cpu_dot64_s(v0, s0, v1, s1, n);
 }
 
 // avx512:
@@ -464,19 +1866,44 @@ static inline f32x16_t avx512_expand_bf16_to_fp32(__m256i v) {
     return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16));
 }
 
+static inline f32x16_t avx512_load_bf16(const bf16_t* p) { // 16 x bf16 -> fp32
+    return avx512_expand_bf16_to_fp32(_mm256_lddqu_si256((void*)p));
+}
+
+static inline f32x16_t avx512_load_fp16(const fp16_t* p) { // 16 x fp16 -> fp32
+    return _mm512_cvtph_ps(_mm256_lddqu_si256((void*)p));
+}
+
 static fp64_t avx512_dot16bf(const bf16_t* restrict v0,
         const bf16_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 4);
     fp64_t sum = 0;
     if (n >= 16) {
-        f32x16_t mul_add_f32x16 = _mm512_setzero_ps(); // multiply and add
+        // independent accumulators hide FMA latency:
+        f32x16_t mul_add0 = _mm512_setzero_ps();
+        f32x16_t mul_add1 = _mm512_setzero_ps();
+        f32x16_t mul_add2 = _mm512_setzero_ps();
+        f32x16_t mul_add3 = _mm512_setzero_ps();
+        while (n >= 64) {
+            mul_add0 = _mm512_fmadd_ps(avx512_load_bf16(v0),
+                avx512_load_bf16(v1), mul_add0);
+            mul_add1 = _mm512_fmadd_ps(avx512_load_bf16(v0 + 16),
+                avx512_load_bf16(v1 + 16), mul_add1);
+            mul_add2 = _mm512_fmadd_ps(avx512_load_bf16(v0 + 32),
+                avx512_load_bf16(v1 + 32), mul_add2);
+            mul_add3 = _mm512_fmadd_ps(avx512_load_bf16(v0 + 48),
+                avx512_load_bf16(v1 + 48), mul_add3);
+            n -= 64; v0 += 64; v1 += 64;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 64); }
+        }
         while (n >= 16) {
-            f32x16_t a = avx512_expand_bf16_to_fp32(_mm256_lddqu_si256((void*)v0));
-            f32x16_t b = avx512_expand_bf16_to_fp32(_mm256_lddqu_si256((void*)v1));
-            n -= 16; v0 +=16; v1 += 16;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x16 = _mm512_fmadd_ps(a, b, mul_add_f32x16);
+            mul_add0 = _mm512_fmadd_ps(avx512_load_bf16(v0),
+                avx512_load_bf16(v1), mul_add0);
+            n -= 16; v0 += 16; v1 += 16;
         }
-        sum = _mm512_reduce_add_ps(mul_add_f32x16);
+        f32x16_t mul_add = _mm512_add_ps(_mm512_add_ps(mul_add0, mul_add1),
+                                _mm512_add_ps(mul_add2, mul_add3));
+        sum = _mm512_reduce_add_ps(mul_add);
     }
     if (n > 0) { sum += cpu_dot16bf_c(v0, v1, n); }
     return sum;
@@ -484,17 +1911,34 @@ static fp64_t avx512_dot16bf(const bf16_t* restrict v0,
 
 static fp64_t avx512_dot32x16bf(const fp32_t* restrict v0,
         const bf16_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 6);
     fp64_t sum = 0;
     if (n >= 16) {
-        f32x16_t mul_add_f32x16 = _mm512_setzero_ps(); // multiply and add
+        // independent accumulators hide FMA latency:
+        f32x16_t mul_add0 = _mm512_setzero_ps();
+        f32x16_t mul_add1 = _mm512_setzero_ps();
+        f32x16_t mul_add2 = _mm512_setzero_ps();
+        f32x16_t mul_add3 = _mm512_setzero_ps();
+        while (n >= 64) {
+            mul_add0 = _mm512_fmadd_ps(_mm512_loadu_ps(v0),
+                avx512_load_bf16(v1), mul_add0);
+            mul_add1 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 16),
+                avx512_load_bf16(v1 + 16), mul_add1);
+            mul_add2 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 32),
+                avx512_load_bf16(v1 + 32), mul_add2);
+            mul_add3 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 48),
+                avx512_load_bf16(v1 + 48), mul_add3);
+            n -= 64; v0 += 64; v1 += 64;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 64); }
+        }
         while (n >= 16) {
-            f32x16_t a = _mm512_loadu_ps(v0);
-            f32x16_t b = avx512_expand_bf16_to_fp32(_mm256_lddqu_si256((void*)v1));
-            n -= 16; v0 +=16; v1 += 16;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x16 = _mm512_fmadd_ps(a, b, mul_add_f32x16);
+            mul_add0 = _mm512_fmadd_ps(_mm512_loadu_ps(v0),
+                avx512_load_bf16(v1), mul_add0);
+            n -= 16; v0 += 16; v1 += 16;
         }
-        sum = _mm512_reduce_add_ps(mul_add_f32x16);
+        f32x16_t mul_add = _mm512_add_ps(_mm512_add_ps(mul_add0, mul_add1),
+                                _mm512_add_ps(mul_add2, mul_add3));
+        sum = _mm512_reduce_add_ps(mul_add);
     }
     if (n > 0) { sum += cpu_dot32x16bf_c(v0, v1, n); }
     return sum;
@@ -502,17 +1946,34 @@ static fp64_t avx512_dot32x16bf(const fp32_t* restrict v0,
 
 static fp64_t avx512_dot16(const fp16_t* restrict v0,
         const fp16_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 4);
     fp64_t sum = 0;
     if (n >= 16) {
-        f32x16_t mul_add_f32x16 = _mm512_setzero_ps(); // multiply and add
+        // independent accumulators hide FMA latency:
+        f32x16_t mul_add0 = _mm512_setzero_ps();
+        f32x16_t mul_add1 = _mm512_setzero_ps();
+        f32x16_t mul_add2 = _mm512_setzero_ps();
+        f32x16_t mul_add3 = _mm512_setzero_ps();
+        while (n >= 64) {
+            mul_add0 = _mm512_fmadd_ps(avx512_load_fp16(v0),
+                avx512_load_fp16(v1), mul_add0);
+            mul_add1 = _mm512_fmadd_ps(avx512_load_fp16(v0 + 16),
+                avx512_load_fp16(v1 + 16), mul_add1);
+            mul_add2 = _mm512_fmadd_ps(avx512_load_fp16(v0 + 32),
+                avx512_load_fp16(v1 + 32), mul_add2);
+            mul_add3 = _mm512_fmadd_ps(avx512_load_fp16(v0 + 48),
+                avx512_load_fp16(v1 + 48), mul_add3);
+            n -= 64; v0 += 64; v1 += 64;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 64); }
+        }
         while (n >= 16) {
-            f32x16_t a = _mm512_cvtph_ps(_mm256_lddqu_si256((void*)v0));
-            f32x16_t b = _mm512_cvtph_ps(_mm256_lddqu_si256((void*)v1));
-            n -= 16; v0 +=16; v1 += 16;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x16 = _mm512_fmadd_ps(a, b, mul_add_f32x16);
+            mul_add0 = _mm512_fmadd_ps(avx512_load_fp16(v0),
+                avx512_load_fp16(v1), mul_add0);
+            n -= 16; v0 += 16; v1 += 16;
         }
-        sum = _mm512_reduce_add_ps(mul_add_f32x16);
+        f32x16_t mul_add = _mm512_add_ps(_mm512_add_ps(mul_add0, mul_add1),
+                                _mm512_add_ps(mul_add2, mul_add3));
+        sum = _mm512_reduce_add_ps(mul_add);
     }
     if (n > 0) { sum += cpu_dot16_c(v0, v1, n); }
     return sum;
@@ -520,17 +1981,34 @@ static fp64_t avx512_dot16(const fp16_t* restrict v0,
 
 static fp64_t avx512_dot32x16(const fp32_t* restrict v0,
         const fp16_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 6);
     fp64_t sum = 0;
     if (n >= 16) {
-        f32x16_t mul_add_f32x16 = _mm512_setzero_ps(); // multiply and add
+        // independent accumulators hide FMA latency:
+        f32x16_t mul_add0 = _mm512_setzero_ps();
+        f32x16_t mul_add1 = _mm512_setzero_ps();
+        f32x16_t mul_add2 = _mm512_setzero_ps();
+        f32x16_t mul_add3 = _mm512_setzero_ps();
+        while (n >= 64) {
+            mul_add0 = _mm512_fmadd_ps(_mm512_loadu_ps(v0),
+                avx512_load_fp16(v1), mul_add0);
+            mul_add1 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 16),
+                avx512_load_fp16(v1 + 16), mul_add1);
+            mul_add2 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 32),
+                avx512_load_fp16(v1 + 32), mul_add2);
+            mul_add3 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 48),
+                avx512_load_fp16(v1 + 48), mul_add3);
+            n -= 64; v0 += 64; v1 += 64;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 64); }
+        }
         while (n >= 16) {
-            f32x16_t a = _mm512_loadu_ps(v0);
-            f32x16_t b = _mm512_cvtph_ps(_mm256_lddqu_si256((void*)v1));
-            n -= 16; v0 +=16; v1 += 16;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x16 = _mm512_fmadd_ps(a, b, mul_add_f32x16);
+            mul_add0 = _mm512_fmadd_ps(_mm512_loadu_ps(v0),
+                avx512_load_fp16(v1), mul_add0);
+            n -= 16; v0 += 16; v1 += 16;
         }
-        sum = _mm512_reduce_add_ps(mul_add_f32x16);
+        f32x16_t mul_add = _mm512_add_ps(_mm512_add_ps(mul_add0, mul_add1),
+                                _mm512_add_ps(mul_add2, mul_add3));
+        sum = _mm512_reduce_add_ps(mul_add);
     }
     if (n > 0) { sum += cpu_dot32x16_c(v0, v1, n); }
     return sum;
@@ -545,39 +2023,435 @@ static fp64_t avx512_dot32x16(const fp32_t* restrict v0,
 
 static fp64_t avx512_dot32(const fp32_t* restrict v0,
         const fp32_t* restrict v1, int64_t n) { // ~22GFlops
+    const dot_prefetch_t pf = dot_prefetch_of(n * 8);
     fp64_t sum = 0;
     if (n >= 16) {
-        f32x16_t mul_add_f32x16 = _mm512_setzero_ps(); // multiply and add
+        // independent accumulators hide FMA latency:
+        f32x16_t mul_add0 = _mm512_setzero_ps();
+        f32x16_t mul_add1 = _mm512_setzero_ps();
+        f32x16_t mul_add2 = _mm512_setzero_ps();
+        f32x16_t mul_add3 = _mm512_setzero_ps();
+        while (n >= 64) {
+            mul_add0 = _mm512_fmadd_ps(_mm512_loadu_ps(v0),
+                _mm512_loadu_ps(v1), mul_add0);
+            mul_add1 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 16),
+                _mm512_loadu_ps(v1 + 16), mul_add1);
+            mul_add2 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 32),
+                _mm512_loadu_ps(v1 + 32), mul_add2);
+            mul_add3 = _mm512_fmadd_ps(_mm512_loadu_ps(v0 + 48),
+                _mm512_loadu_ps(v1 + 48), mul_add3);
+            n -= 64; v0 += 64; v1 += 64;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 64); }
+        }
         while (n >= 16) {
-            f32x16_t a = _mm512_loadu_ps(v0); // f32x8
-            f32x16_t b = _mm512_loadu_ps(v1); // f32x8
-            n -= 16; v0 +=16; v1 += 16;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f32x16 = _mm512_fmadd_ps(a, b, mul_add_f32x16);
+            mul_add0 = _mm512_fmadd_ps(_mm512_loadu_ps(v0),
+                _mm512_loadu_ps(v1), mul_add0);
+            n -= 16; v0 += 16; v1 += 16;
         }
-        sum = _mm512_reduce_add_ps(mul_add_f32x16);
+        f32x16_t mul_add = _mm512_add_ps(_mm512_add_ps(mul_add0, mul_add1),
+                                _mm512_add_ps(mul_add2, mul_add3));
+        sum = _mm512_reduce_add_ps(mul_add);
     }
     if (n > 0) { sum += cpu_dot32_c(v0, v1, n); }
     return sum;
 }
 
+#pragma float_control(precise, on, push) // see Dot2 comment above
+
+static inline void avx512_dot2(f32x16_t* s, f32x16_t* c, f32x16_t a, f32x16_t b) {
+    const f32x16_t p  = _mm512_mul_ps(a, b);
+    const f32x16_t ep = _mm512_fmsub_ps(a, b, p); // a * b - p exactly
+    const f32x16_t t  = _mm512_add_ps(*s, p);
+    const f32x16_t z  = _mm512_sub_ps(t, *s);
+    const f32x16_t es = _mm512_add_ps(_mm512_sub_ps(*s, _mm512_sub_ps(t, z)),
+                                      _mm512_sub_ps(p, z)); // *s + p - t
+    *s = t;
+    *c = _mm512_add_ps(*c, _mm512_add_ps(es, ep));
+}
+
+static inline f64x8_t avx512_add_ps_pd(f64x8_t sum, f32x16_t v) {
+    sum = _mm512_add_pd(sum, _mm512_cvtps_pd(_mm512_castps512_ps256(v)));
+    return _mm512_add_pd(sum, _mm512_cvtps_pd(
+        _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1))));
+}
+
+static fp64_t avx512_dot32_compensated(const fp32_t* restrict v0,
+        const fp32_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 8);
+    fp64_t sum = 0;
+    if (n >= 32) {
+        f64x8_t sum_pd = _mm512_setzero_pd();
+        while (n >= 32) {
+            f32x16_t s0 = _mm512_setzero_ps();
+            f32x16_t c0 = _mm512_setzero_ps();
+            f32x16_t s1 = _mm512_setzero_ps();
+            f32x16_t c1 = _mm512_setzero_ps();
+            int64_t k = min(n, (int64_t)dot2_block) / 32;
+            n -= k * 32;
+            while (k > 0) {
+                avx512_dot2(&s0, &c0, _mm512_loadu_ps(v0), _mm512_loadu_ps(v1));
+                avx512_dot2(&s1, &c1, _mm512_loadu_ps(v0 + 16), _mm512_loadu_ps(v1 + 16));
+                v0 += 32; v1 += 32; k--;
+                dot_prefetch2(pf, v0, v1, 32);
+            }
+            sum_pd = avx512_add_ps_pd(sum_pd, s0);
+            sum_pd = avx512_add_ps_pd(sum_pd, s1);
+            sum_pd = avx512_add_ps_pd(sum_pd, _mm512_add_ps(c0, c1));
+        }
+        sum = _mm512_reduce_add_pd(sum_pd);
+    }
+    if (n > 0) { sum += cpu_dot32_compensated(v0, 1, v1, 1, n); }
+    return sum;
+}
+
+#pragma float_control(pop)
+
 static fp64_t avx512_dot64(const fp64_t* restrict v0, const fp64_t* restrict v1, int64_t n) {
+    const dot_prefetch_t pf = dot_prefetch_of(n * 16);
     fp64_t sum = 0;
     if (n >= 8) {
-        f64x8_t mul_add_f64x8 = _mm512_setzero_pd(); // multiply and add
+        // independent accumulators hide FMA latency:
+        f64x8_t mul_add0 = _mm512_setzero_pd();
+        f64x8_t mul_add1 = _mm512_setzero_pd();
+        f64x8_t mul_add2 = _mm512_setzero_pd();
+        f64x8_t mul_add3 = _mm512_setzero_pd();
+        while (n >= 32) {
+            mul_add0 = _mm512_fmadd_pd(_mm512_loadu_pd(v0),
+                _mm512_loadu_pd(v1), mul_add0);
+            mul_add1 = _mm512_fmadd_pd(_mm512_loadu_pd(v0 + 8),
+                _mm512_loadu_pd(v1 + 8), mul_add1);
+            mul_add2 = _mm512_fmadd_pd(_mm512_loadu_pd(v0 + 16),
+                _mm512_loadu_pd(v1 + 16), mul_add2);
+            mul_add3 = _mm512_fmadd_pd(_mm512_loadu_pd(v0 + 24),
+                _mm512_loadu_pd(v1 + 24), mul_add3);
+            n -= 32; v0 += 32; v1 += 32;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 32); }
+        }
         while (n >= 8) {
-            f64x8_t a = _mm512_loadu_pd(v0); // f64x8
-            f64x8_t b = _mm512_loadu_pd(v1); // f64x8
-            n -= 8; v0 +=8; v1 += 8;
-            if (n > 0) { prefetch2_L1L2L3(v0, v1); }
-            mul_add_f64x8 = _mm512_fmadd_pd(a, b, mul_add_f64x8);
+            mul_add0 = _mm512_fmadd_pd(_mm512_loadu_pd(v0),
+                _mm512_loadu_pd(v1), mul_add0);
+            n -= 8; v0 += 8; v1 += 8;
         }
-        sum = _mm512_reduce_add_pd(mul_add_f64x8);
+        f64x8_t mul_add = _mm512_add_pd(_mm512_add_pd(mul_add0, mul_add1),
+                                _mm512_add_pd(mul_add2, mul_add3));
+        sum = _mm512_reduce_add_pd(mul_add);
     }
     if (n > 0) { sum += cpu_dot64_c(v0, v1, n); }
     return sum;
 }
 
+static void avx512_dot32x16_x4(const fp32_t* restrict v, const fp16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs) {
+    const fp16_t* r0 = mx;
+    const fp16_t* r1 = r0 + stride;
+    const fp16_t* r2 = r1 + stride;
+    const fp16_t* r3 = r2 + stride;
+    f32x16_t mul_add0 = _mm512_setzero_ps();
+    f32x16_t mul_add1 = _mm512_setzero_ps();
+    f32x16_t mul_add2 = _mm512_setzero_ps();
+    f32x16_t mul_add3 = _mm512_setzero_ps();
+    int64_t i = 0;
+    while (i + 16 <= n) {
+        f32x16_t a = _mm512_loadu_ps(v + i); // loaded once for 4 rows
+        mul_add0 = _mm512_fmadd_ps(a, avx512_load_fp16(r0 + i), mul_add0);
+        mul_add1 = _mm512_fmadd_ps(a, avx512_load_fp16(r1 + i), mul_add1);
+        mul_add2 = _mm512_fmadd_ps(a, avx512_load_fp16(r2 + i), mul_add2);
+        mul_add3 = _mm512_fmadd_ps(a, avx512_load_fp16(r3 + i), mul_add3);
+        i += 16;
+    }
+    fp64_t s0 = _mm512_reduce_add_ps(mul_add0);
+    fp64_t s1 = _mm512_reduce_add_ps(mul_add1);
+    fp64_t s2 = _mm512_reduce_add_ps(mul_add2);
+    fp64_t s3 = _mm512_reduce_add_ps(mul_add3);
+    if (i < n) {
+        s0 += cpu_dot32x16_c(v + i, r0 + i, n - i);
+        s1 += cpu_dot32x16_c(v + i, r1 + i, n - i);
+        s2 += cpu_dot32x16_c(v + i, r2 + i, n - i);
+        s3 += cpu_dot32x16_c(v + i, r3 + i, n - i);
+    }
+    rs[0] = (fp32_t)s0; rs[1] = (fp32_t)s1; rs[2] = (fp32_t)s2; rs[3] = (fp32_t)s3;
+}
+
+static void avx512_dot32x16bf_x4(const fp32_t* restrict v, const bf16_t* restrict mx,
+        int64_t stride, int64_t n, fp32_t* rs) {
+    const bf16_t* r0 = mx;
+    const bf16_t* r1 = r0 + stride;
+    const bf16_t* r2 = r1 + stride;
+    const bf16_t* r3 = r2 + stride;
+    f32x16_t mul_add0 = _mm512_setzero_ps();
+    f32x16_t mul_add1 = _mm512_setzero_ps();
+    f32x16_t mul_add2 = _mm512_setzero_ps();
+    f32x16_t mul_add3 = _mm512_setzero_ps();
+    int64_t i = 0;
+    while (i + 16 <= n) {
+        f32x16_t a = _mm512_loadu_ps(v + i); // loaded once for 4 rows
+        mul_add0 = _mm512_fmadd_ps(a, avx512_load_bf16(r0 + i), mul_add0);
+        mul_add1 = _mm512_fmadd_ps(a, avx512_load_bf16(r1 + i), mul_add1);
+        mul_add2 = _mm512_fmadd_ps(a, avx512_load_bf16(r2 + i), mul_add2);
+        mul_add3 = _mm512_fmadd_ps(a, avx512_load_bf16(r3 + i), mul_add3);
+        i += 16;
+    }
+    fp64_t s0 = _mm512_reduce_add_ps(mul_add0);
+    fp64_t s1 = _mm512_reduce_add_ps(mul_add1);
+    fp64_t s2 = _mm512_reduce_add_ps(mul_add2);
+    fp64_t s3 = _mm512_reduce_add_ps(mul_add3);
+    if (i < n) {
+        s0 += cpu_dot32x16bf_c(v + i, r0 + i, n - i);
+        s1 += cpu_dot32x16bf_c(v + i, r1 + i, n - i);
+        s2 += cpu_dot32x16bf_c(v + i, r2 + i, n - i);
+        s3 += cpu_dot32x16bf_c(v + i, r3 + i, n - i);
+    }
+    rs[0] = (fp32_t)s0; rs[1] = (fp32_t)s1; rs[2] = (fp32_t)s2; rs[3] = (fp32_t)s3;
+}
+
+// Native AVX512_BF16 and AVX512_FP16 kernels (Cooper Lake, Sapphire Rapids):
+
+static inline f16x32_t avx512_load_bh(const bf16_t* p) { // 32 x bf16
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _mm512_loadu_si512(p); // MSVC: __m512bh is __m512i
+#else
+    return (f16x32_t)_mm512_loadu_si512(p);
+#endif
+}
+
+static fp64_t avx512_dot16bf_native(const bf16_t* restrict v0,
+        const bf16_t* restrict v1, int64_t n) {
+    // vdpbf16ps: 32 bf16 products per instruction accumulated in fp32
+    const dot_prefetch_t pf = dot_prefetch_of(n * 4);
+    fp64_t sum = 0;
+    if (n >= 32) {
+        f32x16_t mul_add0 = _mm512_setzero_ps();
+        f32x16_t mul_add1 = _mm512_setzero_ps();
+        f32x16_t mul_add2 = _mm512_setzero_ps();
+        f32x16_t mul_add3 = _mm512_setzero_ps();
+        while (n >= 128) {
+            mul_add0 = _mm512_dpbf16_ps(mul_add0, avx512_load_bh(v0),
+                avx512_load_bh(v1));
+            mul_add1 = _mm512_dpbf16_ps(mul_add1, avx512_load_bh(v0 + 32),
+                avx512_load_bh(v1 + 32));
+            mul_add2 = _mm512_dpbf16_ps(mul_add2, avx512_load_bh(v0 + 64),
+                avx512_load_bh(v1 + 64));
+            mul_add3 = _mm512_dpbf16_ps(mul_add3, avx512_load_bh(v0 + 96),
+                avx512_load_bh(v1 + 96));
+            n -= 128; v0 += 128; v1 += 128;
+            if (n > 0) { dot_prefetch2(pf, v0, v1, 128); }
+        }
+        while (n >= 32) {
+            mul_add0 = _mm512_dpbf16_ps(mul_add0, avx512_load_bh(v0),
+                avx512_load_bh(v1));
+            n -= 32; v0 += 32; v1 += 32;
+        }
+        f32x16_t mul_add = _mm512_add_ps(_mm512_add_ps(mul_add0, mul_add1),
+                                _mm512_add_ps(mul_add2, mul_add3));
+        sum = _mm512_reduce_add_ps(mul_add);
+    }
+    if (n > 0) { sum += avx512_dot16bf(v0, v1, n); }
+    return sum;
+}
+
+static inline f32x16_t avx512_fp16_lo(h16x32_t v) { // [0..15] -> fp32
+    return _mm512_cvtxph_ps(_mm512_castph512_ph256(v));
+}
+
+static inline f32x16_t avx512_fp16_hi(h16x32_t v) { // [16..31] -> fp32
+    return _mm512_cvtxph_ps(_mm256_castsi256_ph(
+        _mm512_extracti64x4_epi64(_mm512_castph_si512(v), 1)));
+}
+
+static fp64_t avx512_dot16_native(const fp16_t* restrict v0,
+        const fp16_t* restrict v1, int64_t n) {
+    // vfmadd231ph: 32 fp16 products per instruction accumulated in fp16.
+    // fp16 has 11 bits of precision and overflows at 65504: partial sums
+    // are flushed into fp32 accumulators after at most 4 products per lane.
+    // Results are within ~2^-9 relative of fp32 accumulation.
+    enum { flush = 4 };
+    const dot_prefetch_t pf = dot_prefetch_of(n * 4);
+    fp64_t sum = 0;
+    if (n >= 32) {
+        f32x16_t sum0 = _mm512_setzero_ps();
+        f32x16_t sum1 = _mm512_setzero_ps();
+        while (n >= 32) {
+            h16x32_t mul_add0 = _mm512_setzero_ph();
+            h16x32_t mul_add1 = _mm512_setzero_ph();
+            int k = 0;
+            while (n >= 64 && k < flush) {
+                mul_add0 = _mm512_fmadd_ph(_mm512_loadu_ph(v0),
+                    _mm512_loadu_ph(v1), mul_add0);
+                mul_add1 = _mm512_fmadd_ph(_mm512_loadu_ph(v0 + 32),
+                    _mm512_loadu_ph(v1 + 32), mul_add1);
+                n -= 64; v0 += 64; v1 += 64; k++;
+            }
+            if (k == 0) { // 32 <= n < 64
+                mul_add0 = _mm512_fmadd_ph(_mm512_loadu_ph(v0),
+                    _mm512_loadu_ph(v1), mul_add0);
+                n -= 32; v0 += 32; v1 += 32;
+            }
+            if (n > 0) { dot_prefetch2(pf, v0, v1, k > 0 ? k * 64 : 32); }
+            sum0 = _mm512_add_ps(sum0, avx512_fp16_lo(mul_add0));
+            sum1 = _mm512_add_ps(sum1, avx512_fp16_hi(mul_add0));
+            sum0 = _mm512_add_ps(sum0, avx512_fp16_lo(mul_add1));
+            sum1 = _mm512_add_ps(sum1, avx512_fp16_hi(mul_add1));
+        }
+        sum = _mm512_reduce_add_ps(_mm512_add_ps(sum0, sum1));
+    }
+    if (n > 0) { sum += avx512_dot16(v0, v1, n); }
+    return sum;
+}
+
+// Q8 AVX512_VNNI: two 32 bytes blocks per 512-bit register
+
+static inline __m512i avx512_load_q8x2(const q8_t* v) {
+    return _mm512_inserti64x4(_mm512_castsi256_si512(
+        _mm256_loadu_si256((void*)v[0].q)),
+        _mm256_loadu_si256((void*)v[1].q), 1);
+}
+
+static fp64_t avx512_dotq8(const q8_t* restrict v0, const q8_t* restrict v1,
+        int64_t blocks) {
+    const dot_prefetch_t pf = dot_prefetch_of(blocks * 2 * (int64_t)sizeof(q8_t));
+    f32x16_t mul_add = _mm512_setzero_ps();
+    while (blocks >= 2) {
+        __m512i a = avx512_load_q8x2(v0);
+        __m512i b = avx512_load_q8x2(v1);
+        // |a| * (b * sign(a)): avx512 has no vpsignb
+        __m512i ax = _mm512_abs_epi8(a);
+        __m512i sy = _mm512_mask_sub_epi8(b, _mm512_movepi8_mask(a),
+                                          _mm512_setzero_si512(), b);
+        __m512i d = _mm512_dpbusd_epi32(_mm512_setzero_si512(), ax, sy);
+        f32x16_t scale = _mm512_mask_blend_ps(0xFF00,
+            _mm512_set1_ps(avx2_q8_scale(&v0[0], &v1[0])),
+            _mm512_set1_ps(avx2_q8_scale(&v0[1], &v1[1])));
+        mul_add = _mm512_fmadd_ps(_mm512_cvtepi32_ps(d), scale, mul_add);
+        blocks -= 2; v0 += 2; v1 += 2;
+        if (blocks > 0) { dot_prefetch2(pf, v0, v1, 2); }
+    }
+    fp64_t sum = _mm512_reduce_add_ps(mul_add);
+    if (blocks > 0) { sum += cpu_dotq8_c(v0, v1, blocks); }
+    return sum;
+}
+
+// Q4 AVX512: a block of 32 nibbles is two 16 x fp32 registers
+
+static inline f32x16_t avx512_i8x16_ps(__m128i i8) {
+    return _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(i8));
+}
+
+static fp64_t avx512_dot32xq4(const fp32_t* restrict v, const q4_t* restrict q,
+        int64_t blocks) {
+    const dot_prefetch_t pf = dot_prefetch_of(
+        blocks * (int64_t)(q4_block * sizeof(fp32_t) + sizeof(q4_t)));
+    const __m128i eight = _mm_set1_epi8(8);
+    f32x16_t mul_add0 = _mm512_setzero_ps();
+    f32x16_t mul_add1 = _mm512_setzero_ps();
+    while (blocks > 0) {
+        __m128i lo, hi;
+        avx2_unpack_q4(q->q, &lo, &hi);
+        f32x16_t d0 = _mm512_mul_ps(avx512_i8x16_ps(_mm_sub_epi8(lo, eight)),
+                                    _mm512_loadu_ps(v));
+        f32x16_t d1 = _mm512_mul_ps(avx512_i8x16_ps(_mm_sub_epi8(hi, eight)),
+                                    _mm512_loadu_ps(v + 16));
+        const f32x16_t scale = _mm512_set1_ps(_cvtsh_ss(q->scale.bytes));
+        mul_add0 = _mm512_fmadd_ps(d0, scale, mul_add0);
+        mul_add1 = _mm512_fmadd_ps(d1, scale, mul_add1);
+        blocks--; q++; v += q4_block;
+        if (blocks > 0) { dot_prefetch2n(pf, v, q4_block, q, 1); }
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(mul_add0, mul_add1));
+}
+
+static fp64_t avx512_dot32xq4m(const fp32_t* restrict v, const q4m_t* restrict q,
+        int64_t blocks) {
+    const dot_prefetch_t pf = dot_prefetch_of(
+        blocks * (int64_t)(q4_block * sizeof(fp32_t) + sizeof(q4m_t)));
+    f32x16_t mul_add0 = _mm512_setzero_ps();
+    f32x16_t mul_add1 = _mm512_setzero_ps();
+    while (blocks > 0) {
+        __m128i lo, hi;
+        avx2_unpack_q4(q->q, &lo, &hi);
+        const f32x16_t v0 = _mm512_loadu_ps(v);
+        const f32x16_t v1 = _mm512_loadu_ps(v + 16);
+        f32x16_t d = _mm512_fmadd_ps(avx512_i8x16_ps(hi), v1,
+                     _mm512_mul_ps(avx512_i8x16_ps(lo), v0));
+        mul_add0 = _mm512_fmadd_ps(d, _mm512_set1_ps(_cvtsh_ss(q->scale.bytes)), mul_add0);
+        mul_add1 = _mm512_fmadd_ps(_mm512_add_ps(v0, v1),
+                                   _mm512_set1_ps(_cvtsh_ss(q->min.bytes)), mul_add1);
+        blocks--; q++; v += q4_block;
+        if (blocks > 0) { dot_prefetch2n(pf, v, q4_block, q, 1); }
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(mul_add0, mul_add1));
+}
+
+// Strided AVX512: same as AVX2 above with 16 lanes
+
+static inline __m512i avx512_stride_index(int64_t s) {
+    return _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+        8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32((int32_t)s));
+}
+
+static inline f32x16_t avx512_gather_fp32(const fp32_t* p, int64_t s, __m512i ix) {
+    return s == 1 ? _mm512_loadu_ps(p) : _mm512_i32gather_ps(ix, p, 4);
+}
+
+static inline f32x16_t avx512_gather_fp16(const fp16_t* p, int64_t s, __m512i ix) {
+    if (s == 1) { return avx512_load_fp16(p); }
+    return _mm512_cvtph_ps(_mm512_cvtepi32_epi16(_mm512_i32gather_epi32(ix, p, 2)));
+}
+
+static inline f32x16_t avx512_gather_bf16(const bf16_t* p, int64_t s, __m512i ix) {
+    if (s == 1) { return avx512_load_bf16(p); }
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_i32gather_epi32(ix, p, 2), 16));
+}
+
+#pragma push_macro("avx512_dot_s_kernel")
+
+#define avx512_dot_s_kernel(name, t0, t1, gather0, gather1, tail)           \
+static fp64_t name(const t0* restrict v0, int64_t s0,                         \
+        const t1* restrict v1, int64_t s1, int64_t n) {                       \
+    const __m512i ix0 = avx512_stride_index(s0);                              \
+    const __m512i ix1 = avx512_stride_index(s1);                              \
+    f32x16_t mul_add0 = _mm512_setzero_ps();                                  \
+    f32x16_t mul_add1 = _mm512_setzero_ps();                                  \
+    while (n > 32) {                                                          \
+        mul_add0 = _mm512_fmadd_ps(gather0(v0, s0, ix0),                      \
+                                   gather1(v1, s1, ix1), mul_add0);           \
+        mul_add1 = _mm512_fmadd_ps(gather0(v0 + 16 * s0, s0, ix0),            \
+                                   gather1(v1 + 16 * s1, s1, ix1), mul_add1); \
+        v0 += 32 * s0; v1 += 32 * s1; n -= 32;                                \
+    }                                                                         \
+    if (n > 16) {                                                             \
+        mul_add0 = _mm512_fmadd_ps(gather0(v0, s0, ix0),                      \
+                                   gather1(v1, s1, ix1), mul_add0);           \
+        v0 += 16 * s0; v1 += 16 * s1; n -= 16;                                \
+    }                                                                         \
+    return _mm512_reduce_add_ps(_mm512_add_ps(mul_add0, mul_add1)) +          \
+           tail(v0, s0, v1, s1, n);                                           \
+}
+
+avx512_dot_s_kernel(avx512_dot16_s,      fp16_t, fp16_t, avx512_gather_fp16, avx512_gather_fp16, cpu_dot16_s)
+avx512_dot_s_kernel(avx512_dot32x16_s,   fp32_t, fp16_t, avx512_gather_fp32, avx512_gather_fp16, cpu_dot32x16_s)
+avx512_dot_s_kernel(avx512_dot16bf_s,    bf16_t, bf16_t, avx512_gather_bf16, avx512_gather_bf16, cpu_dot16bf_s)
+avx512_dot_s_kernel(avx512_dot32x16bf_s, fp32_t, bf16_t, avx512_gather_fp32, avx512_gather_bf16, cpu_dot32x16bf_s)
+avx512_dot_s_kernel(avx512_dot32_s,      fp32_t, fp32_t, avx512_gather_fp32, avx512_gather_fp32, cpu_dot32_s)
+
+#pragma pop_macro("avx512_dot_s_kernel")
+
+static fp64_t avx512_dot64_s(const fp64_t* restrict v0, int64_t s0,
+        const fp64_t* restrict v1, int64_t s1, int64_t n) {
+    const __m512i ix0 = _mm512_setr_epi64(0, s0, 2 * s0, 3 * s0, 4 * s0, 5 * s0, 6 * s0, 7 * s0);
+    const __m512i ix1 = _mm512_setr_epi64(0, s1, 2 * s1, 3 * s1, 4 * s1, 5 * s1, 6 * s1, 7 * s1);
+    f64x8_t mul_add0 = _mm512_setzero_pd();
+    f64x8_t mul_add1 = _mm512_setzero_pd();
+    while (n >= 16) {
+        mul_add0 = _mm512_fmadd_pd(_mm512_i64gather_pd(ix0, v0, 8),
+                                   _mm512_i64gather_pd(ix1, v1, 8), mul_add0);
+        mul_add1 = _mm512_fmadd_pd(_mm512_i64gather_pd(ix0, v0 + 8 * s0, 8),
+                                   _mm512_i64gather_pd(ix1, v1 + 8 * s1, 8), mul_add1);
+        v0 += 16 * s0; v1 += 16 * s1; n -= 16;
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(mul_add0, mul_add1)) +
+           cpu_dot64_s(v0, s0, v1, s1, n);
+}
+
 // 1. AXV512 on Gen-11 Intel CPU's measures slower then AVX2
 // 2. AVX512-FP16
 // https://cdrdv2-public.intel.com/678970/intel-avx512-fp16.pdf
@@ -619,8 +2493,9 @@ static void avx_init(void) {
         avx.features |= (data[ecx]  & (1U << 28)) != 0 ? avx_f : 0;
 //      println("FP16C   %d", (data[ecx]  & (1U << 29)) != 0);
         // FP16C ^^^ https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html#text=cvtph_ps
-        avx.features |= (data[ecx] & (1U << 9)) != 0 ? avx_fp16c : 0;
+        avx.features |= (data[ecx] & (1U << 29)) != 0 ? avx_fp16c : 0;
         __cpuidex(data_ex, 7, 0);
+        const uint32_t max_sub_leaf = data_ex[eax];
         // pages ~24-26 of 214
         // Structured Extended Feature Enumeration leaf: 7 sub-leaf: 0
 //      println("max number or sub-leaves of leaf7.0 %d", data_ex[eax]);
@@ -629,6 +2504,7 @@ static void avx_init(void) {
         avx.features |= (data_ex[ebx] & (1U << 5))  != 0 ? avx2_f : 0;
 //      println("AVX512_F             %d", (data_ex[ebx] & (1U << 16)) != 0);
         avx.features |= (data_ex[ebx] & (1U << 16)) != 0 ? avx512_f : 0;
+        avx.features |= (data_ex[ebx] & (1U << 30)) != 0 ? avx512_bw : 0;
 //      println("AVX512_DQ            %d", (data_ex[ebx] & (1U << 17)) != 0);
 //      println("AVX512_IFMA          %d", (data_ex[ebx] & (1U << 21)) != 0);
 //      println("AVX512_PF            %d", (data_ex[ebx] & (1U << 26)) != 0); // Xenon Phi only
@@ -647,18 +2523,23 @@ static void avx_init(void) {
 //      println("AVX512_4FMAPS        %d", (data_ex[edx] & (1U << 3))  != 0);
 //      println("AVX512_VP2INTERSECT  %d", (data_ex[edx] & (1U << 8))  != 0);
 //      println("AVX512_FP16          %d", (data_ex[edx] & (1U << 23)) != 0);
-        avx.features |= (data_ex[eax] & (1U <<  5)) != 0 ? avx512_bf16 : 0;
+        avx.features |= (data_ex[edx] & (1U << 23)) != 0 ? avx512_fp16 : 0;
         avx.features |= (data_ex[ebx] & (1U << 31)) != 0 ? avx512_vl   : 0;
         avx.features |= (data_ex[ecx] & (1U << 11)) != 0 ? avx512_vnni : 0;
         // pages ~27 of 214
         // Structured Extended Feature Enumeration leaf: 7 sub-leaf: 1
-        __cpuidex(data_ex, 7, 1);
+        if (max_sub_leaf >= 1) {
+            __cpuidex(data_ex, 7, 1);
+        } else {
+            memset(data_ex, 0, sizeof(data_ex));
+        }
 //      println("max number or sub-leaves of leaf7.1 %d", data_ex[eax]);
         // AVX_VNNI integer dot() products
         // https://www.intel.com/content/www/us/en/docs/intrinsics-guide/index.html#text=AVX_VNNI
 //      println("AVX_VNNI             %d", (data_ex[eax] & (1U << 4))  != 0);
+        avx.features |= (data_ex[eax] & (1U <<  4)) != 0 ? avx_vnni : 0;
 //      println("AVX512_BF16          %d", (data_ex[eax] & (1U << 5))  != 0);
-        avx.features |= (data_ex[edx] & (1U << 23)) != 0 ? avx512_fp16 : 0;
+        avx.features |= (data_ex[eax] & (1U <<  5)) != 0 ? avx512_bf16 : 0;
     }
     // currently dot() benefits from AVX512_BF16, AVX512_FP16, and AVX512_VL
 //  if (avx_fp16c   & avx.features) { println("FP16C"); }
@@ -668,6 +2549,7 @@ static void avx_init(void) {
 //  if (avx512_fp16 & avx.features) { println("AVX512_FP16"); }
 //  if (avx512_vl   & avx.features) { println("AVX512_VL"); }
 //  if (avx512_vnni & avx.features) { println("AVX512_VNNI"); }
+//  if (avx512_bw   & avx.features) { println("AVX512_BW"); }
 }
 
 #pragma push_macro("avx_try_and_set")
@@ -689,6 +2571,24 @@ static void avx2_init(void) {
         avx_try_and_set(fp64_t, 8, avx2, dot64);
         if (avx2.dot16   != null) { avx2.dot32x16   = avx2_dot32x16; }
         if (avx2.dot16bf != null) { avx2.dot32x16bf = avx2_dot32x16bf; }
+        if (avx2.dot16   != null) { avx2.dot32x16_x4   = avx2_dot32x16_x4; }
+        if (avx2.dot16bf != null) { avx2.dot32x16bf_x4 = avx2_dot32x16bf_x4; }
+        if (avx2.dot16   != null) { avx2.dot16_s      = avx2_dot16_s; }
+        if (avx2.dot16   != null) { avx2.dot32x16_s   = avx2_dot32x16_s; }
+        if (avx2.dot16bf != null) { avx2.dot16bf_s    = avx2_dot16bf_s; }
+        if (avx2.dot16bf != null) { avx2.dot32x16bf_s = avx2_dot32x16bf_s; }
+        if (avx2.dot32   != null) { avx2.dot32_s      = avx2_dot32_s; }
+        if (avx2.dot64   != null) { avx2.dot64_s      = avx2_dot64_s; }
+        if (avx2.dot32   != null) { avx2.dot32_compensated = avx2_dot32_compensated; }
+        if (avx2.dot16 != null) { // F16C for q8 scales
+            avx2.dotq8 = avx_vnni & avx.features ? avx2_dotq8_vnni : avx2_dotq8;
+            avx2.quantize_q8 = avx2_quantize_q8;
+            avx2.dot32xq4  = avx2_dot32xq4;
+            avx2.dot32xq4m = avx2_dot32xq4m;
+            const bool vnni = (avx_vnni & avx.features) != 0;
+            avx2.dotq8xq4  = vnni ? avx2_dotq8xq4_vnni  : avx2_dotq8xq4;
+            avx2.dotq8xq4m = vnni ? avx2_dotq8xq4m_vnni : avx2_dotq8xq4m;
+        }
     }
 }
 
@@ -700,19 +2600,148 @@ static void avx512_init(void) {
         avx_try_and_set(fp64_t, 8, avx512, dot64);
         if (avx512.dot16   != null) { avx512.dot32x16   = avx2_dot32x16; }
         if (avx512.dot16bf != null) { avx512.dot32x16bf = avx2_dot32x16bf; }
+        if (avx512.dot16   != null) { avx512.dot32x16_x4   = avx512_dot32x16_x4; }
+        if (avx512.dot16bf != null) { avx512.dot32x16bf_x4 = avx512_dot32x16bf_x4; }
+        if (avx512.dot16   != null) { avx512.dot16_s      = avx512_dot16_s; }
+        if (avx512.dot16   != null) { avx512.dot32x16_s   = avx512_dot32x16_s; }
+        if (avx512.dot16bf != null) { avx512.dot16bf_s    = avx512_dot16bf_s; }
+        if (avx512.dot16bf != null) { avx512.dot32x16bf_s = avx512_dot32x16bf_s; }
+        if (avx512.dot32   != null) { avx512.dot32_s      = avx512_dot32_s; }
+        if (avx512.dot64   != null) { avx512.dot64_s      = avx512_dot64_s; }
+        if (avx512.dot32   != null) { avx512.dot32_compensated = avx512_dot32_compensated; }
+        // dot32x16 and dot32x16bf need fp32 precision for the v0 vector
+        // thus only bf16 x bf16 and fp16 x fp16 have native kernels.
+        // vdpbf16ps accumulates in fp32 and replaces avx512.dot16bf but
+        // vfmadd231ph accumulates in fp16 and is opt-in dot.fp16_native():
+        // both only when the probes above succeeded (OS saved AVX512 state):
+        if (avx512.dot16bf != null && (avx512_bf16 & avx.features)) {
+            avx512.dot16bf = avx512_dot16bf_native;
+        }
+        if (avx512.dot16 != null && (avx512_fp16 & avx.features)) {
+            avx512.dot16_native = avx512_dot16_native;
+        }
+        // avx512_dotq8 needs AVX512_BW for _mm512_abs_epi8/_mm512_movepi8_mask:
+        const uint32_t q8 = avx512_vnni | avx512_bw;
+        if (avx512.dot32 != null && (q8 & avx.features) == q8) {
+            avx512.dotq8 = avx512_dotq8;
+        }
+        if (avx512.dot16 != null) { // F16C for q4 scales
+            avx512.dot32xq4  = avx512_dot32xq4;
+            avx512.dot32xq4m = avx512_dot32xq4m;
+        }
     }
 }
 
 #pragma pop_macro("avx_try_and_set")
 
+typedef fp64_t (*dot_kernel_t)(const void* v0, const void* v1, int64_t n);
+
+static void dot_calibrate_flush(const uint8_t* p, int64_t bytes) {
+    for (int64_t i = 0; i < bytes; i += dot_cache_line) { _mm_clflush(p + i); }
+    _mm_mfence();
+}
+
+static fp64_t dot_calibrate_time(dot_kernel_t f, const uint8_t* v0,
+        const uint8_t* v1, int64_t n, int32_t repeat, int64_t flush) {
+    fp64_t best = DBL_MAX;
+    for (int32_t i = 0; i < 3; i++) {
+        if (flush > 0) { dot_calibrate_flush(v0, flush); }
+        fp64_t sum = 0;
+        fp64_t t = seconds();
+        for (int32_t r = 0; r < repeat; r++) { sum += f(v0, v1, n); }
+        best = min(best, seconds() - t);
+        fatal_if(sum != 0); // zeros, prevents optimizing out
+    }
+    return best;
+}
+
+static void dot_calibrate_measure(uint8_t* memory, int64_t size) {
+    const dot_kernel_t k2[dot_types] = {
+        (dot_kernel_t)avx2.dot16,   (dot_kernel_t)avx2.dot32x16,
+        (dot_kernel_t)avx2.dot16bf, (dot_kernel_t)avx2.dot32x16bf,
+        (dot_kernel_t)avx2.dot32,   (dot_kernel_t)avx2.dot64
+    };
+    const dot_kernel_t k512[dot_types] = {
+        (dot_kernel_t)avx512.dot16,   (dot_kernel_t)avx512.dot32x16,
+        (dot_kernel_t)avx512.dot16bf, (dot_kernel_t)avx512.dot32x16bf,
+        (dot_kernel_t)avx512.dot32,   (dot_kernel_t)avx512.dot64
+    };
+    const int64_t bytes0[dot_types] = { 2, 4, 2, 4, 4, 8 }; // sizeof(v0[0])
+    const int64_t bytes1[dot_types] = { 2, 2, 2, 2, 4, 8 }; // sizeof(v1[0])
+    // both vectors bytes and repeat count to make L1 and L2 measurements
+    // long enough for the timer. RAM tier vectors are flushed from all
+    // cache levels before each run instead of being bigger than L3:
+    const int64_t bytes[dot_tiers]  = { 8 * 1024, 256 * 1024, size };
+    const int32_t repeat[dot_tiers] = { 512, 16, 1 };
+    for (int32_t t = 0; t < dot_types; t++) {
+        // avx512.dot32x16 and avx512.dot32x16bf may be AVX2 kernels
+        if (k2[t] != null && k512[t] != null && k2[t] != k512[t]) {
+            for (int32_t tier = 0; tier < dot_tiers; tier++) {
+                const int64_t n = bytes[tier] / (bytes0[t] + bytes1[t]) / 16 * 16;
+                const uint8_t* v0 = memory;
+                const uint8_t* v1 = memory + n * bytes0[t];
+                const int64_t flush = tier == dot_ram ? size : 0;
+                const fp64_t t2   = dot_calibrate_time(k2[t],   v0, v1, n, repeat[tier], flush);
+                const fp64_t t512 = dot_calibrate_time(k512[t], v0, v1, n, repeat[tier], flush);
+                // 5% hysteresis: measurements noise must not flip default
+                dot_calibration.avx2[t][tier] = t2 < t512 * 0.95;
+            }
+        }
+    }
+}
+
+static bool dot_calibration_load(const char* fn) {
+    dot_calibration_t c = {0};
+    FILE* f = fopen(fn, "rb");
+    bool loaded = false;
+    if (f != null) {
+        loaded = fread(&c, sizeof(c), 1, f) == 1 && c.magic == dot_calibration_magic &&
+                 c.features == avx.features;
+        fclose(f);
+    }
+    if (loaded) { dot_calibration = c; }
+    return loaded;
+}
+
+static void dot_calibration_save(const char* fn) {
+    FILE* f = fopen(fn, "wb");
+    if (f != null) {
+        if (fwrite(&dot_calibration, sizeof(dot_calibration), 1, f) != 1) {
+            println("failed to write \"%s\"", fn);
+        }
+        fclose(f);
+    }
+}
+
+static void dot_calibrate(void) {
+    dot_calibration = dot_calibration_default;
+    dot_calibration.features = avx.features;
+    const char* fn = getenv("DOT_CALIBRATION");
+    const bool off = fn == null || fn[0] == 0 ||
+                     strcmp(fn, "off") == 0 || strcmp(fn, "0") == 0;
+    const bool on  = !off && (strcmp(fn, "on") == 0 || strcmp(fn, "1") == 0);
+    const bool cached = !off && !on && dot_calibration_load(fn);
+    if (!off && !cached && avx2.dot32 != null && avx512.dot32 != null) {
+        // 4MB is beyond dot_l2 tier and, flushed, is read from RAM:
+        enum { bytes = 4 * 1024 * 1024 };
+        uint8_t* memory = (uint8_t*)calloc(1, bytes); // zeros: valid for all types
+        if (memory != null) {
+            memset(&dot_calibration.avx2, 0, sizeof(dot_calibration.avx2));
+            dot_calibrate_measure(memory, bytes);
+            free(memory);
+            if (!on) { dot_calibration_save(fn); }
+        }
+    }
+}
+
 #define DOT_TEST // TODO: undefine and save memory
 // #undef DOT_TEST
 
 #ifdef DOT_TEST
 
 static void test_dot16bf_c() {
-    bf16_t a[21];
-    bf16_t b[21];
+    bf16_t a[133];
+    bf16_t b[133];
     for (int i = 0; i < countof(a); i++) {
         a[i] = bf32to16((fp32_t)(i + 1));
         b[i] = bf32to16((fp32_t)(countof(a) - i));
@@ -740,8 +2769,8 @@ static void test_dot16bf_c() {
 }
 
 static void test_dot32x16bf_c() {
-    fp32_t a[21];
-    bf16_t b[21];
+    fp32_t a[133];
+    bf16_t b[133];
     for (int i = 0; i < countof(a); i++) {
         a[i] = (fp32_t)(i + 1);
         b[i] = bf32to16((fp32_t)(countof(a) - i));
@@ -769,8 +2798,8 @@ static void test_dot32x16bf_c() {
 }
 
 static void test_dot16_c() {
-    fp16_t a[21];
-    fp16_t b[21];
+    fp16_t a[133];
+    fp16_t b[133];
     for (int i = 0; i < countof(a); i++) {
         a[i] = fp32to16((fp32_t)(i + 1));
         b[i] = fp32to16((fp32_t)(countof(a) - i));
@@ -794,12 +2823,21 @@ static void test_dot16_c() {
                 "cpu: %.16f avx: %.16f delta: %.16e FLT_EPSILON: %.16e",
                 sum0, sum2, sum0 - sum2, FLT_EPSILON);
         }
+        if (avx512.dot16_native != null) {
+            fp64_t sum3 = avx512.dot16_native(a, b, n);
+            // native AVX512_FP16 kernel rounds products and partial sums
+            // to fp16 (epsilon 2^-10, 4 products per lane before flush):
+            const fp64_t epsilon = sum * 5 * 0.0009765625;
+            fatal_if(fabs(sum3 - sum0) > epsilon,
+                "cpu: %.16f avx: %.16f delta: %.16e epsilon: %.16e",
+                sum0, sum3, sum0 - sum3, epsilon);
+        }
     }
 }
 
 static void test_dot32x16_c() {
-    fp32_t a[21];
-    fp16_t b[21];
+    fp32_t a[133];
+    fp16_t b[133];
     for (int i = 0; i < countof(a); i++) {
         a[i] = (fp32_t)(i + 1);
         b[i] = fp32to16((fp32_t)(countof(a) - i));
@@ -827,8 +2865,8 @@ static void test_dot32x16_c() {
 }
 
 static void test_dot32_c() {
-    fp32_t a[21];
-    fp32_t b[21];
+    fp32_t a[133];
+    fp32_t b[133];
     for (int i = 0; i < countof(a); i++) {
         a[i] = (fp32_t)(i + 1);
         b[i] = (fp32_t)(countof(a) - i);
@@ -856,8 +2894,8 @@ static void test_dot32_c() {
 }
 
 static void test_dot64_c() {
-    fp64_t a[21];
-    fp64_t b[21];
+    fp64_t a[133];
+    fp64_t b[133];
     for (int i = 0; i < countof(a); i++) {
         a[i] = (fp64_t)(i + 1);
         b[i] = (fp64_t)(countof(a) - i);
@@ -884,6 +2922,392 @@ static void test_dot64_c() {
     }
 }
 
+static void test_dot32_compensated() {
+    // integer products up to 2^25 are not exact in fp32 but they and their
+    // sums are exact in fp64 thus cpu_dot32_compensated() result is exact:
+    enum { n = 4 * 1024 * 1024 + 7 };
+    fp32_t* a = (fp32_t*)malloc(n * sizeof(fp32_t));
+    fp32_t* b = (fp32_t*)malloc(n * sizeof(fp32_t));
+    if (a != null && b != null) {
+        for (int i = 0; i < n; i++) {
+            a[i] = (fp32_t)(4097 + i % 7);
+            b[i] = (fp32_t)(i % 2 == 0 ? 4099 - i % 5 : -4093 - i % 3);
+        }
+        const fp64_t exact = cpu_dot32_compensated(a, 1, b, 1, n);
+        const fp64_t fp32 = dot32_c(a, b, n);
+        fp64_t t = seconds();
+        const fp64_t dot2 = dot32_compensated(a, 1, b, 1, n);
+        t = seconds() - t;
+        const fp64_t e_fp32 = fabs(fp32 - exact) / fabs(exact);
+        const fp64_t e_dot2 = fabs(dot2 - exact) / fabs(exact);
+        println("n: %d relative error fp32: %.3e compensated: %.3e %.3fms",
+                n, e_fp32, e_dot2, t * MSEC_IN_SEC);
+        fatal_if(dot2 != exact);
+        #pragma push_macro("test_compensated")
+        #define test_compensated(kernel) do {                                 \
+            if (kernel != null) {                                             \
+                for (int k = 0; k < 67; k++) { /* tails */                    \
+                    const fp64_t e = cpu_dot32_compensated(a, 1, b, 1, k);    \
+                    fatal_if(kernel(a, b, k) != e, "%s n: %d", #kernel, k);   \
+                }                                                             \
+                fatal_if(kernel(a, b, n) != exact, "%s", #kernel);            \
+            }                                                                 \
+        } while (0)
+        test_compensated(avx2.dot32_compensated);
+        test_compensated(avx512.dot32_compensated);
+        #pragma pop_macro("test_compensated")
+    }
+    free(b);
+    free(a);
+}
+
+static void test_gemv() {
+    // multithreaded gemv must match row by row dot products bit for bit
+    static const int64_t sizes[][2] = { // {n, m}
+        {1, 1}, {7, 3}, {17, 33}, {1024, 1031}, {4099, 257}
+    };
+    uint32_t seed = 0;
+    for (int k = 0; k < countof(sizes); k++) {
+        const int64_t n = sizes[k][0];
+        const int64_t m = sizes[k][1];
+        fp16_t* mx16 = (fp16_t*)malloc(n * m * sizeof(fp16_t));
+        bf16_t* mxbf = (bf16_t*)malloc(n * m * sizeof(bf16_t));
+        fp32_t* mx32 = (fp32_t*)malloc(n * m * sizeof(fp32_t));
+        fp64_t* mx64 = (fp64_t*)malloc(n * m * sizeof(fp64_t));
+        fp16_t* vc16 = (fp16_t*)malloc(n * sizeof(fp16_t));
+        bf16_t* vcbf = (bf16_t*)malloc(n * sizeof(bf16_t));
+        fp32_t* vc32 = (fp32_t*)malloc(n * sizeof(fp32_t));
+        fp64_t* vc64 = (fp64_t*)malloc(n * sizeof(fp64_t));
+        fp32_t* rs32 = (fp32_t*)malloc(m * sizeof(fp32_t));
+        fp64_t* rs64 = (fp64_t*)malloc(m * sizeof(fp64_t));
+        fatal_if(mx16 == null || mxbf == null || mx32 == null || mx64 == null ||
+                 vc16 == null || vcbf == null || vc32 == null || vc64 == null ||
+                 rs32 == null || rs64 == null);
+        for (int64_t i = 0; i < n * m; i++) {
+            mx32[i] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
+            mx64[i] = mx32[i];
+            mx16[i] = fp32to16(mx32[i]);
+            mxbf[i] = bf32to16(mx32[i]);
+        }
+        for (int64_t i = 0; i < n; i++) {
+            vc32[i] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
+            vc64[i] = vc32[i];
+            vc16[i] = fp32to16(vc32[i]);
+            vcbf[i] = bf32to16(vc32[i]);
+        }
+        #pragma push_macro("test_gemv_rows")
+        #define test_gemv_rows(gemv, dot, mx, vc, rs) do {                  \
+            gemv(mx, vc, rs, n, m);                                         \
+            for (int64_t j = 0; j < m; j++) {                               \
+                fatal_if(rs[j] != (fp32_t)dot, "n: %lld m: %lld j: %lld",   \
+                    n, m, j);                                               \
+            }                                                               \
+        } while (0)
+        test_gemv_rows(gemv16, dot16_c(mx16 + j * n, vc16, n),
+            mx16, vc16, rs32);
+        test_gemv_rows(gemv16bf, dot16bf_c(mxbf + j * n, vcbf, n),
+            mxbf, vcbf, rs32);
+        // 4 rows blocked kernels: compare to the same "many" call
+        fp32_t* many = (fp32_t*)malloc(m * sizeof(fp32_t));
+        fatal_if(many == null);
+        dot32x16_many(vc32, mx16, n, many, n, m);
+        test_gemv_rows(gemv32x16, many[j], mx16, vc32, rs32);
+        dot32x16bf_many(vc32, mxbf, n, many, n, m);
+        test_gemv_rows(gemv32x16bf, many[j], mxbf, vc32, rs32);
+        free(many);
+        test_gemv_rows(gemv32, dot32_c(mx32 + j * n, vc32, n),
+            mx32, vc32, rs32);
+        #pragma pop_macro("test_gemv_rows")
+        gemv64(mx64, vc64, rs64, n, m);
+        for (int64_t j = 0; j < m; j++) {
+            fatal_if(rs64[j] != dot64_c(mx64 + j * n, vc64, n));
+        }
+        free(rs64); free(rs32);
+        free(vc64); free(vc32); free(vcbf); free(vc16);
+        free(mx64); free(mx32); free(mxbf); free(mx16);
+    }
+}
+
+static void test_gemv_numa() {
+    // NUMA placed matrices must produce exactly the same results:
+    enum { n = 1024, m = 1030 };
+    fp32_t* mx32 = (fp32_t*)dot_numa_alloc(m, n * sizeof(fp32_t), false);
+    fp16_t* mx16 = (fp16_t*)dot_numa_alloc(m, n * sizeof(fp16_t), true);
+    fp32_t* copy = (fp32_t*)malloc(m * n * sizeof(fp32_t));
+    fp32_t* vc = (fp32_t*)malloc(n * sizeof(fp32_t));
+    fp32_t* r0 = (fp32_t*)malloc(m * sizeof(fp32_t));
+    fp32_t* r1 = (fp32_t*)malloc(m * sizeof(fp32_t));
+    fatal_if(mx32 == null || mx16 == null || copy == null || vc == null ||
+             r0 == null || r1 == null);
+    uint32_t seed = 1;
+    for (int i = 0; i < n; i++) { vc[i] = (random32(&seed) % 64) / 8.0f - 4; }
+    for (int i = 0; i < m * n; i++) {
+        mx32[i] = (random32(&seed) % 64) / 8.0f - 4;
+        copy[i] = mx32[i];
+        mx16[i] = fp32to16(mx32[i]);
+    }
+    gemv32(mx32, vc, r0, n, m);
+    gemv32(copy, vc, r1, n, m);
+    fatal_if(memcmp(r0, r1, m * sizeof(fp32_t)) != 0);
+    gemv32x16(mx16, vc, r0, n, m);
+    dot32x16_many(vc, mx16, n, r1, n, m);
+    fatal_if(memcmp(r0, r1, m * sizeof(fp32_t)) != 0);
+    free(r1);
+    free(r0);
+    free(vc);
+    free(copy);
+    dot_numa_free(mx16);
+    dot_numa_free(mx32);
+}
+
+static void test_gemv_numa_fake() {
+    // 2 fake nodes force row blocks partitioning and gemv_run_numa() on
+    // any machine, results must match a regular matrix bit for bit:
+    enum { n = 1024, m = 1030 };
+    dot_numa_fake_nodes = 2;
+    fp32_t* mx = (fp32_t*)dot_numa_alloc(m, n * sizeof(fp32_t), false);
+    dot_numa_fake_nodes = 0;
+    fp32_t* copy = (fp32_t*)malloc(m * n * sizeof(fp32_t));
+    fp32_t* vc = (fp32_t*)malloc(n * sizeof(fp32_t));
+    fp32_t* r0 = (fp32_t*)malloc(m * sizeof(fp32_t));
+    fp32_t* r1 = (fp32_t*)malloc(m * sizeof(fp32_t));
+    fatal_if(mx == null || copy == null || vc == null || r0 == null || r1 == null);
+    const dot_numa_t* numa = dot_numa_of(mx, m);
+    fatal_if(numa == null || numa->nodes != 2 || numa->rows[1] % 4 != 0);
+    uint32_t seed = 1;
+    for (int i = 0; i < n; i++) { vc[i] = (random32(&seed) % 64) / 8.0f - 4; }
+    for (int i = 0; i < m * n; i++) {
+        mx[i] = (random32(&seed) % 64) / 8.0f - 4;
+        copy[i] = mx[i];
+    }
+    gemv_args_t a = { .mx = mx, .vc = vc, .rs = r0, .n = n, .m = m,
+                      .rows = gemv32_rows };
+    gemv_run_numa(&a, numa, 64 * 1024); // even if cores() == 1
+    gemv32(copy, vc, r1, n, m);
+    fatal_if(memcmp(r0, r1, m * sizeof(fp32_t)) != 0);
+    gemv32(mx, vc, r0, n, m); // gemv_run() dispatch
+    fatal_if(memcmp(r0, r1, m * sizeof(fp32_t)) != 0);
+    free(r1);
+    free(r0);
+    free(vc);
+    free(copy);
+    dot_numa_free(mx);
+    fatal_if(dot_numa_of(mx, m) != null);
+}
+
+static void test_dot_many() {
+    // small integers are exact in fp16/bf16 and their sums are exact in fp32
+    // thus "many" must match dot product row by row for any summation order
+    enum { n = 133, rows = 11 };
+    fp32_t v[n];
+    fp16_t mx16[rows][n];
+    bf16_t mxbf[rows][n];
+    fp32_t rs[rows];
+    for (int i = 0; i < n; i++) { v[i] = (fp32_t)(i % 7 - 3); }
+    for (int j = 0; j < rows; j++) {
+        for (int i = 0; i < n; i++) {
+            mx16[j][i] = fp32to16((fp32_t)((i + j) % 5 - 2));
+            mxbf[j][i] = bf32to16((fp32_t)((i * j) % 9 - 4));
+        }
+    }
+    for (int k = 1; k <= n; k++) {
+        for (int r = 1; r <= rows; r++) {
+            dot32x16_many(v, &mx16[0][0], n, rs, k, r);
+            for (int j = 0; j < r; j++) {
+                fatal_if(rs[j] != cpu_dot32x16_c(v, mx16[j], k),
+                    "n: %d rows: %d row: %d", k, r, j);
+            }
+            dot32x16bf_many(v, &mxbf[0][0], n, rs, k, r);
+            for (int j = 0; j < r; j++) {
+                fatal_if(rs[j] != cpu_dot32x16bf_c(v, mxbf[j], k),
+                    "n: %d rows: %d row: %d", k, r, j);
+            }
+        }
+    }
+}
+
+static void test_dot_strided() {
+    // small integers products and their sums are exact thus gather kernels
+    // must match C strided loops bit for bit
+    enum { n = 133, s = 131 };
+    static fp16_t a16[n * s];
+    static fp16_t b16[n * s];
+    static bf16_t abf[n * s];
+    static bf16_t bbf[n * s];
+    static fp32_t a32[n * s];
+    static fp32_t b32[n * s];
+    static fp64_t a64[n * s];
+    static fp64_t b64[n * s];
+    for (int i = 0; i < n * s; i++) {
+        a32[i] = (fp32_t)(i % 7 - 3);
+        b32[i] = (fp32_t)(i % 5 - 2);
+        a64[i] = a32[i];
+        b64[i] = b32[i];
+        a16[i] = fp32to16(a32[i]);
+        b16[i] = fp32to16(b32[i]);
+        abf[i] = bf32to16(a32[i]);
+        bbf[i] = bf32to16(b32[i]);
+    }
+    static const int64_t strides[][2] = { {1, 2}, {2, 1}, {2, 2}, {3, 4}, {7, 1}, {s, s} };
+    #pragma push_macro("test_dot_s")
+    #define test_dot_s(kernel, cpu, v0, v1) do {                            \
+        if (kernel != null) {                                               \
+            /* last element is at the very end of the v1 array: */          \
+            const fp64_t r = kernel(v0, s0, v1 + n * s - 1 - (k - 1) * s1,  \
+                                    s1, k);                                 \
+            fatal_if(r != cpu(v0, s0, v1 + n * s - 1 - (k - 1) * s1, s1, k),\
+                "%s s0: %lld s1: %lld n: %d", #kernel, s0, s1, k);          \
+        }                                                                   \
+    } while (0)
+    for (int j = 0; j < countof(strides); j++) {
+        const int64_t s0 = strides[j][0];
+        const int64_t s1 = strides[j][1];
+        for (int k = 1; k <= n; k++) {
+            test_dot_s(avx2.dot16_s,        cpu_dot16_s,      a16, b16);
+            test_dot_s(avx2.dot32x16_s,     cpu_dot32x16_s,   a32, b16);
+            test_dot_s(avx2.dot16bf_s,      cpu_dot16bf_s,    abf, bbf);
+            test_dot_s(avx2.dot32x16bf_s,   cpu_dot32x16bf_s, a32, bbf);
+            test_dot_s(avx2.dot32_s,        cpu_dot32_s,      a32, b32);
+            test_dot_s(avx2.dot64_s,        cpu_dot64_s,      a64, b64);
+            test_dot_s(avx512.dot16_s,      cpu_dot16_s,      a16, b16);
+            test_dot_s(avx512.dot32x16_s,   cpu_dot32x16_s,   a32, b16);
+            test_dot_s(avx512.dot16bf_s,    cpu_dot16bf_s,    abf, bbf);
+            test_dot_s(avx512.dot32x16bf_s, cpu_dot32x16bf_s, a32, bbf);
+            test_dot_s(avx512.dot32_s,      cpu_dot32_s,      a32, b32);
+            test_dot_s(avx512.dot64_s,      cpu_dot64_s,      a64, b64);
+        }
+    }
+    #pragma pop_macro("test_dot_s")
+}
+
+static void test_dotq8() {
+    enum { blocks = 37, n = blocks * q8_block };
+    static fp32_t a[n];
+    static fp32_t b[n];
+    static q8_t qa[blocks];
+    static q8_t qb[blocks];
+    static q8_t qc[blocks];
+    uint32_t seed = 0;
+    for (int i = 0; i < n; i++) {
+        a[i] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
+        b[i] = (random32(&seed) / (fp32_t)UINT32_MAX - 0.5f) * (i % 7 + 1);
+    }
+    a[3] = 0.5f; // exact .5 ties must round the same way
+    for (int i = 0; i < q8_block; i++) { a[q8_block + i] = 0; } // zero block
+    cpu_quantize_q8(a, qa, blocks);
+    cpu_quantize_q8(b, qb, blocks);
+    if (avx2.quantize_q8 != null) {
+        avx2.quantize_q8(a, qc, blocks);
+        fatal_if(memcmp(qa, qc, sizeof(qc)) != 0);
+        avx2.quantize_q8(b, qc, blocks);
+        fatal_if(memcmp(qb, qc, sizeof(qc)) != 0);
+    }
+    for (int k = 1; k <= blocks; k++) {
+        fp64_t sum = 0; // fp32 dot product and sum of |a[i] * b[i]|
+        fp64_t abs = 0;
+        for (int i = 0; i < k * q8_block; i++) {
+            sum += a[i] * b[i];
+            abs += fabs(a[i] * b[i]);
+        }
+        fp64_t sum0 = cpu_dotq8_c(qa, qb, k);
+        // 8 bit quantization error of both vectors:
+        fatal_if(fabs(sum - sum0) > abs * 2.0 / 127,
+            "q8: %.7e fp32: %.7e", sum0, sum);
+        // SIMD results differ from C only by fp32 rounding:
+        if (avx2.dotq8 != null) {
+            fp64_t sum1 = avx2.dotq8(qa, qb, k);
+            fatal_if(fabs(sum1 - sum0) > abs * FLT_EPSILON * 4,
+                "cpu: %.7e avx2: %.7e", sum0, sum1);
+        }
+        if (avx512.dotq8 != null) {
+            fp64_t sum2 = avx512.dotq8(qa, qb, k);
+            fatal_if(fabs(sum2 - sum0) > abs * FLT_EPSILON * 4,
+                "cpu: %.7e avx512: %.7e", sum0, sum2);
+        }
+    }
+}
+
+static void test_dotq4() {
+    enum { blocks = 37, n = blocks * q4_block };
+    static fp32_t a[n];
+    static fp32_t b[n];
+    static fp32_t a4[n];  // dequantized q4_t
+    static fp32_t a4m[n]; // dequantized q4m_t
+    static fp32_t b8[n];  // dequantized q8_t
+    static q4_t  qa[blocks];
+    static q4m_t qm[blocks];
+    static q8_t  qb[blocks];
+    uint32_t seed = 0;
+    for (int i = 0; i < n; i++) {
+        a[i] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f + (i / q4_block % 3);
+        b[i] = (random32(&seed) / (fp32_t)UINT32_MAX - 0.5f) * (i % 7 + 1);
+    }
+    for (int i = 0; i < q4_block; i++) { a[q4_block + i] = 0; } // zero block
+    for (int k = 0; k < blocks; k++) {
+        const fp32_t* x = a + k * q4_block;
+        fp32toq4(x, &qa[k]);
+        fp32toq4m(x, &qm[k]);
+        fp32toq8(b + k * q8_block, &qb[k]);
+        q4to32(&qa[k], a4 + k * q4_block);
+        q4mto32(&qm[k], a4m + k * q4_block);
+        q8to32(&qb[k], b8 + k * q8_block);
+        fp32_t lo = x[0];
+        fp32_t hi = x[0];
+        fp32_t amax = 0;
+        for (int i = 0; i < q4_block; i++) {
+            lo = min(lo, x[i]);
+            hi = max(hi, x[i]);
+            amax = max(amax, fabsf(x[i]));
+        }
+        // half a step plus fp16 rounding of scale (and min):
+        const fp32_t e4 = amax / 7 * (0.5f + 8.0f / 1024) + FLT_MIN;
+        const fp32_t e4m = (hi - lo) / 15 * (0.5f + 16.0f / 1024) +
+                           fabsf(lo) / 1024 + FLT_MIN;
+        for (int i = 0; i < q4_block; i++) {
+            fatal_if(fabsf(x[i] - a4[k * q4_block + i]) > e4,
+                "q4: %.7e fp32: %.7e", a4[k * q4_block + i], x[i]);
+            fatal_if(fabsf(x[i] - a4m[k * q4_block + i]) > e4m,
+                "q4m: %.7e fp32: %.7e", a4m[k * q4_block + i], x[i]);
+        }
+    }
+    for (int k = 1; k <= blocks; k++) {
+        // exact dot products of dequantized vectors and sum of |products|:
+        fp64_t s4 = 0, s4m = 0, s48 = 0, s4m8 = 0, abs = 0;
+        for (int i = 0; i < k * q4_block; i++) {
+            s4   += (fp64_t)a4[i]  * b[i];
+            s4m  += (fp64_t)a4m[i] * b[i];
+            s48  += (fp64_t)a4[i]  * b8[i];
+            s4m8 += (fp64_t)a4m[i] * b8[i];
+            abs += fabs(a[i] * b[i]) + fabs(a4m[i] * b[i]);
+        }
+        const fp64_t e = abs * FLT_EPSILON * 8;
+        fatal_if(fabs(cpu_dot32xq4_c(b, qa, k) - s4) > e);
+        fatal_if(fabs(cpu_dot32xq4m_c(b, qm, k) - s4m) > e);
+        fatal_if(fabs(cpu_dotq8xq4_c(qb, qa, k) - s48) > e);
+        fatal_if(fabs(cpu_dotq8xq4m_c(qb, qm, k) - s4m8) > e);
+        if (avx2.dot32xq4 != null) {
+            fatal_if(fabs(avx2.dot32xq4(b, qa, k) - s4) > e);
+            fatal_if(fabs(avx2.dot32xq4m(b, qm, k) - s4m) > e);
+            fatal_if(fabs(avx2.dotq8xq4(qb, qa, k) - s48) > e);
+            fatal_if(fabs(avx2.dotq8xq4m(qb, qm, k) - s4m8) > e);
+        }
+        if (avx512.dot32xq4 != null) {
+            fatal_if(fabs(avx512.dot32xq4(b, qa, k) - s4) > e);
+            fatal_if(fabs(avx512.dot32xq4m(b, qm, k) - s4m) > e);
+        }
+    }
+    // gemv of blocks x 1 block matrices must match row by row dot products
+    static fp32_t rs[blocks];
+    gemv32xq4(qa, b, rs, q4_block, blocks);
+    for (int j = 0; j < blocks; j++) { fatal_if(rs[j] != (fp32_t)dot32xq4_c(b, qa + j, 1)); }
+    gemv32xq4m(qm, b, rs, q4_block, blocks);
+    for (int j = 0; j < blocks; j++) { fatal_if(rs[j] != (fp32_t)dot32xq4m_c(b, qm + j, 1)); }
+    gemvq8xq4(qa, qb, rs, q4_block, blocks);
+    for (int j = 0; j < blocks; j++) { fatal_if(rs[j] != (fp32_t)dotq8xq4_c(qb, qa + j, 1)); }
+    gemvq8xq4m(qm, qb, rs, q4_block, blocks);
+    for (int j = 0; j < blocks; j++) { fatal_if(rs[j] != (fp32_t)dotq8xq4m_c(qb, qm + j, 1)); }
+}
+
 static uint64_t flushL1L2L3() {
     enum { count = 16 * 1024 * 1024 }; // 128MB
     uint64_t* L1L2L3 = (uint64_t*)malloc(count * sizeof(uint64_t));
@@ -902,42 +3326,48 @@ typedef struct dot_performance_s { // per element
     fp64_t ns_avx512;
 } dot_performance_t;
 
-static void measure_dot16(int n, dot_performance_t* p) {
-    enum { m = 128 * 1024 };
-    typedef fp16_t vector_t[m];
-    vector_t* a = (vector_t*)malloc(n * sizeof(vector_t));
-    vector_t* b = (vector_t*)malloc(n * sizeof(vector_t));
+static void measure_dot16(int n, int m, dot_performance_t* p) {
+    fp16_t* a = (fp16_t*)malloc((size_t)n * m * sizeof(fp16_t));
+    fp16_t* b = (fp16_t*)malloc((size_t)n * m * sizeof(fp16_t));
     if (a != null && b != null) {
         fp64_t t = 0;
         uint32_t seed = 0;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < m; j++) {
-                a[i][j] = fp32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
-                b[i][j] = fp32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
+                a[i * m + j] = fp32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
+                b[i * m + j] = fp32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
             }
         }
+        // repeat short vectors to measure at least 128K elements:
+        const int k = max(1, 128 * 1024 / (n * m));
         // flush caches for n > 1:
         if (n > 1) { fatal_if(flushL1L2L3() == 0); }
         // C
         fp64_t ns_c = seconds() * NSEC_IN_SEC;
-        for (int i = 0; i < n; i++) { t += cpu_dot16_c(a[i], b[i], m); }
+        for (int i = 0; i < k * n; i++) {
+            t += cpu_dot16_c(a + i % n * m, b + i % n * m, m);
+        }
         ns_c = seconds() * NSEC_IN_SEC - ns_c;
-        p->ns_c = ns_c / (n * m);
+        p->ns_c = ns_c / ((fp64_t)k * n * m);
         // AVX-2
         if (avx2.dot16 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx2 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx2.dot16(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx2.dot16(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx2 = seconds() * NSEC_IN_SEC - ns_avx2;
-            p->ns_avx2 = ns_avx2 / (n * m);
+            p->ns_avx2 = ns_avx2 / ((fp64_t)k * n * m);
         }
         // AVX-512
         if (avx512.dot16 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx512 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx512.dot16(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx512.dot16(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx512 = seconds() * NSEC_IN_SEC - ns_avx512;
-            p->ns_avx512 = ns_avx512 / (n * m);
+            p->ns_avx512 = ns_avx512 / ((fp64_t)k * n * m);
         }
         // t referenced to prevent compiler from optimizing out
         fatal_if(t == 0); // what are the odds of that?!
@@ -946,43 +3376,48 @@ static void measure_dot16(int n, dot_performance_t* p) {
     free(a);
 }
 
-static void measure_dot32x16(int n, dot_performance_t* p) {
-    enum { m = 128 * 1024 };
-    typedef fp32_t vector32_t[m];
-    typedef fp16_t vector16_t[m];
-    vector32_t* a = (vector32_t*)malloc(n * sizeof(vector32_t));
-    vector16_t* b = (vector16_t*)malloc(n * sizeof(vector16_t));
+static void measure_dot32x16(int n, int m, dot_performance_t* p) {
+    fp32_t* a = (fp32_t*)malloc((size_t)n * m * sizeof(fp32_t));
+    fp16_t* b = (fp16_t*)malloc((size_t)n * m * sizeof(fp16_t));
     if (a != null && b != null) {
         fp64_t t = 0;
         uint32_t seed = 0;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < m; j++) {
-                a[i][j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
-                b[i][j] = fp32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
+                a[i * m + j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
+                b[i * m + j] = fp32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
             }
         }
+        // repeat short vectors to measure at least 128K elements:
+        const int k = max(1, 128 * 1024 / (n * m));
         // flush caches for n > 1:
         if (n > 1) { fatal_if(flushL1L2L3() == 0); }
         // C
         fp64_t ns_c = seconds() * NSEC_IN_SEC;
-        for (int i = 0; i < n; i++) { t += cpu_dot32x16_c(a[i], b[i], m); }
+        for (int i = 0; i < k * n; i++) {
+            t += cpu_dot32x16_c(a + i % n * m, b + i % n * m, m);
+        }
         ns_c = seconds() * NSEC_IN_SEC - ns_c;
-        p->ns_c = ns_c / (n * m);
+        p->ns_c = ns_c / ((fp64_t)k * n * m);
         // AVX-2
         if (avx2.dot32x16 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx2 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx2.dot32x16(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx2.dot32x16(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx2 = seconds() * NSEC_IN_SEC - ns_avx2;
-            p->ns_avx2 = ns_avx2 / (n * m);
+            p->ns_avx2 = ns_avx2 / ((fp64_t)k * n * m);
         }
         // AVX-512
         if (avx512.dot32x16 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx512 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx512.dot32x16(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx512.dot32x16(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx512 = seconds() * NSEC_IN_SEC - ns_avx512;
-            p->ns_avx512 = ns_avx512 / (n * m);
+            p->ns_avx512 = ns_avx512 / ((fp64_t)k * n * m);
         }
         // t referenced to prevent compiler from optimizing out
         fatal_if(t == 0); // what are the odds of that?!
@@ -991,42 +3426,48 @@ static void measure_dot32x16(int n, dot_performance_t* p) {
     free(a);
 }
 
-static void measure_dot16bf(int n, dot_performance_t* p) {
-    enum { m = 128 * 1024 };
-    typedef bf16_t vector_t[m];
-    vector_t* a = (vector_t*)malloc(n * sizeof(vector_t));
-    vector_t* b = (vector_t*)malloc(n * sizeof(vector_t));
+static void measure_dot16bf(int n, int m, dot_performance_t* p) {
+    bf16_t* a = (bf16_t*)malloc((size_t)n * m * sizeof(bf16_t));
+    bf16_t* b = (bf16_t*)malloc((size_t)n * m * sizeof(bf16_t));
     if (a != null && b != null) {
         fp64_t t = 0;
         uint32_t seed = 0;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < m; j++) {
-                a[i][j] = bf32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
-                b[i][j] = bf32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
+                a[i * m + j] = bf32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
+                b[i * m + j] = bf32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
             }
         }
+        // repeat short vectors to measure at least 128K elements:
+        const int k = max(1, 128 * 1024 / (n * m));
         // flush caches for n > 1:
         if (n > 1) { fatal_if(flushL1L2L3() == 0); }
         // C
         fp64_t ns_c = seconds() * NSEC_IN_SEC;
-        for (int i = 0; i < n; i++) { t += cpu_dot16bf_c(a[i], b[i], m); }
+        for (int i = 0; i < k * n; i++) {
+            t += cpu_dot16bf_c(a + i % n * m, b + i % n * m, m);
+        }
         ns_c = seconds() * NSEC_IN_SEC - ns_c;
-        p->ns_c = ns_c / (n * m);
+        p->ns_c = ns_c / ((fp64_t)k * n * m);
         // AVX-2
         if (avx2.dot16 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx2 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx2.dot16bf(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx2.dot16bf(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx2 = seconds() * NSEC_IN_SEC - ns_avx2;
-            p->ns_avx2 = ns_avx2 / (n * m);
+            p->ns_avx2 = ns_avx2 / ((fp64_t)k * n * m);
         }
         // AVX-512
         if (avx512.dot16 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx512 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx512.dot16bf(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx512.dot16bf(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx512 = seconds() * NSEC_IN_SEC - ns_avx512;
-            p->ns_avx512 = ns_avx512 / (n * m);
+            p->ns_avx512 = ns_avx512 / ((fp64_t)k * n * m);
         }
         // t referenced to prevent compiler from optimizing out
         fatal_if(t == 0); // what are the odds of that?!
@@ -1035,43 +3476,48 @@ static void measure_dot16bf(int n, dot_performance_t* p) {
     free(a);
 }
 
-static void measure_dot32x16bf(int n, dot_performance_t* p) {
-    enum { m = 128 * 1024 };
-    typedef fp32_t vector32_t[m];
-    typedef bf16_t vector16_t[m];
-    vector32_t* a = (vector32_t*)malloc(n * sizeof(vector32_t));
-    vector16_t* b = (vector16_t*)malloc(n * sizeof(vector16_t));
+static void measure_dot32x16bf(int n, int m, dot_performance_t* p) {
+    fp32_t* a = (fp32_t*)malloc((size_t)n * m * sizeof(fp32_t));
+    bf16_t* b = (bf16_t*)malloc((size_t)n * m * sizeof(bf16_t));
     if (a != null && b != null) {
         fp64_t t = 0;
         uint32_t seed = 0;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < m; j++) {
-                a[i][j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
-                b[i][j] = bf32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
+                a[i * m + j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
+                b[i * m + j] = bf32to16(random32(&seed) / (fp32_t)UINT32_MAX - 0.5f);
             }
         }
+        // repeat short vectors to measure at least 128K elements:
+        const int k = max(1, 128 * 1024 / (n * m));
         // flush caches for n > 1:
         if (n > 1) { fatal_if(flushL1L2L3() == 0); }
         // C
         fp64_t ns_c = seconds() * NSEC_IN_SEC;
-        for (int i = 0; i < n; i++) { t += cpu_dot32x16bf_c(a[i], b[i], m); }
+        for (int i = 0; i < k * n; i++) {
+            t += cpu_dot32x16bf_c(a + i % n * m, b + i % n * m, m);
+        }
         ns_c = seconds() * NSEC_IN_SEC - ns_c;
-        p->ns_c = ns_c / (n * m);
+        p->ns_c = ns_c / ((fp64_t)k * n * m);
         // AVX-2
         if (avx2.dot32x16bf != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx2 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx2.dot32x16bf(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx2.dot32x16bf(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx2 = seconds() * NSEC_IN_SEC - ns_avx2;
-            p->ns_avx2 = ns_avx2 / (n * m);
+            p->ns_avx2 = ns_avx2 / ((fp64_t)k * n * m);
         }
         // AVX-512
         if (avx512.dot32x16bf != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx512 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx512.dot32x16bf(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx512.dot32x16bf(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx512 = seconds() * NSEC_IN_SEC - ns_avx512;
-            p->ns_avx512 = ns_avx512 / (n * m);
+            p->ns_avx512 = ns_avx512 / ((fp64_t)k * n * m);
         }
         // t referenced to prevent compiler from optimizing out
         fatal_if(t == 0); // what are the odds of that?!
@@ -1080,42 +3526,48 @@ static void measure_dot32x16bf(int n, dot_performance_t* p) {
     free(a);
 }
 
-static void measure_dot32(int n, dot_performance_t* p) {
-    enum { m = 128 * 1024 };
-    typedef fp32_t vector_t[m];
-    vector_t* a = (vector_t*)malloc(n * sizeof(vector_t));
-    vector_t* b = (vector_t*)malloc(n * sizeof(vector_t));
+static void measure_dot32(int n, int m, dot_performance_t* p) {
+    fp32_t* a = (fp32_t*)malloc((size_t)n * m * sizeof(fp32_t));
+    fp32_t* b = (fp32_t*)malloc((size_t)n * m * sizeof(fp32_t));
     if (a != null && b != null) {
         fp64_t t = 0;
         uint32_t seed = 0;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < m; j++) {
-                a[i][j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
-                b[i][j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
+                a[i * m + j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
+                b[i * m + j] = random32(&seed) / (fp32_t)UINT32_MAX - 0.5f;
             }
         }
+        // repeat short vectors to measure at least 128K elements:
+        const int k = max(1, 128 * 1024 / (n * m));
         // flush caches for n > 1:
         if (n > 1) { fatal_if(flushL1L2L3() == 0); }
         // C
         fp64_t ns_c = seconds() * NSEC_IN_SEC;
-        for (int i = 0; i < n; i++) { t += cpu_dot32_c(a[i], b[i], m); }
+        for (int i = 0; i < k * n; i++) {
+            t += cpu_dot32_c(a + i % n * m, b + i % n * m, m);
+        }
         ns_c = seconds() * NSEC_IN_SEC - ns_c;
-        p->ns_c = ns_c / (n * m);
+        p->ns_c = ns_c / ((fp64_t)k * n * m);
         // AVX-2
         if (avx2.dot32 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx2 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx2.dot32(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx2.dot32(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx2 = seconds() * NSEC_IN_SEC - ns_avx2;
-            p->ns_avx2 = ns_avx2 / (n * m);
+            p->ns_avx2 = ns_avx2 / ((fp64_t)k * n * m);
         }
         // AVX-512
         if (avx512.dot32 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx512 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx512.dot32(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx512.dot32(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx512 = seconds() * NSEC_IN_SEC - ns_avx512;
-            p->ns_avx512 = ns_avx512 / (n * m);
+            p->ns_avx512 = ns_avx512 / ((fp64_t)k * n * m);
         }
         // t referenced to prevent compiler from optimizing out
         fatal_if(t == 0); // what are the odds of that?!
@@ -1124,41 +3576,47 @@ static void measure_dot32(int n, dot_performance_t* p) {
     free(a);
 }
 
-static void measure_dot64(int n, dot_performance_t* p) {
-    enum { m = 64 * 1024 };
-    typedef fp64_t vector_t[m];
-    vector_t* a = (vector_t*)malloc(n * sizeof(vector_t));
-    vector_t* b = (vector_t*)malloc(n * sizeof(vector_t));
+static void measure_dot64(int n, int m, dot_performance_t* p) {
+    fp64_t* a = (fp64_t*)malloc((size_t)n * m * sizeof(fp64_t));
+    fp64_t* b = (fp64_t*)malloc((size_t)n * m * sizeof(fp64_t));
     if (a != null && b != null) {
         fp64_t t = 0;
         uint32_t seed = 0;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < m; j++) {
-                a[i][j] = random32(&seed) / (fp64_t)UINT32_MAX - 0.5f;
-                b[i][j] = random32(&seed) / (fp64_t)UINT32_MAX - 0.5f;
+                a[i * m + j] = random32(&seed) / (fp64_t)UINT32_MAX - 0.5f;
+                b[i * m + j] = random32(&seed) / (fp64_t)UINT32_MAX - 0.5f;
             }
         }
+        // repeat short vectors to measure at least 128K elements:
+        const int k = max(1, 128 * 1024 / (n * m));
         // C
         if (n > 1) { fatal_if(flushL1L2L3() == 0); }
         fp64_t ns_c = seconds() * NSEC_IN_SEC;
-        for (int i = 0; i < n; i++) { t += cpu_dot64_c(a[i], b[i], m); }
+        for (int i = 0; i < k * n; i++) {
+            t += cpu_dot64_c(a + i % n * m, b + i % n * m, m);
+        }
         ns_c = seconds() * NSEC_IN_SEC - ns_c;
-        p->ns_c = ns_c / (n * m);
+        p->ns_c = ns_c / ((fp64_t)k * n * m);
         // AVX-2
         if (avx2.dot64 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx2 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx2.dot64(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx2.dot64(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx2 = seconds() * NSEC_IN_SEC - ns_avx2;
-            p->ns_avx2 = ns_avx2 / (n * m);
+            p->ns_avx2 = ns_avx2 / ((fp64_t)k * n * m);
         }
         // AVX-512
         if (avx512.dot64 != null) {
             if (n > 1) { fatal_if(flushL1L2L3() == 0); }
             fp64_t ns_avx512 = seconds() * NSEC_IN_SEC;
-            for (int i = 0; i < n; i++) { t += avx512.dot64(a[i], b[i], m); }
+            for (int i = 0; i < k * n; i++) {
+                t += avx512.dot64(a + i % n * m, b + i % n * m, m);
+            }
             ns_avx512 = seconds() * NSEC_IN_SEC - ns_avx512;
-            p->ns_avx512 = ns_avx512 / (n * m);
+            p->ns_avx512 = ns_avx512 / ((fp64_t)k * n * m);
         }
         // t referenced to prevent compiler from optimizing out
         fatal_if(t == 0); // what are the odds of that?!
@@ -1167,15 +3625,15 @@ static void measure_dot64(int n, dot_performance_t* p) {
     free(a);
 }
 
-static void performance(int n, int bestof, dot_performance_t* m,
-    void (*measure)(int n, dot_performance_t* p)) {
-    measure(n, m); // best of 100 runs
+static void performance(int n, int m, int bestof, dot_performance_t* b,
+    void (*measure)(int n, int m, dot_performance_t* p)) {
+    measure(n, m, b); // best of "bestof" runs
     for (int i = 0; i < bestof; i++) {
         dot_performance_t p = {0};
-        measure(n, &p);
-        m->ns_c      = min(m->ns_c, p.ns_c);
-        m->ns_avx2   = min(m->ns_avx2, p.ns_avx2);
-        m->ns_avx512 = min(m->ns_avx512, p.ns_avx512);
+        measure(n, m, &p);
+        b->ns_c      = min(b->ns_c, p.ns_c);
+        b->ns_avx2   = min(b->ns_avx2, p.ns_avx2);
+        b->ns_avx512 = min(b->ns_avx512, p.ns_avx512);
     }
 }
 
@@ -1194,41 +3652,260 @@ static void report_preformance(dot_performance_t* p, const char* label) {
 }
 
 static void dot_test_performance() {
+    // L1: 1K elements (8..16KB) fit into L1 cache and show FMA throughput
+    // L2: 128K elements (0.5..2MB) single pass (was labeled "L1" before)
+    // RAM: 128 x 128K elements after caches flush
+    enum { K = 1024 };
     dot_performance_t p = {0};
-    performance(1,   100, &p, measure_dot16bf);    report_preformance(&p, "bf16 L1");
-    performance(128,  25, &p, measure_dot16bf);    report_preformance(&p, "bf16 RAM");
-    performance(1,   100, &p, measure_dot32x16bf); report_preformance(&p, "bf32x16 L1");
-    performance(128,  25, &p, measure_dot32x16bf); report_preformance(&p, "bf32x16 RAM");
-    performance(1,   100, &p, measure_dot16);      report_preformance(&p, "fp16 L1");
-    performance(128,  25, &p, measure_dot16);      report_preformance(&p, "fp16 RAM");
-    performance(1,   100, &p, measure_dot32x16);   report_preformance(&p, "fp32x16 L1");
-    performance(128,  25, &p, measure_dot32x16);   report_preformance(&p, "fp32x16 RAM");
-    performance(1,   100, &p, measure_dot32);      report_preformance(&p, "fp32 L1");
-    performance(128,  25, &p, measure_dot32);      report_preformance(&p, "fp32 RAM");
-    performance(1,   100, &p, measure_dot64);      report_preformance(&p, "fp64 L1");
-    performance(128,  25, &p, measure_dot64);      report_preformance(&p, "fp64 RAM");
+    performance(1,     K, 100, &p, measure_dot16bf);    report_preformance(&p, "bf16 L1");
+    performance(1, 128*K, 100, &p, measure_dot16bf);    report_preformance(&p, "bf16 L2");
+    performance(128, 128*K, 25, &p, measure_dot16bf);   report_preformance(&p, "bf16 RAM");
+    performance(1,     K, 100, &p, measure_dot32x16bf); report_preformance(&p, "bf32x16 L1");
+    performance(1, 128*K, 100, &p, measure_dot32x16bf); report_preformance(&p, "bf32x16 L2");
+    performance(128, 128*K, 25, &p, measure_dot32x16bf);report_preformance(&p, "bf32x16 RAM");
+    performance(1,     K, 100, &p, measure_dot16);      report_preformance(&p, "fp16 L1");
+    performance(1, 128*K, 100, &p, measure_dot16);      report_preformance(&p, "fp16 L2");
+    performance(128, 128*K, 25, &p, measure_dot16);     report_preformance(&p, "fp16 RAM");
+    performance(1,     K, 100, &p, measure_dot32x16);   report_preformance(&p, "fp32x16 L1");
+    performance(1, 128*K, 100, &p, measure_dot32x16);   report_preformance(&p, "fp32x16 L2");
+    performance(128, 128*K, 25, &p, measure_dot32x16);  report_preformance(&p, "fp32x16 RAM");
+    performance(1,     K, 100, &p, measure_dot32);      report_preformance(&p, "fp32 L1");
+    performance(1, 128*K, 100, &p, measure_dot32);      report_preformance(&p, "fp32 L2");
+    performance(128, 128*K, 25, &p, measure_dot32);     report_preformance(&p, "fp32 RAM");
+    performance(1,     K, 100, &p, measure_dot64);      report_preformance(&p, "fp64 L1");
+    performance(1,  64*K, 100, &p, measure_dot64);      report_preformance(&p, "fp64 L2");
+    performance(128, 64*K, 25, &p, measure_dot64);      report_preformance(&p, "fp64 RAM");
+}
+
+static void strided_test_performance() {
+    // column access (stride is the row width) of row-major matrices as
+    // in transposed gemv and short constant strides:
+    enum { n = 4 * 1024, width = 4 * 1024 };
+    static const int64_t strides[] = { 2, 4, width };
+    void* a = malloc((int64_t)n * width * sizeof(fp64_t));
+    void* b = malloc((int64_t)n * width * sizeof(fp64_t));
+    if (a != null && b != null) {
+        memset(a, 0x3C, (int64_t)n * width * sizeof(fp64_t));
+        memset(b, 0x3C, (int64_t)n * width * sizeof(fp64_t));
+        #pragma push_macro("measure_dot_s")
+        #define measure_dot_s(label, t0, t1, cpu, kernel2, kernel512) do {  \
+            for (int i = 0; i < countof(strides); i++) {                    \
+                const int64_t s = strides[i];                               \
+                fp64_t ns[3] = { DBL_MAX, DBL_MAX, DBL_MAX };               \
+                void* kernels[3] = { (void*)cpu, (void*)kernel2,            \
+                                     (void*)kernel512 };                    \
+                for (int k = 0; k < 3; k++) {                               \
+                    if (kernels[k] == null) { continue; }                   \
+                    fp64_t (*f)(const t0*, int64_t, const t1*, int64_t,     \
+                        int64_t) = kernels[k];                              \
+                    for (int r = 0; r < 8; r++) {                           \
+                        fp64_t t = seconds();                               \
+                        fatal_if(f((const t0*)a, s, (const t1*)b, s, n)     \
+                            == 0);                                          \
+                        ns[k] = min(ns[k], (seconds() - t) * NSEC_IN_SEC);  \
+                    }                                                       \
+                }                                                           \
+                println("%-10s stride %4lld C: %6.3f avx2: %6.3f "          \
+                    "avx512: %6.3f GFlops", label, s, 2.0 * n / ns[0],      \
+                    kernel2   != null ? 2.0 * n / ns[1] : 0,                \
+                    kernel512 != null ? 2.0 * n / ns[2] : 0);               \
+            }                                                               \
+        } while (0)
+        measure_dot_s("fp16",    fp16_t, fp16_t, cpu_dot16_s,
+            avx2.dot16_s, avx512.dot16_s);
+        measure_dot_s("fp32x16", fp32_t, fp16_t, cpu_dot32x16_s,
+            avx2.dot32x16_s, avx512.dot32x16_s);
+        measure_dot_s("bf16",    bf16_t, bf16_t, cpu_dot16bf_s,
+            avx2.dot16bf_s, avx512.dot16bf_s);
+        measure_dot_s("bf32x16", fp32_t, bf16_t, cpu_dot32x16bf_s,
+            avx2.dot32x16bf_s, avx512.dot32x16bf_s);
+        measure_dot_s("fp32",    fp32_t, fp32_t, cpu_dot32_s,
+            avx2.dot32_s, avx512.dot32_s);
+        measure_dot_s("fp64",    fp64_t, fp64_t, cpu_dot64_s,
+            avx2.dot64_s, avx512.dot64_s);
+        #pragma pop_macro("measure_dot_s")
+    }
+    free(b); // free(null) is OK
+    free(a);
+}
+
+static void prefetch_test_performance() {
+    // sweep of prefetch distance and hint for fp32 dot products of L2 and
+    // RAM sized vectors (results used for dot_prefetch_tiers defaults):
+    enum { bytes = 128 * 1024 * 1024 };
+    static const int32_t lines[] = { 0, 1, 2, 4, 8, 16, 32 };
+    static const int32_t hints[] = { dot_prefetch_t0, dot_prefetch_t1, dot_prefetch_nta };
+    static const char* hint_names[] = { "T0", "T1", "T2", "NTA" };
+    static const int64_t sizes[] = { 256 * 1024, bytes }; // v0 + v1
+    const dot_prefetch_t saved[dot_tiers] = {
+        dot_prefetch_tiers[0], dot_prefetch_tiers[1], dot_prefetch_tiers[2]
+    };
+    fp32_t* memory = (fp32_t*)malloc(bytes);
+    if (memory != null) {
+        memset(memory, 0, bytes);
+        for (int i = 0; i < countof(sizes); i++) {
+            const int64_t n = sizes[i] / 2 / sizeof(fp32_t);
+            // L2 sized vectors are repeated to make timing measurable
+            const int32_t repeat = (int32_t)(bytes / sizes[i]);
+            for (int h = 0; h < countof(hints); h++) {
+                for (int k = 0; k < countof(lines); k++) {
+                    dot_set_prefetch(sizes[i], lines[k], hints[h]);
+                    fp64_t best = DBL_MAX;
+                    for (int r = 0; r < 4; r++) {
+                        fp64_t sum = 0;
+                        fp64_t t = seconds();
+                        for (int j = 0; j < repeat; j++) {
+                            sum += dot32_c(memory, memory + n, n);
+                        }
+                        best = min(best, seconds() - t);
+                        fatal_if(sum != 0);
+                    }
+                    println("fp32 %s %-3s lines: %2d %6.3f GFlops",
+                        i == 0 ? "L2 " : "RAM", hint_names[hints[h]], lines[k],
+                        2.0 * n * repeat / (best * NSEC_IN_SEC));
+                }
+            }
+        }
+        free(memory);
+    }
+    for (int i = 0; i < dot_tiers; i++) { dot_prefetch_tiers[i] = saved[i]; }
+}
+
+static void gemv_test_performance() {
+    // 4096 x 16384 (GPT-J 6B like) matrix does not fit into caches
+    // and gemv throughput is limited by DRAM bandwidth:
+    enum { n = 16 * 1024, m = 4 * 1024 };
+    int64_t page = 0;
+    void* mx = huge_alloc((int64_t)n * m * sizeof(fp32_t), &page);
+    void* vc = malloc(n * sizeof(fp64_t));
+    void* rs = malloc(m * sizeof(fp64_t));
+    if (mx != null && vc != null && rs != null) {
+        memset(mx, 0x3C, (int64_t)n * m * sizeof(fp32_t));
+        memset(vc, 0x3C, n * sizeof(fp64_t));
+        println("gemv threads: %d pages: %lldKB", cores(), page / 1024);
+        #pragma push_macro("measure_gemv")
+        // km, kv: elements per mt, vt (q8_t holds q8_block elements)
+        #define measure_gemv(gemv, mt, vt, rt, columns, km, kv) do {        \
+            fp64_t best = DBL_MAX;                                          \
+            for (int i = 0; i < 8; i++) {                                   \
+                fp64_t time = seconds();                                    \
+                gemv((const mt*)mx, (const vt*)vc, (rt*)rs, columns, m);    \
+                best = min(best, seconds() - time);                         \
+            }                                                               \
+            const fp64_t gb = ((fp64_t)m * columns * sizeof(mt) / km +      \
+                (fp64_t)columns * sizeof(vt) / kv + m * sizeof(rt)) / 1e9;  \
+            println("%-11s %dx%d %7.3f ms %6.1f GB/s %6.1f GFlops",          \
+                #gemv, m, columns, best * MSEC_IN_SEC, gb / best,           \
+                2.0 * m * columns / (best * 1e9));                          \
+        } while (0)
+        measure_gemv(gemv16,      fp16_t, fp16_t, fp32_t, n, 1, 1);
+        measure_gemv(gemv16bf,    bf16_t, bf16_t, fp32_t, n, 1, 1);
+        measure_gemv(gemv32x16,   fp16_t, fp32_t, fp32_t, n, 1, 1);
+        measure_gemv(gemv32x16bf, bf16_t, fp32_t, fp32_t, n, 1, 1);
+        measure_gemv(gemv32,      fp32_t, fp32_t, fp32_t, n, 1, 1);
+        measure_gemv(gemv64,      fp64_t, fp64_t, fp64_t, n / 2, 1, 1);
+        measure_gemv(gemvq8,      q8_t,   q8_t,   fp32_t, n, q8_block, q8_block);
+        measure_gemv(gemv32xq4,   q4_t,   fp32_t, fp32_t, n, q4_block, 1);
+        measure_gemv(gemv32xq4m,  q4m_t,  fp32_t, fp32_t, n, q4_block, 1);
+        measure_gemv(gemvq8xq4,   q4_t,   q8_t,   fp32_t, n, q4_block, q8_block);
+        measure_gemv(gemvq8xq4m,  q4m_t,  q8_t,   fp32_t, n, q4_block, q8_block);
+        #pragma pop_macro("measure_gemv")
+        // CPUs can not report TLB misses to user mode on Windows: compare
+        // gemv32 on large pages with the same matrix on malloc() 4KB pages.
+        // The page counts are the page mappings (TLB entries) needed to
+        // cover the matrix, not measured TLB misses; time is the savings:
+        void* small = malloc((int64_t)n * m * sizeof(fp32_t));
+        if (small != null && page > 4 * 1024) {
+            memcpy(small, mx, (int64_t)n * m * sizeof(fp32_t));
+            fp64_t best[2] = { DBL_MAX, DBL_MAX };
+            for (int i = 0; i < 8; i++) {
+                for (int k = 0; k < 2; k++) {
+                    fp64_t time = seconds();
+                    gemv32(k == 0 ? mx : small, vc, rs, n, m);
+                    best[k] = min(best[k], seconds() - time);
+                }
+            }
+            const int64_t bytes = (int64_t)n * m * sizeof(fp32_t);
+            println("gemv32 %lldKB pages: %7.3f ms (mapped by %lld pages) "
+                "4KB pages: %7.3f ms (mapped by %lld pages)",
+                page / 1024, best[0] * MSEC_IN_SEC, (bytes + page - 1) / page,
+                best[1] * MSEC_IN_SEC, bytes / (4 * 1024));
+        }
+        free(small);
+    }
+    free(rs); // free(null) is OK
+    free(vc);
+    huge_free(mx);
+}
+
+static void dot_calibration_dump(void) {
+    static const char* types[dot_types] = {
+        "fp16", "fp32x16", "bf16", "bf32x16", "fp32", "fp64"
+    };
+    for (int32_t t = 0; t < dot_types; t++) {
+        println("%-8s L1: %s L2: %s RAM: %s", types[t],
+            dot_calibration.avx2[t][dot_l1]  ? "avx2  " : "avx512",
+            dot_calibration.avx2[t][dot_l2]  ? "avx2  " : "avx512",
+            dot_calibration.avx2[t][dot_ram] ? "avx2  " : "avx512");
+    }
 }
 
 static void dot_test(void) {
     dot_init(); // needed here because tests are using internal calls
+    dot_calibration_dump();
     test_dot16_c();
     test_dot32x16_c();
     test_dot16bf_c();
     test_dot32x16bf_c();
     test_dot32_c();
     test_dot64_c();
+    test_dot32_compensated();
+    test_dot_many();
+    test_dot_strided();
+    test_dotq8();
+    test_dotq4();
+    test_gemv();
+    test_gemv_numa();
+    test_gemv_numa_fake();
     dot_test_performance();
+    strided_test_performance();
+    prefetch_test_performance();
+    gemv_test_performance();
 }
 
 #endif // DOT_TEST
 
 dot_if dot = {
     .fp16 = dot16,
+    .fp16_native = dot16_native,
     .fp32 = dot32,
     .fp64 = dot64,
     .bf16 = dot16bf,
     .fp32x16 = dot32x16,
     .bf32x16 = dot32x16bf,
+    .fp32x16_many = dot32x16_many,
+    .bf32x16_many = dot32x16bf_many,
+    .q8           = dotq8,
+    .quantize_q8  = quantize_q8,
+    .gemv_fp16    = gemv16,
+    .gemv_fp32    = gemv32,
+    .gemv_fp64    = gemv64,
+    .gemv_bf16    = gemv16bf,
+    .gemv_fp32x16 = gemv32x16,
+    .gemv_bf32x16 = gemv32x16bf,
+    .gemv_q8      = gemvq8,
+    .fp32xq4      = dot32xq4,
+    .fp32xq4m     = dot32xq4m,
+    .q8xq4        = dotq8xq4,
+    .q8xq4m       = dotq8xq4m,
+    .gemv_fp32xq4  = gemv32xq4,
+    .gemv_fp32xq4m = gemv32xq4m,
+    .gemv_q8xq4    = gemvq8xq4,
+    .gemv_q8xq4m   = gemvq8xq4m,
+    .fp32_compensated = dot32_compensated,
+    .numa_alloc    = dot_numa_alloc,
+    .numa_free     = dot_numa_free,
+    .prefetch      = dot_set_prefetch,
 #ifdef DOT_TEST
     .test = dot_test
 #endif
@@ -5,6 +5,13 @@
 extern "C" {
 #endif
 
+enum { // software prefetch hints
+    dot_prefetch_t0  = 0, // all cache levels
+    dot_prefetch_t1  = 1, // L2 and higher
+    dot_prefetch_t2  = 2, // L3 and higher
+    dot_prefetch_nta = 3  // non-temporal, minimizes cache pollution
+};
+
 typedef struct dot_if {
     fp64_t (*fp16)(const fp16_t* v0, int64_t s0, const fp16_t* v1, int64_t s1, int64_t n);
     fp64_t (*fp32)(const fp32_t* v0, int64_t s0, const fp32_t* v1, int64_t s1, int64_t n);
@@ -12,6 +19,53 @@ typedef struct dot_if {
     fp64_t (*bf16)(const bf16_t* v0, int64_t s0, const bf16_t* v1, int64_t s1, int64_t n);
     fp64_t (*fp32x16)(const fp32_t* v0, int64_t s0, const fp16_t* v1, int64_t s1, int64_t n);
     fp64_t (*bf32x16)(const fp32_t* v0, int64_t s0, const bf16_t* v1, int64_t s1, int64_t n);
+    // compensated (Dot2) SIMD fp32 accumulation: almost as accurate as fp64
+    // accumulation for long vectors and almost as fast as fp32():
+    fp64_t (*fp32_compensated)(const fp32_t* v0, int64_t s0, const fp32_t* v1, int64_t s1, int64_t n);
+    // fp16 x fp16 accumulated in fp16 on AVX512_FP16 (falls back to fp16()
+    // elsewhere): faster but only ~2^-9 relative accuracy vs fp32 of fp16():
+    fp64_t (*fp16_native)(const fp16_t* v0, const fp16_t* v1, int64_t n);
+    // rs[j] = v[n] . mx[j * stride + i] for j in [0..rows - 1], i in [0..n - 1]
+    // single pass over v[] for every 4 rows:
+    void (*fp32x16_many)(const fp32_t* v, const fp16_t* mx, int64_t stride, fp32_t* rs, int64_t n, int64_t rows);
+    void (*bf32x16_many)(const fp32_t* v, const bf16_t* mx, int64_t stride, fp32_t* rs, int64_t n, int64_t rows);
+    // Q8 block quantized vectors (q8_t in fp16.h), n is number of elements
+    // and must be a multiple of q8_block:
+    fp64_t (*q8)(const q8_t* v0, const q8_t* v1, int64_t n);
+    void   (*quantize_q8)(const fp32_t* v, q8_t* q, int64_t n); // v[n] -> q[n / q8_block]
+    // rs[m] = mx[m][n] * vc[n] with rows split across cores() threads.
+    // Concurrent gemv_*() calls are serialized on the shared thread pool:
+    void (*gemv_fp16)(const fp16_t* mx, const fp16_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    void (*gemv_fp32)(const fp32_t* mx, const fp32_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    void (*gemv_fp64)(const fp64_t* mx, const fp64_t* vc, fp64_t* rs, int64_t n, int64_t m);
+    void (*gemv_bf16)(const bf16_t* mx, const bf16_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    void (*gemv_fp32x16)(const fp16_t* mx, const fp32_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    void (*gemv_bf32x16)(const bf16_t* mx, const fp32_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    // vc must be quantized with quantize_q8() once for all rows:
+    void (*gemv_q8)(const q8_t* mx, const q8_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    // Q4 grouped quantized rows (q4_t, q4m_t in fp16.h) against fp32 or Q8
+    // vectors, n is number of elements and must be a multiple of q4_block:
+    fp64_t (*fp32xq4)(const fp32_t* v, const q4_t* q, int64_t n);
+    fp64_t (*fp32xq4m)(const fp32_t* v, const q4m_t* q, int64_t n);
+    fp64_t (*q8xq4)(const q8_t* v, const q4_t* q, int64_t n);
+    fp64_t (*q8xq4m)(const q8_t* v, const q4m_t* q, int64_t n);
+    void (*gemv_fp32xq4)(const q4_t* mx, const fp32_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    void (*gemv_fp32xq4m)(const q4m_t* mx, const fp32_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    void (*gemv_q8xq4)(const q4_t* mx, const q8_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    void (*gemv_q8xq4m)(const q4m_t* mx, const q8_t* vc, fp32_t* rs, int64_t n, int64_t m);
+    // NUMA: matrix of m rows of row_bytes with contiguous blocks of rows
+    // placed on consecutive NUMA nodes (or pages interleaved across nodes).
+    // gemv_*() of such matrix processes each block of rows on the threads
+    // of its node. Single node systems get page aligned memory:
+    void* (*numa_alloc)(int64_t m, int64_t row_bytes, bool interleave);
+    void  (*numa_free)(void* mx);
+    // streaming kernels (q8/q4 included) prefetch `lines` cache lines
+    // ahead (0 disables) with `hint` for vectors of the same size class
+    // (L1, L2 or RAM) as `bytes` of both vectors together. RAM settings
+    // are also used for prefetching next gemv rows. Not thread safe:
+    // settings are plain globals read by every kernel, call before
+    // concurrent dot/gemv use:
+    void (*prefetch)(int64_t bytes, int32_t lines, int32_t hint);
     void   (*test)(void); // can be null
 } dot_if;
 
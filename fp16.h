@@ -157,7 +157,7 @@ inline fp32_t fp16to32(fp16_t fp16) {
     uint32_t result;
     // Shift back the decoded mantissa to proper position.
     if (exponent == 0 && mantissa == 0) {  // +/- zero
-        result = sign << 31;
+        result = sign;
     } else if (exponent == 0x1f && mantissa == 0) {  // +/- infinity
         result = sign | (0xFF << 23);
     } else if (exponent == 0x1f && mantissa != 0) {  // NaN
@@ -186,6 +186,25 @@ inline fp32_t fp16to32(fp16_t fp16) {
 	return *(fp32_t*)&result;
 }
 
+inline fp16_t fp32to16_rne(fp32_t f32) { // round to nearest even like vcvtps2ph
+    const uint32_t f16max = (127 + 16) << 23; // 65536 and up is inf
+    const uint32_t denorm = ((127 - 15) + (23 - 10) + 1) << 23;
+    uint32_t u = *(uint32_t*)&f32;
+    const uint32_t sign = u & 0x80000000;
+    u ^= sign;
+    uint32_t r;
+    if (u >= f16max) { // inf or NaN (quiet, top 10 bits of the payload)
+        r = u > 0x7F800000 ? 0x7E00 | ((u >> 13) & 0x3FF) : 0x7C00;
+    } else if (u < (113U << 23)) { // subnormal or zero: fp32 addition rounds
+        fp32_t f = *(fp32_t*)&u + *(const fp32_t*)&denorm;
+        r = *(uint32_t*)&f - denorm;
+    } else {
+        r = (u + ((uint32_t)(15 - 127) << 23) + 0xFFF + ((u >> 13) & 1)) >> 13;
+    }
+    fp16_t h = { .bytes = (uint16_t)(r | (sign >> 16)) };
+    return h;
+}
+
 inline fp16_t fp16_add(fp16_t x, fp16_t y) {
     return fp32to16(fp16to32(x) + fp16to32(y));
 }
@@ -222,6 +241,17 @@ inline bf16_t bf32to16(const fp32_t fp32) {
     return *(bf16_t*)&uint16;
 }
 
+inline bf16_t bf32to16_rne(const fp32_t fp32) { // round to nearest even
+    uint32_t u = *(uint32_t*)&fp32;
+    if ((u & 0x7FFFFFFF) > 0x7F800000) {
+        u |= 0x00400000; // quiet NaN: rounding must not turn it into inf
+    } else {
+        u += 0x7FFF + ((u >> 16) & 1);
+    }
+    const uint16_t uint16 = (uint16_t)(u >> 16);
+    return *(bf16_t*)&uint16;
+}
+
 inline bf16_t bf16_add(bf16_t x, bf16_t y) {
     return bf32to16(bf16to32(x) + bf16to32(y));
 }
@@ -248,10 +278,377 @@ inline bool bf16_gtr(bf16_t x, bf16_t y) { return bf16_compare(x, y) >  0; }
 inline bool bf16_gte(bf16_t x, bf16_t y) { return bf16_compare(x, y) >= 0; }
 inline bool bf16_neq(bf16_t x, bf16_t y) { return bf16_compare(x, y) != 0; }
 
+// Bulk conversions of n elements using F16C/AVX2/AVX512 when present.
+// Large arrays are split across cores() by parallel() thus must not be
+// called from inside parallel() tasks. fp32to16_n() and bf32to16_n()
+// round to nearest even and match fp32to16_rne() and bf32to16_rne() bit
+// for bit (fp32to16() and bf32to16() above truncate):
+void fp32to16_n(const fp32_t* v, fp16_t* r, int64_t n);
+void fp16to32_n(const fp16_t* v, fp32_t* r, int64_t n);
+void bf32to16_n(const fp32_t* v, bf16_t* r, int64_t n);
+void bf16to32_n(const bf16_t* v, fp32_t* r, int64_t n);
+// Q8 block quantization: 32 values share one fp16 scale
+// x[i] ~= q[i] * scale with q[i] in [-127..127] (-128 is never used
+// so that sign(x) * |x| tricks in SIMD integer dot products do not overflow)
+
+enum { q8_block = 32 }; // values per block
+
+typedef begin_packed struct q8_s {
+    fp16_t scale;
+    int8_t q[q8_block];
+} end_packed q8_t; // 34 bytes per 32 values (8.5 bits per value)
+
+static_assert(sizeof(q8_t) == 34, "q8_t size must be 34");
+
+inline void fp32toq8(const fp32_t* v, q8_t* q) { // v[q8_block] -> q
+    fp32_t amax = 0;
+    for (int i = 0; i < q8_block; i++) { amax = max(amax, fabsf(v[i])); }
+    const fp32_t inv = amax != 0 ? 127.0f / amax : 0;
+    for (int i = 0; i < q8_block; i++) {
+        q->q[i] = (int8_t)lrintf(v[i] * inv); // round to nearest even
+    }
+    q->scale = fp32to16(amax / 127.0f);
+}
+
+inline void q8to32(const q8_t* q, fp32_t* v) { // q -> v[q8_block]
+    const fp32_t scale = fp16to32(q->scale);
+    for (int i = 0; i < q8_block; i++) { v[i] = q->q[i] * scale; }
+}
+
+// Q4 grouped quantization: 32 values (same group as q8_t so that Q4 rows
+// and Q8 vectors line up) packed as nibbles with one fp16 scale and,
+// for q4m_t, an fp16 min:
+//     q4_t:  x[i] ~= (q[i] - 8) * scale          q[i] in [1..15]
+//     q4m_t: x[i] ~=  q[i] * scale + min         q[i] in [0..15]
+// byte j holds value j in the low nibble and value j + 16 in the high
+// nibble so SIMD unpacking is a mask and a shift of 16 bytes.
+
+enum { q4_block = 32 }; // values per group
+
+typedef begin_packed struct q4_s {
+    fp16_t  scale;
+    uint8_t q[q4_block / 2];
+} end_packed q4_t; // 18 bytes per 32 values (4.5 bits per value)
+
+typedef begin_packed struct q4m_s {
+    fp16_t  scale;
+    fp16_t  min;
+    uint8_t q[q4_block / 2];
+} end_packed q4m_t; // 20 bytes per 32 values (5 bits per value)
+
+static_assert(sizeof(q4_t)  == 18, "q4_t size must be 18");
+static_assert(sizeof(q4m_t) == 20, "q4m_t size must be 20");
+
+inline int q4_nibble(const uint8_t* q, int i) { // i in [0..q4_block - 1]
+    return i < q4_block / 2 ? q[i] & 0xF : q[i - q4_block / 2] >> 4;
+}
+
+inline void q4_pack(uint8_t* q, const int* nibbles) {
+    for (int j = 0; j < q4_block / 2; j++) {
+        q[j] = (uint8_t)(nibbles[j] | (nibbles[j + q4_block / 2] << 4));
+    }
+}
+
+inline void fp32toq4(const fp32_t* v, q4_t* q) { // v[q4_block] -> q
+    fp32_t amax = 0;
+    for (int i = 0; i < q4_block; i++) { amax = max(amax, fabsf(v[i])); }
+    const fp32_t inv = amax != 0 ? 7.0f / amax : 0;
+    int nibbles[q4_block];
+    for (int i = 0; i < q4_block; i++) { nibbles[i] = (int)lrintf(v[i] * inv) + 8; }
+    q4_pack(q->q, nibbles);
+    q->scale = fp32to16(amax / 7.0f);
+}
+
+inline void q4to32(const q4_t* q, fp32_t* v) { // q -> v[q4_block]
+    const fp32_t scale = fp16to32(q->scale);
+    for (int i = 0; i < q4_block; i++) { v[i] = (q4_nibble(q->q, i) - 8) * scale; }
+}
+
+inline void fp32toq4m(const fp32_t* v, q4m_t* q) { // v[q4_block] -> q
+    fp32_t lo = v[0];
+    fp32_t hi = v[0];
+    for (int i = 1; i < q4_block; i++) { lo = min(lo, v[i]); hi = max(hi, v[i]); }
+    q->min = fp32to16(lo);
+    lo = fp16to32(q->min); // quantize against rounded min
+    const fp32_t scale = (hi - lo) / 15.0f;
+    const fp32_t inv = scale != 0 ? 1.0f / scale : 0;
+    int nibbles[q4_block];
+    for (int i = 0; i < q4_block; i++) {
+        const int n = (int)lrintf((v[i] - lo) * inv);
+        nibbles[i] = n < 0 ? 0 : (n > 15 ? 15 : n);
+    }
+    q4_pack(q->q, nibbles);
+    q->scale = fp32to16(scale);
+}
+
+inline void q4mto32(const q4m_t* q, fp32_t* v) { // q -> v[q4_block]
+    const fp32_t scale = fp16to32(q->scale);
+    const fp32_t lo = fp16to32(q->min);
+    for (int i = 0; i < q4_block; i++) { v[i] = q4_nibble(q->q, i) * scale + lo; }
+}
+
 #ifdef RT_IMPLEMENTATION
 
+#include <intrin.h>
+
+enum { fp16_simd_none = 0, fp16_simd_avx2 = 1, fp16_simd_avx512 = 2 };
+
+static int32_t fp16_simd_level = -1; // -1 not yet detected
+
+static int32_t fp16_simd(void) {
+    if (fp16_simd_level < 0) {
+        enum { eax = 0, ebx = 1, ecx = 2, edx = 3 };
+        int32_t level = fp16_simd_none;
+        int32_t info[4];
+        __cpuid(info, 0);
+        const int32_t max_leaf = info[eax];
+        __cpuid(info, 1);
+        const uint32_t osxsave_avx_f16c = (1U << 27) | (1U << 28) | (1U << 29);
+        if (max_leaf >= 7 && (info[ecx] & osxsave_avx_f16c) == osxsave_avx_f16c) {
+            const uint64_t xcr0 = _xgetbv(0); // YMM (0x06) and ZMM (0xE0) state
+            __cpuidex(info, 7, 0);
+            const bool avx2   = (info[ebx] & (1U << 5))  != 0;
+            const bool avx512 = (info[ebx] & (1U << 16)) != 0;
+            if (avx2 && (xcr0 & 0x06) == 0x06) { level = fp16_simd_avx2; }
+            if (avx2 && avx512 && (xcr0 & 0xE6) == 0xE6) { level = fp16_simd_avx512; }
+        }
+        fp16_simd_level = level;
+    }
+    return fp16_simd_level;
+}
+
+static void fp32to16_chunk(const void* p, void* q, int64_t n) {
+    const fp32_t* v = (const fp32_t*)p;
+    fp16_t* r = (fp16_t*)q;
+    int64_t i = 0;
+    if (fp16_simd() >= fp16_simd_avx512) {
+        for (; i + 16 <= n; i += 16) {
+            _mm256_storeu_si256((__m256i*)(r + i), _mm512_cvtps_ph(
+                _mm512_loadu_ps(v + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+    }
+    if (fp16_simd() >= fp16_simd_avx2) {
+        for (; i + 8 <= n; i += 8) {
+            _mm_storeu_si128((__m128i*)(r + i), _mm256_cvtps_ph(
+                _mm256_loadu_ps(v + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+    }
+    for (; i < n; i++) { r[i] = fp32to16_rne(v[i]); }
+}
+
+static void fp16to32_chunk(const void* p, void* q, int64_t n) {
+    const fp16_t* v = (const fp16_t*)p;
+    fp32_t* r = (fp32_t*)q;
+    int64_t i = 0;
+    if (fp16_simd() >= fp16_simd_avx512) {
+        for (; i + 16 <= n; i += 16) {
+            _mm512_storeu_ps(r + i, _mm512_cvtph_ps(
+                _mm256_loadu_si256((const __m256i*)(v + i))));
+        }
+    }
+    if (fp16_simd() >= fp16_simd_avx2) {
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(r + i, _mm256_cvtph_ps(
+                _mm_loadu_si128((const __m128i*)(v + i))));
+        }
+    }
+    for (; i < n; i++) { r[i] = fp16to32(v[i]); }
+}
+
+// bf32to16_rne() rounding: (u + 0x7FFF + lsb) >> 16 for all but NaNs
+// which are made quiet instead (see bf32to16_rne() above)
+
+static inline __m256i bf32to16_avx2(__m256 f) { // -> 8 x uint32 [0..0xFFFF]
+    const __m256i u = _mm256_castps_si256(f);
+    const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+    const __m256i rne = _mm256_add_epi32(u, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+    const __m256i nan = _mm256_cmpgt_epi32(
+        _mm256_and_si256(u, _mm256_set1_epi32(0x7FFFFFFF)), _mm256_set1_epi32(0x7F800000));
+    const __m256i quiet = _mm256_or_si256(u, _mm256_set1_epi32(0x00400000));
+    return _mm256_srli_epi32(_mm256_blendv_epi8(rne, quiet, nan), 16);
+}
+
+static inline __m512i bf32to16_avx512(__m512 f) { // -> 16 x uint32 [0..0xFFFF]
+    const __m512i u = _mm512_castps_si512(f);
+    const __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+    const __m512i rne = _mm512_add_epi32(u, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF)));
+    const __mmask16 nan = _mm512_cmpgt_epi32_mask(
+        _mm512_and_si512(u, _mm512_set1_epi32(0x7FFFFFFF)), _mm512_set1_epi32(0x7F800000));
+    const __m512i quiet = _mm512_or_si512(u, _mm512_set1_epi32(0x00400000));
+    return _mm512_srli_epi32(_mm512_mask_blend_epi32(nan, rne, quiet), 16);
+}
+
+static void bf32to16_chunk(const void* p, void* q, int64_t n) {
+    const fp32_t* v = (const fp32_t*)p;
+    bf16_t* r = (bf16_t*)q;
+    int64_t i = 0;
+    if (fp16_simd() >= fp16_simd_avx512) {
+        for (; i + 16 <= n; i += 16) {
+            _mm256_storeu_si256((__m256i*)(r + i),
+                _mm512_cvtepi32_epi16(bf32to16_avx512(_mm512_loadu_ps(v + i))));
+        }
+    }
+    if (fp16_simd() >= fp16_simd_avx2) {
+        for (; i + 16 <= n; i += 16) {
+            // packus interleaves 128-bit lanes: a0..3 b0..3 a4..7 b4..7
+            const __m256i ab = _mm256_packus_epi32(
+                bf32to16_avx2(_mm256_loadu_ps(v + i)),
+                bf32to16_avx2(_mm256_loadu_ps(v + i + 8)));
+            _mm256_storeu_si256((__m256i*)(r + i),
+                _mm256_permute4x64_epi64(ab, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+    }
+    for (; i < n; i++) { r[i] = bf32to16_rne(v[i]); }
+}
+
+static void bf16to32_chunk(const void* p, void* q, int64_t n) {
+    const bf16_t* v = (const bf16_t*)p;
+    fp32_t* r = (fp32_t*)q;
+    int64_t i = 0;
+    if (fp16_simd() >= fp16_simd_avx512) {
+        for (; i + 16 <= n; i += 16) {
+            _mm512_storeu_si512(r + i, _mm512_slli_epi32(_mm512_cvtepu16_epi32(
+                _mm256_loadu_si256((const __m256i*)(v + i))), 16));
+        }
+    }
+    if (fp16_simd() >= fp16_simd_avx2) {
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_si256((__m256i*)(r + i), _mm256_slli_epi32(
+                _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(v + i))), 16));
+        }
+    }
+    for (; i < n; i++) { r[i] = bf16to32(v[i]); }
+}
+
+enum { fp16_chunk = 64 * 1024 }; // elements per parallel() task
+
+typedef struct fp16_convert_s {
+    const byte_t* v;
+    byte_t* r;
+    int64_t n;
+    int32_t vb; // bytes per v[] and r[] element
+    int32_t rb;
+    void (*chunk)(const void* v, void* r, int64_t n);
+} fp16_convert_t;
+
+static void fp16_convert_task(void* that, int32_t i) {
+    fp16_convert_t* c = (fp16_convert_t*)that;
+    const int64_t i0 = (int64_t)i * fp16_chunk;
+    c->chunk(c->v + i0 * c->vb, c->r + i0 * c->rb, min(c->n - i0, fp16_chunk));
+}
+
+static void fp16_convert(fp16_convert_t* c) {
+    const int64_t chunks = (c->n + fp16_chunk - 1) / fp16_chunk;
+    if (chunks <= 1) {
+        c->chunk(c->v, c->r, c->n);
+    } else {
+        parallel((int32_t)chunks, fp16_convert_task, c);
+    }
+}
+
+void fp32to16_n(const fp32_t* v, fp16_t* r, int64_t n) {
+    fp16_convert_t c = { .v = (const byte_t*)v, .r = (byte_t*)r, .n = n,
+        .vb = sizeof(fp32_t), .rb = sizeof(fp16_t), .chunk = fp32to16_chunk };
+    fp16_convert(&c);
+}
+
+void fp16to32_n(const fp16_t* v, fp32_t* r, int64_t n) {
+    fp16_convert_t c = { .v = (const byte_t*)v, .r = (byte_t*)r, .n = n,
+        .vb = sizeof(fp16_t), .rb = sizeof(fp32_t), .chunk = fp16to32_chunk };
+    fp16_convert(&c);
+}
+
+void bf32to16_n(const fp32_t* v, bf16_t* r, int64_t n) {
+    fp16_convert_t c = { .v = (const byte_t*)v, .r = (byte_t*)r, .n = n,
+        .vb = sizeof(fp32_t), .rb = sizeof(bf16_t), .chunk = bf32to16_chunk };
+    fp16_convert(&c);
+}
+
+void bf16to32_n(const bf16_t* v, fp32_t* r, int64_t n) {
+    fp16_convert_t c = { .v = (const byte_t*)v, .r = (byte_t*)r, .n = n,
+        .vb = sizeof(bf16_t), .rb = sizeof(fp32_t), .chunk = bf16to32_chunk };
+    fp16_convert(&c);
+}
+
 #ifdef FP16_TESTS
 
+static void fp16_rne_test(void) {
+    // ties go to even, scalar fp32to16() and bf32to16() keep truncating:
+    const fp32_t tie16  = 1.0f + (fp32_t)pow(2, -11); // half ulp of fp16 1.0
+    const fp32_t over16 = 1.0f + (fp32_t)pow(2, -11) * 3;
+    assert(fp32to16_rne(tie16).bytes  == 0x3C00);
+    assert(fp32to16_rne(over16).bytes == 0x3C02);
+    assert(fp32to16(over16).bytes     == 0x3C01);
+    assert(fp32to16_rne(65520.0f).bytes == 0x7C00); // rounds up to inf
+    assert(fp32to16(65520.0f).bytes     == 0x7BFF);
+    assert(fp32to16_rne(-0.0f).bytes    == 0x8000);
+    const fp32_t tie_bf  = 1.0f + (fp32_t)pow(2, -8); // half ulp of bf16 1.0
+    const fp32_t over_bf = 1.0f + (fp32_t)pow(2, -8) * 3;
+    assert(bf32to16_rne(tie_bf).bytes  == 0x3F80);
+    assert(bf32to16_rne(over_bf).bytes == 0x3F82);
+    assert(bf32to16(over_bf).bytes     == 0x3F81);
+    const uint32_t snan = 0x7F800001; // payload below bf16 mantissa bits
+    assert(isnan(bf16to32(bf32to16_rne(*(fp32_t*)&snan))));
+}
+
+static void fp16_n_test(void) {
+    // SIMD and scalar bulk conversions must match bit for bit
+    enum { n = 3 * fp16_chunk + 13, k = 64 * 1024 };
+    static fp32_t f32[n];
+    static fp32_t r0[n];
+    static fp32_t r1[n];
+    static fp16_t h0[n];
+    static fp16_t h1[n];
+    static bf16_t b0[n];
+    static bf16_t b1[n];
+    uint32_t seed = 1;
+    for (int i = 0; i < n; i++) {
+        if (i % 2 == 0) { // any bits: NaNs, infinities, subnormals
+            const uint32_t u = random32(&seed);
+            f32[i] = *(fp32_t*)&u;
+        } else { // fp16 normal, subnormal and overflow range
+            f32[i] = (random32(&seed) / (fp32_t)UINT32_MAX - 0.5f) *
+                     (fp32_t)pow(2, 18 - i % 44);
+        }
+    }
+    const int32_t level = fp16_simd();
+    fp16_simd_level = fp16_simd_none;
+    fp32to16_n(f32, h0, n);
+    bf32to16_n(f32, b0, n);
+    fp16_simd_level = level;
+    fp32to16_n(f32, h1, n);
+    bf32to16_n(f32, b1, n);
+    for (int i = 0; i < n; i++) {
+        assert(h0[i].bytes == fp32to16_rne(f32[i]).bytes);
+        assert(b0[i].bytes == bf32to16_rne(f32[i]).bytes);
+        assert(h0[i].bytes == h1[i].bytes, "%.7e 0x%04X 0x%04X", f32[i], h0[i].bytes, h1[i].bytes);
+        assert(b0[i].bytes == b1[i].bytes, "%.7e 0x%04X 0x%04X", f32[i], b0[i].bytes, b1[i].bytes);
+        const fp32_t bf = bf16to32(b0[i]); // nearest of two neighbours:
+        const uint32_t u = *(uint32_t*)&f32[i] & 0xFFFF0000;
+        if (isfinite(bf) && isfinite(f32[i])) {
+            const fp32_t lo = *(fp32_t*)&u;
+            const uint32_t u1 = u + 0x10000;
+            const fp32_t hi = *(fp32_t*)&u1;
+            assert(fabs(bf - f32[i]) <= min(fabs(lo - f32[i]), fabs(hi - f32[i])));
+        }
+    }
+    for (int i = 0; i < k; i++) { h0[i].bytes = (uint16_t)i; b0[i].bytes = (uint16_t)i; }
+    fp16_simd_level = fp16_simd_none;
+    fp16to32_n(h0, r0, k);
+    bf16to32_n(b0, f32, k);
+    fp16_simd_level = level;
+    fp16to32_n(h0, r1, k);
+    bf16to32_n(b0, f32 + k, k);
+    for (int i = 0; i < k; i++) {
+        if (!fp16_isnan(h0[i])) { // vcvtph2ps makes signaling NaNs quiet
+            assert(*(uint32_t*)&r0[i] == *(uint32_t*)&r1[i], "0x%04X", i);
+        } else {
+            assert(isnan(r0[i]) && isnan(r1[i]));
+        }
+        assert(*(uint32_t*)&f32[i] == *(uint32_t*)&f32[k + i], "0x%04X", i);
+    }
+}
+
 void fp16_test() {
 #if 0
     #define dump_f16(label, v) println("%-35s 0x%04X %.7E", label, v.bytes, fp16to32(v))
@@ -264,6 +661,11 @@ void fp16_test() {
     assert(fp16_equ(one, fp16x(0x3C00)));
     fp16_t two = fp32to16(2.0);
     assert(fp16_equ(two, fp16_add(one, one)));
+    {   // sign of zero survives both directions:
+        const fp32_t negative_zero = fp16to32(fp16x(0x8000));
+        assert(*(uint32_t*)&negative_zero == 0x80000000);
+        assert(fp32to16(-0.0f).bytes == 0x8000);
+    }
     fp16_t nan   = FP16_NAN;
     fp16_t inf_p = FP16_PINF;
     fp16_t inf_n = FP16_NINF;
@@ -406,6 +808,8 @@ void fp16_test() {
             assert(fp16to32(f16i) == f32i);
         }
     }
+    fp16_rne_test();
+    fp16_n_test();
 }
 
 #endif // FP16_TESTS
@@ -1,11 +1,29 @@
 #include "gemv.h"
 
-static void ocl_gemv(gemv_t* g, int fpp,
+enum { gemv_tile_bytes = 256 * 1024 * 1024 }; // default stream() tile
+
+enum { gemv_max_chunks = 64 }; // transposed() row chunks partial sums
+
+// stream() pinned host staging buffers, mapped for writing:
+enum { gemv_staging = CL_MEM_READ_ONLY|CL_MEM_HOST_WRITE_ONLY };
+
+static const char* gemv_kernel_name[5][4] = {
+    {"gemv16",    "gemv32",    "gemv64",    "bfmv16"},
+    {"gemv16x4",  "gemv32x4",  "gemv64x4",  "bfmv16x4"},
+    {"gemv16x16", "gemv32x16", "gemv64x16", "bfmv16x16"},
+    {"gemvt16",   "gemvt32",   "gemvt64",   "bfmvt16"}, // transposed
+    {"gemv16x16_batch", "gemv32x16_batch", "gemv64x16_batch", "bfmv16x16_batch"}
+};
+
+static ocl_kernel_t gemv_fused_kernel(gemv_t* g, int fpp, int activation,
+    int xn);
+
+static ocl_event_t gemv_enqueue(gemv_t* g, int fpp,
         intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
         intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
         intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
-        int64_t n, int64_t m) {
-    if (ocl.is_profiling(g->c)) { g->c->ov->profiling_count = 0; }
+        int64_t n, int64_t m, const gemv_epilogue_t* e,
+        int waits, const ocl_event_t wait[], int64_t* row_width) {
     ocl_device_t* d = &ocl.devices[g->c->ix];
     int xn = n % 16 == 0 ? 16 : (n % 4 == 0) ? 4 : 1;
     const int accu = fpp == ocl_fpp64 ? 8 : 4; // accumulator vc[] element
@@ -17,25 +35,55 @@ static void ocl_gemv(gemv_t* g, int fpp,
     if (vc_offset % (xn * accu) != 0) { xn = 1; }
     if (rs_offset % (xn * accu) != 0) { xn = 1; }
     // row width in fp_t or vec4 of fpXX_t elements
-    const int64_t rw = n / xn; // row[] width
-    ocl_kernel_t k = xn == 16 ? g->kernel16x[fpp] :
-                    (xn ==  4 ? g->kernel4x[fpp] : g->kernel[fpp]);
+    int64_t rw = n / xn; // row[] width
+    ocl_kernel_t k = e != null ? gemv_fused_kernel(g, fpp, e->activation, xn) :
+                    (xn == 16 ? g->kernel16x[fpp] :
+                    (xn ==  4 ? g->kernel4x[fpp] : g->kernel[fpp]));
     int64_t items_per_group = min(d->max_items[0], rw);
     int64_t local_bytes = ocl_fpp_bytes[fpp] * items_per_group *
         max(d->max_subgroups, 1);
+    // epilogue alpha and beta are accu_t on the device side:
+    fp64_t alpha64 = e != null ? e->alpha : 0;
+    fp64_t beta64  = e != null ? e->beta  : 0;
+    fp32_t alpha32 = (fp32_t)alpha64;
+    fp32_t beta32  = (fp32_t)beta64;
+    intptr_t bias_offset = e != null ? e->bias_offset : 0;
+    ocl_memory_t bias = e != null ? e->bias : null;
+    const bool fp64 = fpp == ocl_fpp64;
+    ocl_arg_t argv[] = {
+        { &mx_offset, sizeof(intptr_t) },
+        { &mx,        sizeof(ocl_memory_t) },
+        { &vc_offset, sizeof(intptr_t) },
+        { &vc,        sizeof(ocl_memory_t) },
+        { &rs_offset, sizeof(intptr_t) },
+        { &rs,        sizeof(ocl_memory_t) },
+        { null,       local_bytes }, // shared memory for all work-items inside group
+        { &rw,        sizeof(int32_t) },
+        { &m,         sizeof(int32_t) },
+        // fused epilogue only:
+        { fp64 ? (void*)&alpha64 : (void*)&alpha32, fp64 ? sizeof(fp64_t) : sizeof(fp32_t) },
+        { fp64 ? (void*)&beta64  : (void*)&beta32,  fp64 ? sizeof(fp64_t) : sizeof(fp32_t) },
+        { &bias_offset, sizeof(intptr_t) },
+        { &bias,        sizeof(ocl_memory_t) }
+    };
+    const int argc = e != null ? countof(argv) : countof(argv) - 4;
     // if n > max items per group GPU will run multiple groups:
-    ocl_event_t done = ocl.enqueue(g->c, k, rw,
-        &mx_offset, sizeof(intptr_t),
-        &mx,        sizeof(ocl_memory_t),
-        &vc_offset, sizeof(intptr_t),
-        &vc,        sizeof(ocl_memory_t),
-        &rs_offset, sizeof(intptr_t),
-        &rs,        sizeof(ocl_memory_t),
-        null,       local_bytes, // shared memory for all work-items inside group
-        &rw,        sizeof(int32_t),
-        &m,         sizeof(int32_t),
-        null, 0
-    );
+    ocl_event_t done = ocl.enqueue_wait(g->c, k, 1, &rw, null, argc, argv,
+        waits, wait);
+    *row_width = rw;
+    return done;
+}
+
+static void ocl_gemv(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m) {
+    if (ocl.is_profiling(g->c)) { g->c->ov->profiling_count = 0; }
+    int64_t rw = 0;
+    ocl_event_t done = gemv_enqueue(g, fpp, mx_offset, mx, vc_offset, vc,
+        rs_offset, rs, n, m, null, 0, null, &rw);
+    const int64_t xn = n / rw;
     if (ocl.is_profiling(g->c)) { ocl.profile_add(g->c, done); }
     ocl.finish(g->c);
     ocl.release_event(done); // p->e is still holding it
@@ -48,7 +96,388 @@ static void ocl_gemv(gemv_t* g, int fpp,
     }
 }
 
-static const char* gemv_program_options(gemv_t* g, int fpp) {
+static void gemv_stream_begin(gemv_t* g, int fpp, const void* mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m, int64_t tile_bytes, ocl_double_buffer_t* db) {
+    // Chunked streaming: tiles alternate between two device buffers
+    // (ocl_double_buffer_t) uploaded on the transfer queue. Upload of tile
+    // i + 2 waits for kernel of tile i to finish reading the same buffer.
+    // Upload of tile i + 1 may overlap with the kernel of tile i: this is
+    // up to the device (copy engines) and the driver, a single in-order
+    // queue would serialize them.
+    // Tiles are copied from (pageable) mx to pinned staging buffers and
+    // DMA uploads them from there.
+    // Not profiled: ocl.profile() expects one kernel per call.
+    const int accu = fpp == ocl_fpp64 ? 8 : 4; // accumulator rs[] element
+    const int64_t row_bytes = n * ocl_fpp_bytes[fpp];
+    if (tile_bytes <= 0) { tile_bytes = gemv_tile_bytes; }
+    int64_t rows = min(max(tile_bytes / row_bytes, 1), m);
+    // multiple of 16 rows keeps rs_offset aligned for vec4 x 4 kernels:
+    if (rows > 16 && rows < m) { rows = rows / 16 * 16; }
+    ocl_memory_t tile[2] = {
+        ocl.pool_get(&g->pool, CL_MEM_READ_ONLY, (size_t)(rows * row_bytes)),
+        m > rows ?
+        ocl.pool_get(&g->pool, CL_MEM_READ_ONLY, (size_t)(rows * row_bytes)) : null
+    };
+    ocl_memory_t staging[2] = {
+        ocl.pool_get(&g->pool, gemv_staging, (size_t)(rows * row_bytes)),
+        m > rows ?
+        ocl.pool_get(&g->pool, gemv_staging, (size_t)(rows * row_bytes)) : null
+    };
+    ocl.double_buffer_init(db, g->c, tile[0], tile[1],
+        staging[0], staging[1], (size_t)(rows * row_bytes));
+    const byte_t* p = (const byte_t*)mx;
+    for (int64_t y = 0; y < m; y += rows) {
+        const int64_t k = min(rows, m - y);
+        ocl_event_t uploaded = null;
+        ocl_memory_t t = ocl.double_buffer_upload(db, p + y * row_bytes,
+            (size_t)(k * row_bytes), &uploaded);
+        int64_t rw = 0;
+        ocl_event_t done = gemv_enqueue(g, fpp, 0, t, vc_offset, vc,
+            rs_offset + y * accu, rs, n, k, null, 1, &uploaded, &rw);
+        ocl.double_buffer_consumed(db, done);
+        ocl.release_event(done);
+        ocl.flush(g->c); // start compute of this tile now
+    }
+}
+
+static void gemv_stream_end(gemv_t* g, ocl_double_buffer_t* db) {
+    ocl_memory_t tile[2] = { db->buffer[0], db->buffer[1] };
+    ocl_memory_t staging[2] = { db->staging[0], db->staging[1] };
+    ocl.double_buffer_fini(db);
+    ocl.finish(g->c);
+    ocl.pool_put(&g->pool, staging[1]);
+    ocl.pool_put(&g->pool, staging[0]);
+    ocl.pool_put(&g->pool, tile[1]);
+    ocl.pool_put(&g->pool, tile[0]);
+}
+
+static void gemv_stream(gemv_t* g, int fpp, const void* mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m, int64_t tile_bytes) {
+    ocl_double_buffer_t db;
+    gemv_stream_begin(g, fpp, mx, vc_offset, vc, rs_offset, rs, n, m,
+        tile_bytes, &db);
+    gemv_stream_end(g, &db);
+}
+
+static void gemv_calibrate(gemv_t* g, int fpp) {
+    // throughput[fpp] of gemv() on device resident matrix and
+    // streaming[fpp] of stream() (host matrix upload and gemv) in bytes/s
+    enum { n = 4 * 1024, m = 1024 }; // 4M elements probe
+    if (g->kernel[fpp] == null) { return; }
+    const int accu = fpp == ocl_fpp64 ? 8 : 4;
+    const int64_t bytes = (int64_t)n * m * ocl_fpp_bytes[fpp];
+    void* mx = calloc(1, (size_t)bytes);
+    fatal_if(mx == null, "out of memory");
+    ocl_memory_t vc = ocl.pool_get(&g->pool, CL_MEM_READ_ONLY, n * accu);
+    ocl_memory_t rs = ocl.pool_get(&g->pool, CL_MEM_WRITE_ONLY, m * accu);
+    ocl_memory_t md = ocl.pool_get(&g->pool, CL_MEM_READ_ONLY, (size_t)bytes);
+    ocl.release_event(ocl.write(g->c, md, 0, (size_t)bytes, mx));
+    fp64_t resident = DBL_MAX;
+    fp64_t streamed = DBL_MAX;
+    for (int repeat = 0; repeat < 3; repeat++) { // first run is warm up
+        fp64_t t = seconds();
+        int64_t rw = 0;
+        ocl.release_event(gemv_enqueue(g, fpp, 0, md, 0, vc, 0, rs, n, m,
+            null, 0, null, &rw));
+        ocl.finish(g->c);
+        t = seconds() - t;
+        if (repeat > 0) { resident = min(resident, t); }
+        t = seconds();
+        gemv_stream(g, fpp, mx, 0, vc, 0, rs, n, m, 0);
+        t = seconds() - t;
+        if (repeat > 0) { streamed = min(streamed, t); }
+    }
+    g->throughput[fpp] = bytes / max(resident, 1e-9);
+    g->streaming[fpp]  = bytes / max(streamed, 1e-9);
+    ocl.pool_put(&g->pool, md);
+    ocl.pool_put(&g->pool, rs);
+    ocl.pool_put(&g->pool, vc);
+    free(mx);
+}
+
+static void gemv_multi_split(gemv_multi_t* mm, const bool fits[]) {
+    // rows proportional to calibrated throughput (resident) or streaming
+    // (does not fit), equal split if any capable device is not calibrated
+    const int fpp = mm->fpp;
+    fp64_t weight[gemv_max_devices] = {0};
+    bool calibrated = true;
+    for (int i = 0; i < mm->count; i++) {
+        gemv_t* g = mm->g[i];
+        if (g->kernel[fpp] != null) {
+            weight[i] = fits[i] ? g->throughput[fpp] : g->streaming[fpp];
+            calibrated = calibrated && weight[i] > 0;
+        }
+    }
+    fp64_t total = 0;
+    for (int i = 0; i < mm->count; i++) {
+        if (!calibrated && mm->g[i]->kernel[fpp] != null) { weight[i] = 1; }
+        total += weight[i];
+    }
+    fatal_if(total == 0, "%s is not supported", ocl_fpp_names[fpp]);
+    int last = -1; // last capable device gets remaining rows
+    int64_t assigned = 0;
+    for (int i = 0; i < mm->count; i++) {
+        mm->rows[i] = 0;
+        if (weight[i] > 0) {
+            // multiple of 16 rows (see stream()):
+            mm->rows[i] = (int64_t)(mm->m * (weight[i] / total)) / 16 * 16;
+            assigned += mm->rows[i];
+            last = i;
+        }
+    }
+    mm->rows[last] += mm->m - assigned;
+}
+
+static void gemv_multi_init(gemv_multi_t* mm, gemv_t* g[], int count,
+        int fpp, const void* mx/*[m][n]*/, int64_t n, int64_t m) {
+    // Rows are partitioned once: each device share that fits into half
+    // of the device memory is uploaded and stays resident, otherwise
+    // multi() streams it from host mx on every call.
+    fatal_if(count <= 0 || count > gemv_max_devices, "count: %d", count);
+    memset(mm, 0, sizeof(*mm));
+    for (int i = 0; i < count; i++) { mm->g[i] = g[i]; }
+    mm->count = count;
+    mm->fpp = fpp;
+    mm->mx = mx;
+    mm->n = n;
+    mm->m = m;
+    const int accu = fpp == ocl_fpp64 ? 8 : 4;
+    const int64_t row_bytes = n * ocl_fpp_bytes[fpp];
+    bool fits[gemv_max_devices];
+    for (int i = 0; i < count; i++) { fits[i] = true; }
+    gemv_multi_split(mm, fits);
+    bool refit = false;
+    for (int i = 0; i < count; i++) {
+        const int64_t limit = ocl.devices[g[i]->c->ix].global_memory / 2;
+        fits[i] = mm->rows[i] * row_bytes <= limit;
+        refit = refit || !fits[i];
+    }
+    if (refit) { gemv_multi_split(mm, fits); } // with streaming[] weights
+    int64_t y = 0;
+    for (int i = 0; i < count; i++) {
+        if (mm->rows[i] > 0) {
+            ocl_context_t* c = g[i]->c;
+            const size_t bytes = (size_t)(mm->rows[i] * row_bytes);
+            mm->vc[i] = ocl.allocate(c, CL_MEM_READ_ONLY, n * accu);
+            mm->rs[i] = ocl.allocate(c, CL_MEM_WRITE_ONLY, mm->rows[i] * accu);
+            // alloc() returns null instead of failing: stream the share
+            mm->resident[i] = fits[i] ?
+                ocl.alloc(c, CL_MEM_READ_ONLY|CL_MEM_HOST_WRITE_ONLY, bytes) : null;
+            if (mm->resident[i] != null) {
+                ocl.release_event(ocl.write(c, mm->resident[i], 0, bytes,
+                    (const byte_t*)mx + y * row_bytes));
+                ocl.flush(c); // all devices upload at once
+            }
+            y += mm->rows[i];
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (mm->resident[i] != null) { ocl.finish(g[i]->c); }
+    }
+}
+
+static void gemv_multi(gemv_multi_t* mm, const void* vc/*[n]*/,
+        void* rs/*[m]*/) {
+    // Per call only vc[] is uploaded and the rs[] share read back from
+    // every device (streamed shares upload their rows too). All devices
+    // are enqueued before waiting for any of them so they run at once.
+    const int fpp = mm->fpp;
+    const int64_t n = mm->n;
+    const int accu = fpp == ocl_fpp64 ? 8 : 4;
+    const int64_t row_bytes = n * ocl_fpp_bytes[fpp];
+    ocl_double_buffer_t db[gemv_max_devices];
+    int64_t y = 0;
+    for (int i = 0; i < mm->count; i++) {
+        const int64_t rows = mm->rows[i];
+        if (rows > 0) {
+            gemv_t* g = mm->g[i];
+            ocl_context_t* c = g->c;
+            // vc[] upload is on the same in order queue as the kernels:
+            ocl.release_event(ocl.write(c, mm->vc[i], 0, n * accu, vc));
+            if (mm->resident[i] != null) {
+                int64_t rw = 0;
+                ocl.release_event(gemv_enqueue(g, fpp, 0, mm->resident[i],
+                    0, mm->vc[i], 0, mm->rs[i], n, rows, null, 0, null, &rw));
+            } else {
+                gemv_stream_begin(g, fpp, (const byte_t*)mm->mx + y * row_bytes,
+                    0, mm->vc[i], 0, mm->rs[i], n, rows, 0, &db[i]);
+            }
+            ocl.release_event(ocl.read(c, mm->rs[i], 0, rows * accu,
+                (byte_t*)rs + y * accu));
+            ocl.flush(c);
+            y += rows;
+        }
+    }
+    for (int i = 0; i < mm->count; i++) {
+        if (mm->rows[i] > 0) {
+            if (mm->resident[i] != null) {
+                ocl.finish(mm->g[i]->c); // includes read()
+            } else {
+                gemv_stream_end(mm->g[i], &db[i]); // ocl.finish() includes read()
+            }
+        }
+    }
+}
+
+static void gemv_multi_fini(gemv_multi_t* mm) {
+    for (int i = 0; i < mm->count; i++) {
+        ocl.deallocate(mm->resident[i]);
+        ocl.deallocate(mm->rs[i]);
+        ocl.deallocate(mm->vc[i]);
+    }
+    memset(mm, 0, sizeof(*mm));
+}
+
+static void gemv_transposed(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[m]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[n]*/,
+        int64_t n, int64_t m) {
+    if (ocl.is_profiling(g->c)) { g->c->ov->profiling_count = 0; }
+    ocl_device_t* d = &ocl.devices[g->c->ix];
+    const int64_t accu = fpp == ocl_fpp64 ? 8 : 4; // accumulator rs[] element
+    // dimension 0: 4 columns per work item, dimension 1: lsy (power of 2)
+    // work items stride over each of the "chunks" row chunks:
+    const int64_t cols = (n + 3) / 4;
+    int64_t lsx = min(min(cols, 16), d->max_items[0]);
+    int64_t lsy = 1;
+    while (lsy < 16 && lsy * 2 <= d->max_items[1] &&
+           lsx * lsy * 2 <= d->max_groups) {
+        lsy *= 2;
+    }
+    // at least 64 rows per work item, up to gemv_max_chunks partial sums:
+    int64_t chunks = max(1, min(m / (lsy * 64), gemv_max_chunks));
+    int64_t rows = (m + chunks - 1) / chunks;
+    chunks = (m + rows - 1) / rows;
+    ocl_memory_t ps = chunks > 1 ? ocl.pool_get(&g->pool, CL_MEM_READ_WRITE,
+        (size_t)(chunks * n * accu)) : rs;
+    intptr_t ps_offset = chunks > 1 ? 0 : rs_offset;
+    const int64_t global[2] = { (cols + lsx - 1) / lsx * lsx, chunks * lsy };
+    const int64_t local[2]  = { lsx, lsy };
+    ocl_arg_t argv[] = {
+        { &mx_offset, sizeof(intptr_t) },
+        { &mx,        sizeof(ocl_memory_t) },
+        { &vc_offset, sizeof(intptr_t) },
+        { &vc,        sizeof(ocl_memory_t) },
+        { &ps_offset, sizeof(intptr_t) },
+        { &ps,        sizeof(ocl_memory_t) },
+        { null,       (size_t)(lsx * lsy * 4 * accu) }, // sm[lsy][lsx] acc4_t
+        { &n,         sizeof(int32_t) },
+        { &m,         sizeof(int32_t) },
+        { &rows,      sizeof(int32_t) }
+    };
+    ocl_event_t done = ocl.enqueue_range(g->c, g->transposed[fpp], 2,
+        global, local, countof(argv), argv);
+    if (ocl.is_profiling(g->c)) { ocl.profile_add(g->c, done); }
+    ocl_event_t sum = null;
+    if (chunks > 1) {
+        ocl_arg_t args[] = {
+            { &ps_offset, sizeof(intptr_t) },
+            { &ps,        sizeof(ocl_memory_t) },
+            { &rs_offset, sizeof(intptr_t) },
+            { &rs,        sizeof(ocl_memory_t) },
+            { &n,         sizeof(int32_t) },
+            { &chunks,    sizeof(int32_t) }
+        };
+        sum = ocl.enqueue_wait(g->c, g->transposed_sum[fpp], 1, &n, null,
+            countof(args), args, 1, &done);
+    }
+    ocl.finish(g->c);
+    ocl.release_event(done); // p->e is still holding it
+    if (sum != null) { ocl.release_event(sum); }
+    if (chunks > 1) { ocl.pool_put(&g->pool, ps); }
+    if (ocl.is_profiling(g->c)) {
+        // gemvt_sum() is not profiled: ocl.profile() expects one kernel
+        ocl_profiling_t* p = &g->c->ov->profiling[0];
+        p[0].count  = global[0] * global[1]; // kernel invocations
+        p[0].fops   = (rows + lsy - 1) / lsy * 8; // fp ops
+        p[0].i32ops = (rows + lsy - 1) / lsy * 3; // indexing ops
+        ocl.profile(&p[0]); // p->e will be released
+    }
+}
+
+static void gemv_batch(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[batch][n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[batch][m]*/,
+        int64_t n, int64_t m, int64_t batch) {
+    // Not profiled: ocl.profile() expects one kernel per call.
+    ocl_device_t* d = &ocl.devices[g->c->ix];
+    const int accu = fpp == ocl_fpp64 ? 8 : 4; // accumulator vc[] element
+    const bool x16 = n % 16 == 0 &&
+        mx_offset % (16 * ocl_fpp_bytes[fpp]) == 0 &&
+        vc_offset % (16 * accu) == 0;
+    for (int64_t b = 0; b < batch; b += gemv_max_batch) {
+        int64_t k = min(batch - b, gemv_max_batch);
+        intptr_t vo = vc_offset + b * n * accu;
+        intptr_t ro = rs_offset + b * m * accu;
+        if (x16) {
+            int64_t rw = n / 16; // row[] width in 4 x vec4
+            // sm[max_batch][items] accu_t for single pass reduction
+            // must fit into device local memory:
+            int64_t items = min(min(d->max_items[0], d->max_groups), rw);
+            items = max(1, min(items, d->local_memory / (accu * gemv_max_batch)));
+            // work groups stride over rows, 2 groups per compute unit
+            // (see gemv.1.c) but not more groups than rows:
+            const int64_t groups = max(1, min(m, d->compute_units * 2));
+            const int64_t global = groups * items;
+            ocl_arg_t argv[] = {
+                { &mx_offset, sizeof(intptr_t) },
+                { &mx,        sizeof(ocl_memory_t) },
+                { &vo,        sizeof(intptr_t) },
+                { &vc,        sizeof(ocl_memory_t) },
+                { &ro,        sizeof(intptr_t) },
+                { &rs,        sizeof(ocl_memory_t) },
+                { null,       (size_t)(accu * items * gemv_max_batch) },
+                { &rw,        sizeof(int32_t) },
+                { &m,         sizeof(int32_t) },
+                { &k,         sizeof(int32_t) }
+            };
+            ocl.release_event(ocl.enqueue_range(g->c, g->batched[fpp], 1,
+                &global, &items, countof(argv), argv));
+        } else {
+            for (int64_t i = 0; i < k; i++) {
+                int64_t rw = 0;
+                ocl.release_event(gemv_enqueue(g, fpp, mx_offset, mx,
+                    vo + i * n * accu, vc, ro + i * m * accu, rs, n, m,
+                    null, 0, null, &rw));
+            }
+        }
+    }
+    ocl.finish(g->c);
+}
+
+static void gemv_fused(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m, const gemv_epilogue_t* e) {
+    fatal_if(e == null || !(0 <= e->activation && e->activation < gemv_activations));
+    int64_t rw = 0;
+    ocl.release_event(gemv_enqueue(g, fpp, mx_offset, mx, vc_offset, vc,
+        rs_offset, rs, n, m, e, 0, null, &rw));
+    ocl.finish(g->c);
+}
+
+static ocl_event_t gemv_async(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m, const gemv_epilogue_t* e,
+        int waits, const ocl_event_t wait[]) {
+    // Not profiled: caller owns the returned event.
+    fatal_if(e != null && !(0 <= e->activation && e->activation < gemv_activations));
+    int64_t rw = 0;
+    return gemv_enqueue(g, fpp, mx_offset, mx, vc_offset, vc,
+        rs_offset, rs, n, m, e, waits, wait, &rw);
+}
+
+static const char* gemv_program_options(gemv_t* g, int fpp,
+        bool fused, int activation) {
     const ocl_device_t* d = &ocl.devices[g->c->ix];
     static char options[4096];
     char* p = options;
@@ -62,7 +491,7 @@ static const char* gemv_program_options(gemv_t* g, int fpp) {
     static const char* vec4_t[] = {"fp16x4_t", "fp32x4_t", "fp64x4_t", "bf16x4_t"};
     // accu_t sum += ...
     static const char* accu_t[] = {"fp32_t", "fp32_t", "fp64_t", "fp32_t"};
-    static const char* acc4_t[] = {"fp32x4_t", "fp32x4_t", "fp64x5_t", "fp32x4_t"};
+    static const char* acc4_t[] = {"fp32x4_t", "fp32x4_t", "fp64x4_t", "fp32x4_t"};
     static const int   accu_b[] = {32, 32, 64, 32}; // bits in accu_t type
     append("-D fp_t=%s -D accu=%d -D accu_t=%s -D acc4_t=%s -D fpp=%d ",
         type_t[fpp], accu_b[fpp], accu_t[fpp], acc4_t[fpp], ocl_fpp_bytes[fpp] * 8);
@@ -71,6 +500,7 @@ static const char* gemv_program_options(gemv_t* g, int fpp) {
     } else { // (fpp != ocl_bfp16) bf16 does not have vec4
         append("-D fpv4_t=%s ", vec4_t[fpp]);
     }
+    if (fused) { append("-D epilogue=1 -D activation=%d ", activation); }
     append("-D max_subgroups=%lld ", d->max_subgroups); // Intel extension
     append("-cl-std=CL%d.%d ", d->c_version_major, d->c_version_minor);
     // https://man.opencl.org/clBuildProgram.html
@@ -83,15 +513,38 @@ static const char* gemv_program_options(gemv_t* g, int fpp) {
 }
 
 static ocl_program_t gemv_compile(gemv_t* g, int fpp,
-        const void* code, int64_t bytes) {
-    const char* opts = gemv_program_options(g, fpp);
+        const void* code, int64_t bytes, bool fused, int activation) {
+    const char* opts = gemv_program_options(g, fpp, fused, activation);
     return ocl.compile(g->c, code, bytes, opts, null, 0);
 }
 
+static ocl_kernel_t gemv_fused_kernel(gemv_t* g, int fpp, int activation,
+        int xn) {
+    const int ix = xn == 16 ? 2 : (xn == 4 ? 1 : 0);
+    if (g->fused[activation][0][fpp] == null) {
+        fatal_if(!ocl.has_fpp(g->c, fpp), "%s", ocl_fpp_names[fpp]);
+        void* code = null;
+        int64_t bytes = 0;
+        int r = memmap_resource("gemv_cl", &code, &bytes);
+        fatal_if(r != 0 || code == null || bytes == 0, "is gemv.cl in gemv.rc?");
+        ocl_program_t p = gemv_compile(g, fpp, code, bytes, true, activation);
+        for (int i = 0; i < 3; i++) {
+            g->fused[activation][i][fpp] =
+                ocl.create_kernel(p, gemv_kernel_name[i][fpp]);
+        }
+        ocl.release_program(p);
+    }
+    return g->fused[activation][ix][fpp];
+}
+
 static void gemv_init(gemv_t* g, ocl_context_t* c) {
     memset(g, 0, sizeof(*g));
     g->c = c;
     ocl_device_t* d = &ocl.devices[c->ix];
+    // keep both stream() tiles unless they take > 1/4 of device memory
+    // and both pinned staging buffers:
+    ocl.pool_init(&g->pool, c, min(2 * (int64_t)gemv_tile_bytes,
+        d->global_memory / 4) + 2 * (int64_t)gemv_tile_bytes);
     void* code = null;
     int64_t bytes64 = 0;
     int r = memmap_resource("gemv_cl", &code, &bytes64);
@@ -102,21 +555,19 @@ static void gemv_init(gemv_t* g, ocl_context_t* c) {
     const bool has_fp32 = d->fp32_config != 0;
     const bool has_fp64 = d->fp64_config != 0;
     ocl_program_t p[4] = {
-        has_fp16 ? gemv_compile(g, ocl_fpp16, code, bytes) : null,
-        has_fp32 ? gemv_compile(g, ocl_fpp32, code, bytes) : null,
-        has_fp64 ? gemv_compile(g, ocl_fpp64, code, bytes) : null,
-        has_fp32 ? gemv_compile(g, ocl_bfp16, code, bytes) : null,
-    };
-    static const char* kernel_name[4][4] = {
-        {"gemv16",    "gemv32",    "gemv64",    "bfmv16"},
-        {"gemv16x4",  "gemv32x4",  "gemv64x4",  "bfmv16x4"},
-        {"gemv16x16", "gemv32x16", "gemv64x16", "bfmv16x16"}
+        has_fp16 ? gemv_compile(g, ocl_fpp16, code, bytes, false, 0) : null,
+        has_fp32 ? gemv_compile(g, ocl_fpp32, code, bytes, false, 0) : null,
+        has_fp64 ? gemv_compile(g, ocl_fpp64, code, bytes, false, 0) : null,
+        has_fp32 ? gemv_compile(g, ocl_bfp16, code, bytes, false, 0) : null,
     };
     for (int fpp = ocl_fpp_first; fpp <= ocl_fpp_last; fpp++) {
         if (p[fpp] != null) {
-            g->kernel[fpp]    = ocl.create_kernel(p[fpp], kernel_name[0][fpp]);
-            g->kernel4x[fpp]  = ocl.create_kernel(p[fpp], kernel_name[1][fpp]);
-            g->kernel16x[fpp] = ocl.create_kernel(p[fpp], kernel_name[2][fpp]);
+            g->kernel[fpp]    = ocl.create_kernel(p[fpp], gemv_kernel_name[0][fpp]);
+            g->kernel4x[fpp]  = ocl.create_kernel(p[fpp], gemv_kernel_name[1][fpp]);
+            g->kernel16x[fpp] = ocl.create_kernel(p[fpp], gemv_kernel_name[2][fpp]);
+            g->transposed[fpp] = ocl.create_kernel(p[fpp], gemv_kernel_name[3][fpp]);
+            g->transposed_sum[fpp] = ocl.create_kernel(p[fpp], "gemvt_sum");
+            g->batched[fpp] = ocl.create_kernel(p[fpp], gemv_kernel_name[4][fpp]);
             ocl.release_program(p[fpp]);
         }
     }
@@ -128,16 +579,42 @@ static void gemv_fini(gemv_t* g) {
             ocl.release_kernel(g->kernel[fpp]);
             ocl.release_kernel(g->kernel4x[fpp]);
             ocl.release_kernel(g->kernel16x[fpp]);
+            ocl.release_kernel(g->transposed[fpp]);
+            ocl.release_kernel(g->transposed_sum[fpp]);
+            ocl.release_kernel(g->batched[fpp]);
             g->kernel[fpp]    = null;
             g->kernel4x[fpp]  = null;
             g->kernel16x[fpp] = null;
+            g->transposed[fpp] = null;
+            g->transposed_sum[fpp] = null;
+            g->batched[fpp] = null;
+        }
+    }
+    for (int a = 0; a < gemv_activations; a++) {
+        for (int i = 0; i < 3; i++) {
+            for (int fpp = ocl_fpp_first; fpp <= ocl_fpp_last; fpp++) {
+                if (g->fused[a][i][fpp] != null) {
+                    ocl.release_kernel(g->fused[a][i][fpp]);
+                    g->fused[a][i][fpp] = null;
+                }
+            }
         }
     }
+    ocl.pool_fini(&g->pool);
     g->c = null;
 }
 
 gemv_if gemv = {
     .init = gemv_init,
     .gemv = ocl_gemv,
+    .transposed = gemv_transposed,
+    .batch = gemv_batch,
+    .fused = gemv_fused,
+    .async = gemv_async,
+    .stream = gemv_stream,
+    .calibrate = gemv_calibrate,
+    .multi_init = gemv_multi_init,
+    .multi = gemv_multi,
+    .multi_fini = gemv_multi_fini,
     .fini = gemv_fini
 };
@@ -88,6 +88,105 @@ void reduce_add(const uint lid, uint i,
     local_fence();
 }
 
+// Optional fused epilogue (host compiles with -D epilogue=1):
+//   rs[y] = activation(alpha * (mx[y] . vc) + beta * rs[y] + bias[y])
+// rs[] is not read when beta == 0 and bias[] may be null.
+// activation: 0 - none, 1 - ReLU, 2 - GELU (tanh approximation), 3 - SiLU
+
+#ifndef activation
+#define activation 0
+#endif
+
+// accu_t literal: unsuffixed double only for fpp == 64 because devices
+// without cl_khr_fp64 may reject double constants:
+#if fpp == 64
+#define accu_literal(x) x
+#else
+#define accu_literal(x) x##f
+#endif
+
+static inline
+accu_t activate(const accu_t s) {
+#if activation == 1
+    return s > 0 ? s : 0;
+#elif activation == 2
+    const accu_t k = accu_literal(0.7978845608028654); // sqrt(2 / pi)
+    return accu_literal(0.5) * s *
+        (1 + tanh(k * (s + accu_literal(0.044715) * s * s * s)));
+#elif activation == 3
+    return s / (1 + exp(-s));
+#else
+    return s;
+#endif
+}
+
+#ifdef epilogue
+
+#define epilogue_params , const accu_t alpha, const accu_t beta, \
+    read accu_t* restrict bias
+#define epilogue_kernel_params , const accu_t alpha, const accu_t beta, \
+    const int64_t bias_offset, read accu_t bias[/*m*/]
+#define epilogue_kernel_args , alpha, beta, \
+    bias == 0 ? 0 : rd_offsetof(accu_t, bias_offset, bias)
+#define store(rs, y, s) rs[y] = activate(alpha * (s) +  \
+    (beta != 0 ? beta * rs[y] : 0) + (bias != 0 ? bias[y] : 0))
+
+#else
+
+#define epilogue_params
+#define epilogue_kernel_params
+#define epilogue_kernel_args
+#define store(rs, y, s) rs[y] = (s)
+
+#endif
+
+// Batched gemv: rs[batch][m] = mx[m][n] * vc[batch][n] for up to
+// max_batch vectors in one pass over the matrix. Row elements are loaded
+// once into registers and reused "batch" times. The loops over
+// max_batch are unrolled so that s[] accumulators stay in registers.
+
+#define max_batch 16
+
+// reduce_add() for s[0..batch-1] of all work items in a single pass:
+// sm[max_batch][items], each halving step adds all "batch" accumulators
+// between the same two fences. On return sm[b * items] holds sum of s[b].
+
+static inline
+void reduce_add_batch(const uint lid, uint i, const int32_t batch,
+        accu_t s[max_batch], work accu_t* restrict sm) {
+    const uint items = i;
+    // this fence guarantees that reads of sm[] results of the previous
+    // row are complete before they are overwritten:
+    local_fence();
+    #pragma unroll
+    for (int b = 0; b < max_batch; b++) {
+        if (b < batch) { sm[b * items + lid] = s[b]; }
+    }
+    while (i > 1) { // see reduce_add() for the fences
+        uint i2 = i >> 1;
+        local_fence();
+        if (lid < i2) {
+            #pragma unroll
+            for (int b = 0; b < max_batch; b++) {
+                if (b < batch) {
+                    work accu_t* sb = sm + b * items;
+                    s[b] = sb[lid] + sb[lid + i2] +
+                        (((lid == 0) & (i & 1)) ? sb[lid + i - 1] : 0.0f);
+                }
+            }
+        }
+        local_fence();
+        if (lid < i2) {
+            #pragma unroll
+            for (int b = 0; b < max_batch; b++) {
+                if (b < batch) { sm[b * items + lid] = s[b]; }
+            }
+        }
+        i = i2;
+    }
+    local_fence();
+}
+
 #if fpp != 16 && !defined(bfp16) //     *** fp32_t and fp64_t
 
 static inline
@@ -96,7 +195,7 @@ void concat(gemv_fp, fpp)(
         read  fp_t*   restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm, // "sm" work memory
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // gemv_fp32|gemv_fp64
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -107,7 +206,7 @@ void concat(gemv_fp, fpp)(
         accu_t s = 0;
         for (uint x = lid; x < n; x += items) { s += row[x] * vc[x]; }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -117,7 +216,7 @@ void concat(concat(gemv_fp, fpp), x4)(
         read  fpv4_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // gemv_fp32x4 gemv_fp64x4. "n" is 1/4 of row width
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -128,7 +227,7 @@ void concat(concat(gemv_fp, fpp), x4)(
         accu_t s = 0;
         for (uint x = lid; x < n; x += items) { s += dot(row[x], vc[x]); }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -138,7 +237,7 @@ void concat(concat(gemv_fp, fpp), x16)(
         read  fpv4_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // gemv_fp32x16 gemv_fp64x16. "n" is 1/16 of row width
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -156,7 +255,7 @@ void concat(concat(gemv_fp, fpp), x16)(
                 dot(row[x4 + 3], vc[x4 + 3]);
         }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -168,7 +267,7 @@ void concat(concat(gemv_fp, fpp), _subgroups)(
         read  fp_t*   restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // gemv_fp32_subgroups|gemv_fp64_subgroups
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -183,7 +282,7 @@ void concat(concat(gemv_fp, fpp), _subgroups)(
         subgroup_fence()
         s = sub_group_reduce_add(s);
         reduce_add(sub_group_id, num_sub_groups, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -193,7 +292,7 @@ void concat(concat(gemv_fp, fpp), x4_subgroups)(
         read  fpv4_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // "n" is 1/16 or row width
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -207,7 +306,7 @@ void concat(concat(gemv_fp, fpp), x4_subgroups)(
         for (uint x = lid; x < n; x += items) { s += dot(row[x], vc[x]); }
         subgroup_fence()
         reduce_add(sub_group_id, num_sub_groups, sub_group_reduce_add(s), sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -217,7 +316,7 @@ void concat(concat(gemv_fp, fpp), x16_subgroups)(
         read  fpv4_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // "n" is 1/16 or row width
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -238,7 +337,7 @@ void concat(concat(gemv_fp, fpp), x16_subgroups)(
         }
         subgroup_fence();
         reduce_add(sub_group_id, num_sub_groups, sub_group_reduce_add(s), sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -258,19 +357,19 @@ void concat(gemv, fpp)( // gemv32 gemv16 gemv64; fpp float point precision
         const int64_t  rs_offset,
         write fp_t rs[/*m*/],
         work  fp_t sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
 #if max_subgroups > 0
     concat(concat(gemv_fp, fpp), _subgroups)(
         rd_offsetof(fp_t, mx_offset, mx),
         rd_offsetof(fp_t, vc_offset, vc),
         wr_offsetof(fp_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 #else // sm[max_items * max_groups] must be allocated by host
     concat(gemv_fp, fpp)(
         rd_offsetof(fp_t, mx_offset, mx),
         rd_offsetof(fp_t, vc_offset, vc),
         wr_offsetof(fp_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 #endif
 }
 
@@ -283,19 +382,19 @@ void concat(concat(gemv, fpp), x4)( // gemv32x4 "float4" version
         const int64_t rs_offset,
         write fp_t    rs[/*m*/],
         work  fp_t    sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
 #if max_subgroups > 0
     concat(concat(gemv_fp,  fpp), x4_subgroups)(
         rd_offsetof(fpv4_t, mx_offset, mx),
         rd_offsetof(fpv4_t, vc_offset, vc),
         wr_offsetof(fp_t,   rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 #else
     concat(concat(gemv_fp, fpp), x4)(
         rd_offsetof(fpv4_t, mx_offset, mx),
         rd_offsetof(fpv4_t, vc_offset, vc),
         wr_offsetof(fp_t,   rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 #endif
 }
 
@@ -308,22 +407,76 @@ void concat(concat(gemv, fpp), x16)( // gemv32x4 "float4" version
         const int64_t rs_offset,
         write fp_t    rs[/*m*/],
         work  fp_t    sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
 #if max_subgroups > 0
     concat(concat(gemv_fp, fpp), x16_subgroups)(
         rd_offsetof(fpv4_t, mx_offset, mx),
         rd_offsetof(fpv4_t, vc_offset, vc),
         wr_offsetof(fp_t,   rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 #else
     concat(concat(gemv_fp, fpp), x16)(
         rd_offsetof(fpv4_t, mx_offset, mx),
         rd_offsetof(fpv4_t, vc_offset, vc),
         wr_offsetof(fp_t,   rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 #endif
 }
 
+// row[x..x+3] of transposed gemv, see gemvt_name() below
+
+static inline
+acc4_t gemvt_load4(read fp_t* row, const int64_t x, const int32_t n) {
+    if (x + 4 <= n) { return vload4(0, row + x); }
+    accu_t t[4] = {0, 0, 0, 0};
+    for (int64_t i = x; i < n; i++) { t[i - x] = row[i]; }
+    return vload4(0, t);
+}
+
+__kernel
+void concat(concat(gemv, fpp), x16_batch)( // gemv32x16_batch gemv64x16_batch
+        const int64_t mx_offset,
+        read  fpv4_t  mx[/*m][n*/],
+        const int64_t vc_offset,
+        read  fpv4_t  vc[/*batch][n*/],
+        const int64_t rs_offset,
+        write fp_t    rs[/*batch][m*/],
+        work  accu_t  sm[/*max_batch][work_group_items*/],
+        const int32_t n, const int32_t m, const int32_t batch) {
+    // "n" is 1/16 of row width
+    read  fpv4_t* a = rd_offsetof(fpv4_t, mx_offset, mx);
+    read  fpv4_t* v = rd_offsetof(fpv4_t, vc_offset, vc);
+    write fp_t*   r = wr_offsetof(fp_t,   rs_offset, rs);
+    const uint lid = get_local_id(0);
+    const uint gid = get_group_id(0);
+    const uint items = get_local_size(0);
+    const uint groups = get_num_groups(0);
+    const uint stride = n * 4; // vc[] row in fpv4_t
+    for (uint y = gid; y < m; y += groups) {
+        read fpv4_t* row = a + y * stride;
+        accu_t s[max_batch];
+        #pragma unroll
+        for (int b = 0; b < max_batch; b++) { s[b] = 0; }
+        for (uint x = lid; x < n; x += items) {
+            const uint x4 = x << 2;
+            const fpv4_t r0 = row[x4 + 0];
+            const fpv4_t r1 = row[x4 + 1];
+            const fpv4_t r2 = row[x4 + 2];
+            const fpv4_t r3 = row[x4 + 3];
+            #pragma unroll
+            for (int b = 0; b < max_batch; b++) {
+                if (b < batch) {
+                    read fpv4_t* vb = v + b * stride + x4;
+                    s[b] += dot(r0, vb[0]) + dot(r1, vb[1]) +
+                            dot(r2, vb[2]) + dot(r3, vb[3]);
+                }
+            }
+        }
+        reduce_add_batch(lid, items, batch, s, sm);
+        for (uint b = lid; b < batch; b += items) { r[b * m + y] = sm[b * items]; }
+    }
+}
+
 #elif defined(bfp16) //         *** bf16_t ***
 
 static inline
@@ -344,7 +497,7 @@ void gemv_bf16( // bf16_t
         read  accu_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const  int32_t n, const int32_t m) {
+        const  int32_t n, const int32_t m epilogue_params) {
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
     const uint items = get_local_size(0);
@@ -354,7 +507,7 @@ void gemv_bf16( // bf16_t
         accu_t s = 0;
         for (uint x = lid; x < n; x += items) { s += load_bf(x, row) * vc[x]; }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -364,7 +517,7 @@ void gemv_bf16x4( // vec4 of bf16_t
         read  accu_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // "n" is 1/4 of row width
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -382,7 +535,7 @@ void gemv_bf16x4( // vec4 of bf16_t
             }
         }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -392,7 +545,7 @@ void gemv_bf16x16( // 16 elements of bf16_t
         read  accu_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // "n" is 1/16 of row width
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -410,7 +563,7 @@ void gemv_bf16x16( // 16 elements of bf16_t
             }
         }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -423,12 +576,12 @@ void bfmv16(
         const int64_t rs_offset,
         write accu_t  rs[/*m*/],
         work  accu_t  sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
     gemv_bf16(
         rd_offsetof(bf16_t, mx_offset, mx),
         rd_offsetof(accu_t, vc_offset, vc),
         wr_offsetof(accu_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 }
 
 __kernel
@@ -440,12 +593,12 @@ void bfmv16x4(
         const int64_t rs_offset,
         write accu_t  rs[/*m*/],
         work  accu_t  sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
     gemv_bf16x4(
         rd_offsetof(bf16_t, mx_offset, mx),
         rd_offsetof(accu_t, vc_offset, vc),
         wr_offsetof(accu_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 }
 
 __kernel
@@ -457,12 +610,63 @@ void bfmv16x16(
         const int64_t rs_offset,
         write accu_t  rs[/*m*/],
         work  accu_t  sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
     gemv_bf16x16(
         rd_offsetof(bf16_t, mx_offset, mx),
         rd_offsetof(accu_t, vc_offset, vc),
         wr_offsetof(accu_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
+}
+
+static inline
+acc4_t gemvt_load4(read bf16_t* row, const int64_t x, const int32_t n) {
+    accu_t t[4] = {0, 0, 0, 0};
+    const int64_t e = min(x + 4, (int64_t)n);
+    for (int64_t i = x; i < e; i++) { t[i - x] = load_bf(i, row); }
+    return vload4(0, t);
+}
+
+__kernel
+void bfmv16x16_batch( // batched, see gemv32x16_batch
+        const int64_t mx_offset,
+        read  bf16_t  mx[/*m][n*/],
+        const int64_t vc_offset,
+        read  accu_t  vc[/*batch][n*/],
+        const int64_t rs_offset,
+        write accu_t  rs[/*batch][m*/],
+        work  accu_t  sm[/*max_batch][work_group_items*/],
+        const int32_t n, const int32_t m, const int32_t batch) {
+    // "n" is 1/16 of row width
+    read  bf16_t* a = rd_offsetof(bf16_t, mx_offset, mx);
+    read  accu_t* v = rd_offsetof(accu_t, vc_offset, vc);
+    write accu_t* r = wr_offsetof(accu_t, rs_offset, rs);
+    const uint lid = get_local_id(0);
+    const uint gid = get_group_id(0);
+    const uint items = get_local_size(0);
+    const uint groups = get_num_groups(0);
+    const uint stride = n * 16;
+    for (uint y = gid; y < m; y += groups) {
+        read bf16_t* row = a + y * stride;
+        accu_t s[max_batch];
+        #pragma unroll
+        for (int b = 0; b < max_batch; b++) { s[b] = 0; }
+        for (uint x = lid; x < n; x += items) {
+            const uint x16 = x << 4;
+            fp32_t e[16];
+            #pragma unroll 16
+            for (uint i = 0; i < 16; i++) { e[i] = load_bf(x16 + i, row); }
+            #pragma unroll
+            for (int b = 0; b < max_batch; b++) {
+                if (b < batch) {
+                    read accu_t* vb = v + b * stride + x16;
+                    #pragma unroll 16
+                    for (uint i = 0; i < 16; i++) { s[b] += e[i] * vb[i]; }
+                }
+            }
+        }
+        reduce_add_batch(lid, items, batch, s, sm);
+        for (uint b = lid; b < batch; b += items) { r[b * m + y] = sm[b * items]; }
+    }
 }
 
 #else //                        *** fp_t fp16_t ***
@@ -473,7 +677,7 @@ void gemv_fp16(
         read  accu_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const  int32_t n, const int32_t m) {
+        const  int32_t n, const int32_t m epilogue_params) {
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
     const uint items = get_local_size(0);
@@ -483,7 +687,7 @@ void gemv_fp16(
         accu_t s = 0;
         for (uint x = lid; x < n; x += items) { s += vload_half(x, row) * vc[x]; }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -493,7 +697,7 @@ void gemv_fp16x4(
         read  acc4_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // "n" is 1/4 of row width
     // vload_half4 reads sizeof(halfn) bytes of data from
     // address (p + (offset * n))
@@ -506,7 +710,7 @@ void gemv_fp16x4(
         accu_t s = 0; // ^^^ * 4 because mx is fp16_t*
         for (uint x = lid; x < n; x += items) { s += dot(vload_half4(x, row), vc[x]); }
         reduce_add(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -516,7 +720,7 @@ void gemv_fp16x16(
         read  acc4_t* restrict vc,
         write accu_t* restrict rs,
         work  accu_t* restrict sm,
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_params) {
     // "n" is 1/16 of row width
     const uint lid = get_local_id(0);
     const uint gid = get_group_id(0);
@@ -534,7 +738,7 @@ void gemv_fp16x16(
                 dot(vload_half4(x4 + 3, row), vc[x4 + 3]);
         }
         reduce_add32(lid, items, s, sm);
-        if (lid == 0) { rs[y] = sm[0]; }
+        if (lid == 0) { store(rs, y, sm[0]); }
     }
 }
 
@@ -547,13 +751,13 @@ void gemv16(
         const int64_t rs_offset,
         write accu_t  rs[/*m*/],
         work  accu_t  sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
 //  printf("gemv16 %ld %ld %ld\n", mx_offset, vc_offset, rs_offset);
     gemv_fp16(
         rd_offsetof(fp16_t, mx_offset, mx),
         rd_offsetof(accu_t, vc_offset, vc),
         wr_offsetof(accu_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 }
 
 __kernel
@@ -565,13 +769,13 @@ void gemv16x4(
         const int64_t rs_offset,
         write accu_t  rs[/*m*/],
         work  accu_t  sm[/*work_group_items*/],
-        const int32_t n, const int32_t m) {
+        const int32_t n, const int32_t m epilogue_kernel_params) {
 //  printf("gemv16x4 %ld %ld %ld\n", mx_offset, vc_offset, rs_offset);
     gemv_fp16x4(
         rd_offsetof(fp16_t, mx_offset, mx),
         rd_offsetof(acc4_t, vc_offset, vc),
         wr_offsetof(accu_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
 }
 
 __kernel
@@ -583,15 +787,144 @@ void gemv16x16(
         const int64_t rs_offset,
         write accu_t  rs[/*m*/],
         work  accu_t  sm[/*work_group_items*/],
-        const  int32_t n, const int32_t m) {
+        const  int32_t n, const int32_t m epilogue_kernel_params) {
 //  printf("gemv16x16 %ld %ld %ld\n", mx_offset, vc_offset, rs_offset);
     gemv_fp16x16(
         rd_offsetof(fp16_t, mx_offset, mx),
         rd_offsetof(acc4_t, vc_offset, vc),
         wr_offsetof(accu_t, rs_offset, rs),
-        sm, n, m);
+        sm, n, m epilogue_kernel_args);
+}
+
+static inline
+acc4_t gemvt_load4(read fp16_t* row, const int64_t x, const int32_t n) {
+    if (x + 4 <= n) { return vload_half4(0, row + x); }
+    accu_t t[4] = {0, 0, 0, 0};
+    for (int64_t i = x; i < n; i++) { t[i - x] = vload_half(i, row); }
+    return vload4(0, t);
+}
+
+__kernel
+void gemv16x16_batch( // batched, see gemv32x16_batch
+        const int64_t mx_offset,
+        read  fp16_t  mx[/*m][n*/],
+        const int64_t vc_offset,
+        read  acc4_t  vc[/*batch][n*/],
+        const int64_t rs_offset,
+        write accu_t  rs[/*batch][m*/],
+        work  accu_t  sm[/*max_batch][work_group_items*/],
+        const int32_t n, const int32_t m, const int32_t batch) {
+    // "n" is 1/16 of row width
+    read  fp16_t* a = rd_offsetof(fp16_t, mx_offset, mx);
+    read  acc4_t* v = rd_offsetof(acc4_t, vc_offset, vc);
+    write accu_t* r = wr_offsetof(accu_t, rs_offset, rs);
+    const uint lid = get_local_id(0);
+    const uint gid = get_group_id(0);
+    const uint items = get_local_size(0);
+    const uint groups = get_num_groups(0);
+    const uint stride = n * 4; // vc[] row in acc4_t
+    for (uint y = gid; y < m; y += groups) {
+        read fp16_t* row = a + y * n * 16;
+        accu_t s[max_batch];
+        #pragma unroll
+        for (int b = 0; b < max_batch; b++) { s[b] = 0; }
+        for (uint x = lid; x < n; x += items) {
+            const uint x4 = x << 2;
+            const acc4_t r0 = vload_half4(x4 + 0, row);
+            const acc4_t r1 = vload_half4(x4 + 1, row);
+            const acc4_t r2 = vload_half4(x4 + 2, row);
+            const acc4_t r3 = vload_half4(x4 + 3, row);
+            #pragma unroll
+            for (int b = 0; b < max_batch; b++) {
+                if (b < batch) {
+                    read acc4_t* vb = v + b * stride + x4;
+                    s[b] += dot(r0, vb[0]) + dot(r1, vb[1]) +
+                            dot(r2, vb[2]) + dot(r3, vb[3]);
+                }
+            }
+        }
+        reduce_add_batch(lid, items, batch, s, sm);
+        for (uint b = lid; b < batch; b += items) { r[b * m + y] = sm[b * items]; }
+    }
 }
 
 #endif
 
+// Transposed rs[n] = mx[m][n]^T * vc[m] on a 2D range:
+// dimension 0: work item owns 4 adjacent columns x..x+3 and reads them
+// with one vector load (adjacent work items read adjacent parts of a row);
+// dimension 1: work group owns "rows" rows chunk [y0..y1) and its items
+// stride over the chunk "lsy" rows apart.
+// Partial sums of the column are added in work memory sm[lsy][lsx] and
+// the chunk sums are written to rs[chunk][n]. When there is more than
+// one chunk the host sums them with gemvt_sum() below.
+
+#ifdef bfp16
+#define gemvt_name bfmvt16
+#else
+#define gemvt_name concat(gemvt, fpp)
+#endif
+
+__kernel
+void gemvt_name( // gemvt16 gemvt32 gemvt64 bfmvt16
+        const int64_t mx_offset,
+        read  fp_t    mx[/*m][n*/],
+        const int64_t vc_offset,
+        read  accu_t  vc[/*m*/],
+        const int64_t rs_offset,
+        write accu_t  rs[/*chunks][n*/],
+        work  acc4_t  sm[/*lsy][lsx*/], // lsy must be power of 2
+        const int32_t n, const int32_t m, const int32_t rows) {
+    read  fp_t*   a = rd_offsetof(fp_t, mx_offset, mx);
+    read  accu_t* v = rd_offsetof(accu_t, vc_offset, vc);
+    write accu_t* r = wr_offsetof(accu_t, rs_offset, rs);
+    const uint lx  = get_local_id(0);
+    const uint ly  = get_local_id(1);
+    const uint lsx = get_local_size(0);
+    const int64_t x  = (int64_t)get_global_id(0) * 4;
+    const int64_t y0 = (int64_t)get_group_id(1) * rows;
+    const int64_t y1 = min(y0 + rows, (int64_t)m);
+    acc4_t s = 0;
+    if (x < n) {
+        for (int64_t y = y0 + ly; y < y1; y += get_local_size(1)) {
+            s += gemvt_load4(a + y * n, x, n) * v[y];
+        }
+    }
+    // all work items (including x >= n) must reach the fences:
+    sm[ly * lsx + lx] = s;
+    for (uint i = get_local_size(1) >> 1; i > 0; i >>= 1) {
+        local_fence();
+        if (ly < i) { sm[ly * lsx + lx] += sm[(ly + i) * lsx + lx]; }
+    }
+    if (ly == 0 && x < n) {
+        write accu_t* p = r + (int64_t)get_group_id(1) * n + x;
+        if (x + 4 <= n) {
+            vstore4(sm[lx], 0, p);
+        } else {
+            accu_t t[4];
+            vstore4(sm[lx], 0, t);
+            for (int64_t i = x; i < n; i++) { p[i - x] = t[i - x]; }
+        }
+    }
+}
+
+// rs[x] = sum(ps[0..chunks-1][x]) for gemvt_name() row chunks:
+
+__kernel
+void gemvt_sum(
+        const int64_t ps_offset,
+        read  accu_t  ps[/*chunks][n*/],
+        const int64_t rs_offset,
+        write accu_t  rs[/*n*/],
+        const int32_t n, const int32_t chunks) {
+    read  accu_t* p = rd_offsetof(accu_t, ps_offset, ps);
+    write accu_t* r = wr_offsetof(accu_t, rs_offset, rs);
+    const int64_t x = get_global_id(0);
+    if (x < n) {
+        accu_t s = 0;
+        for (int32_t c = 0; c < chunks; c++) { s += p[(int64_t)c * n + x]; }
+        r[x] = s;
+    }
+}
+
 // uncomment to force error here to see the warnings
\ No newline at end of file
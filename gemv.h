@@ -1,14 +1,58 @@
 #include "rt.h"
 #include "ocl.h"
 
+enum { // fused epilogue activation
+    gemv_identity = 0,
+    gemv_relu     = 1,
+    gemv_gelu     = 2, // tanh approximation
+    gemv_silu     = 3,
+    gemv_activations
+};
+
+enum { gemv_max_batch = 16 }; // must match max_batch in gemv.cl
+
+enum { gemv_max_devices = 32 }; // multi() devices, see ocl_devices[]
+
+typedef struct gemv_epilogue_s {
+    // rs[y] = activation(alpha * (mx[y] . vc) + beta * rs[y] + bias[y])
+    fp64_t alpha;
+    fp64_t beta;   // 0: rs[] is not read
+    intptr_t bias_offset;
+    ocl_memory_t bias; // [m] of fp32_t (fp64_t for ocl_fpp64) or null
+    int activation; // gemv_identity, gemv_relu, ...
+} gemv_epilogue_t;
+
 typedef struct gemv_s {
     ocl_context_t* c;
     // gemv kernels ocl_fpp16, ocl_fpp32, ocl_fpp64, ocl_bfp16
     ocl_kernel_t kernel[ocl_fpp_last - ocl_fpp_first + 1];
     ocl_kernel_t kernel4x[ocl_fpp_last - ocl_fpp_first + 1];   // vec4 kernel
     ocl_kernel_t kernel16x[ocl_fpp_last - ocl_fpp_first + 1];  // 4 x vec4
+    ocl_kernel_t transposed[ocl_fpp_last - ocl_fpp_first + 1]; // mx^T * vc
+    ocl_kernel_t transposed_sum[ocl_fpp_last - ocl_fpp_first + 1]; // chunks
+    ocl_kernel_t batched[ocl_fpp_last - ocl_fpp_first + 1];    // batch x vc
+    // fused epilogue kernels [activation][1x, 4x, 16x][fpp] compiled
+    // on first use:
+    ocl_kernel_t fused[gemv_activations][3][ocl_fpp_last - ocl_fpp_first + 1];
+    ocl_pool_t pool; // stream() tiles and staging, pool.capacity may be changed after init
+    // calibrate() bytes/s of gemv() on resident matrix and of stream():
+    fp64_t throughput[ocl_fpp_last - ocl_fpp_first + 1];
+    fp64_t streaming[ocl_fpp_last - ocl_fpp_first + 1];
 } gemv_t;
 
+typedef struct gemv_multi_s { // rows of host mx[m][n] split across devices
+    gemv_t* g[gemv_max_devices];
+    int count;
+    int fpp;
+    int64_t n;
+    int64_t m;
+    const void* mx; // host matrix, read by streamed shares
+    int64_t rows[gemv_max_devices]; // 0: device w/o fpp support
+    ocl_memory_t resident[gemv_max_devices]; // rows[i] x n, null: streamed
+    ocl_memory_t vc[gemv_max_devices]; // [n]
+    ocl_memory_t rs[gemv_max_devices]; // [rows[i]]
+} gemv_multi_t;
+
 typedef struct gemv_if {
     void (*init)(gemv_t* g, ocl_context_t* c);
     // except fpp: ocl_fpp_fp64 vc must be fp32_t[n]!
@@ -17,6 +61,63 @@ typedef struct gemv_if {
         intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
         intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
         int64_t n, int64_t m);
+    // rs[n] = mx[m][n]^T * vc[m] w/o transposing mx in memory.
+    // Same element types as gemv(): vc and rs are fp32_t (fp64_t for
+    // ocl_fpp64):
+    void (*transposed)(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[m]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[n]*/,
+        int64_t n, int64_t m);
+    // rs[batch][m] = mx[m][n] * vc[batch][n]: one pass over the matrix for
+    // every gemv_max_batch vectors (n % 16 == 0 and 16 elements aligned
+    // mx and vc), otherwise gemv() per vector:
+    void (*batch)(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[batch][n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[batch][m]*/,
+        int64_t n, int64_t m, int64_t batch);
+    // gemv() with fused epilogue: result is written once w/o extra pass
+    void (*fused)(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m, const gemv_epilogue_t* e);
+    // non-blocking gemv() or fused() (e != null): starts after wait[waits]
+    // events (0, null - no dependencies) and returns event of completion
+    // that caller must ocl.wait() or pass to the next operation and
+    // ocl.release_event(). Allows to queue a whole layer and synchronize
+    // once:
+    ocl_event_t (*async)(gemv_t* g, int fpp,
+        intptr_t mx_offset, ocl_memory_t mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m, const gemv_epilogue_t* e,
+        int waits, const ocl_event_t wait[]);
+    // out-of-core gemv for matrices larger than device memory (or mapping
+    // limits): host mx[m][n] is streamed in chunks (tiles of rows) through
+    // two device buffers of tile_bytes each (0 - default). Uploads go to
+    // the transfer queue and overlap with compute of the previous tile
+    // only if the device executes both queues concurrently, otherwise it
+    // is plain chunked streaming. Results land in rs[m]:
+    void (*stream)(gemv_t* g, int fpp, const void* mx/*[m][n]*/,
+        intptr_t vc_offset, ocl_memory_t vc/*[n]*/,
+        intptr_t rs_offset, ocl_memory_t rs/*[m]*/,
+        int64_t n, int64_t m, int64_t tile_bytes);
+    // measures g->throughput[fpp] and g->streaming[fpp] (takes a few
+    // milliseconds, no-op w/o fpp support). Call before multi_init():
+    void (*calibrate)(gemv_t* g, int fpp);
+    // rs[m] = mx[m][n] * vc[n] on count devices at once. Host mx, vc and
+    // rs (same element types as gemv()). multi_init() splits rows once
+    // proportionally to calibrated throughput (equal split if not
+    // calibrated), devices w/o fpp support get no rows. Shares that fit
+    // into half of device memory are uploaded once and stay resident,
+    // larger ones are streamed from mx (which then must stay valid) on
+    // every multi() call. multi() uploads vc and reads back rs only:
+    void (*multi_init)(gemv_multi_t* mm, gemv_t* g[], int count, int fpp,
+        const void* mx/*[m][n]*/, int64_t n, int64_t m);
+    void (*multi)(gemv_multi_t* mm, const void* vc/*[n]*/, void* rs/*[m]*/);
+    void (*multi_fini)(gemv_multi_t* mm);
     void (*fini)(gemv_t* g);
 } gemv_if;
 
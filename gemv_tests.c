@@ -2,6 +2,7 @@
 #include "ocl.h"
 #include "dot.h"
 #include "gemv.h"
+#include "tensor.h"
 #include <conio.h>
 
 static int  best_of = 3;
@@ -52,18 +53,62 @@ static void m64println(const fp64_t* mx, const int32_t n, const int32_t m) {
 
 static void print(int fpp, int32_t n, int32_t m) { // performance measurements
     if (n > 64 && m > 64) {
+        // avx (multithreaded gemv) memory throughput:
+        const fp64_t veb = fpp == ocl_fpp64 ? sizeof(fp64_t) : sizeof(fp32_t);
+        const fp64_t bytes = (fp64_t)n * m * ocl_fpp_bytes[fpp] + (n + m) * veb;
+        const fp64_t avx_gbps = bytes / (avx_time * NSEC_IN_SEC);
         if (gpu_time < DBL_MAX) { // when PROFILING
             println("%s %5d x %-5d gpu: %9.3f (call: %9.3f) avx: %9.3f "
-                "ms %5.1fGFlops",
+                "ms %5.1fGFlops avx: %5.1fGB/s",
                 ocl_fpp_names[fpp], n, m,
                 gpu_time * MSEC_IN_SEC, ocl_time * MSEC_IN_SEC,
-                avx_time * MSEC_IN_SEC, gpu_gfps);
+                avx_time * MSEC_IN_SEC, gpu_gfps, avx_gbps);
         } else { // user land time instead of gpu profiling time
             gpu_gfps = 3.0 * m * n / (ocl_time * NSEC_IN_SEC);
-            println("%s %5d x %-5d gpu: %9.3f avx: %9.3f ms %5.1fGFlops",
+            println("%s %5d x %-5d gpu: %9.3f avx: %9.3f ms %5.1fGFlops "
+                "avx: %5.1fGB/s",
                 ocl_fpp_names[fpp], n, m,
                 ocl_time * MSEC_IN_SEC,
-                avx_time * MSEC_IN_SEC, gpu_gfps);
+                avx_time * MSEC_IN_SEC, gpu_gfps, avx_gbps);
+        }
+    }
+}
+
+static fp64_t get_accu(int fpp, const void* p, int64_t i) { // accu_t p[i]
+    return fpp == ocl_fpp64 ? ((const fp64_t*)p)[i] : ((const fp32_t*)p)[i];
+}
+
+static void set_accu(int fpp, void* p, int64_t i, fp64_t v) { // accu_t p[i]
+    if (fpp == ocl_fpp64) {
+        ((fp64_t*)p)[i] = v;
+    } else {
+        ((fp32_t*)p)[i] = (fp32_t)v;
+    }
+}
+
+static fp64_t get_element(int fpp, const void* mx, int64_t i) { // fp_t mx[i]
+    switch (fpp) {
+        case ocl_fpp16: return fp16to32(((const fp16_t*)mx)[i]);
+        case ocl_bfp16: return bf16to32(((const bf16_t*)mx)[i]);
+        case ocl_fpp32: return ((const fp32_t*)mx)[i];
+        case ocl_fpp64: return ((const fp64_t*)mx)[i];
+        default: fatal_if("fpp?", "fpp: %d", fpp); return 0;
+    }
+}
+
+static void reference(int fpp, const void* mx, const void* vc, fp64_t* rs,
+        int32_t n, int32_t m, bool transposed) {
+    // fp64 rs[m] = mx[m][n] * vc[n] or transposed rs[n] = mx[m][n]^T * vc[m]
+    const int32_t k = transposed ? n : m;
+    for (int32_t i = 0; i < k; i++) { rs[i] = 0; }
+    for (int32_t y = 0; y < m; y++) {
+        for (int32_t x = 0; x < n; x++) {
+            const fp64_t e = get_element(fpp, mx, (int64_t)y * n + x);
+            if (transposed) {
+                rs[x] += e * get_accu(fpp, vc, y);
+            } else {
+                rs[y] += e * get_accu(fpp, vc, x);
+            }
         }
     }
 }
@@ -75,28 +120,36 @@ static void init_mx_vc(int fpp,
                  fp64_t (*init_mx)(int32_t j, int32_t i, int32_t n),
                  fp64_t (*init_vc)(int32_t i)) {
     const size_t meb = ocl_fpp_bytes[fpp]; // matrix element bytes
-    for (int32_t i = 0; i < n; i++) {
+    // vc == null: matrix only
+    for (int32_t i = 0; vc != null && i < n; i++) {
+        set_accu(fpp, vc, o1 + i, init_vc(i));
+    }
+    byte_t* p = o0 + (byte_t*)mx;
+    // fp16_t and bf16_t rows are initialized as fp32_t and bulk converted:
+    fp32_t* row = (fp32_t*)malloc(n * sizeof(fp32_t));
+    fatal_if(row == null);
+    for (int32_t j = 0; j < m; j++) {
         switch (fpp) {
             case ocl_bfp16:
             case ocl_fpp16:
-            case ocl_fpp32: ((fp32_t*)vc)[o1 + i] = (fp32_t)init_vc(i); break;
-            case ocl_fpp64: ((fp64_t*)vc)[o1 + i] = init_vc(i); break;
+                for (int32_t i = 0; i < n; i++) { row[i] = (fp32_t)init_mx(j, i, n); }
+                if (fpp == ocl_bfp16) {
+                    bf32to16_n(row, (bf16_t*)p, n);
+                } else {
+                    fp32to16_n(row, (fp16_t*)p, n);
+                }
+                break;
+            case ocl_fpp32:
+                for (int32_t i = 0; i < n; i++) { ((fp32_t*)p)[i] = (fp32_t)init_mx(j, i, n); }
+                break;
+            case ocl_fpp64:
+                for (int32_t i = 0; i < n; i++) { ((fp64_t*)p)[i] = init_mx(j, i, n); }
+                break;
             default: fatal_if("fpp?", "fpp: %d", fpp);
         }
+        p += n * meb;
     }
-    byte_t* p = o0 + (byte_t*)mx;
-    for (int32_t j = 0; j < m; j++) {
-        for (int32_t i = 0; i < n; i++) {
-            switch (fpp) {
-                case ocl_bfp16: *((bf16_t*)p) = bf32to16((fp32_t)init_mx(j, i, n)); break;
-                case ocl_fpp16: *((fp16_t*)p) = fp32to16((fp32_t)init_mx(j, i, n)); break;
-                case ocl_fpp32: *((fp32_t*)p) = (fp32_t)init_mx(j, i, n); break;
-                case ocl_fpp64: *((fp64_t*)p) = init_mx(j, i, n); break;
-                default: fatal_if("fpp?", "fpp: %d", fpp);
-            }
-            p += meb;
-        }
-    }
+    free(row);
 }
 
 static void test_avx(int fpp, void* mx, void* vc, void* avx,
@@ -104,28 +157,16 @@ static void test_avx(int fpp, void* mx, void* vc, void* avx,
     fp64_t user = seconds();
     switch (fpp) {
         case ocl_fpp16:
-            for (int32_t j = 0; j < m; j++) {
-                fp16_t* row = (fp16_t*)mx + j * n;
-                ((fp32_t*)avx)[j] = (fp32_t)dot.fp32x16((fp32_t*)vc, 1, row, 1, n);
-            }
+            dot.gemv_fp32x16((fp16_t*)mx, (fp32_t*)vc, (fp32_t*)avx, n, m);
             break;
         case ocl_bfp16:
-            for (int32_t j = 0; j < m; j++) {
-                bf16_t* row = (bf16_t*)mx + j * n;
-                ((fp32_t*)avx)[j] = (fp32_t)dot.bf32x16((fp32_t*)vc, 1, row, 1, n);
-            }
+            dot.gemv_bf32x16((bf16_t*)mx, (fp32_t*)vc, (fp32_t*)avx, n, m);
             break;
         case ocl_fpp32:
-            for (int32_t j = 0; j < m; j++) {
-                fp32_t* row = (fp32_t*)mx + j * n;
-                ((fp32_t*)avx)[j] = (fp32_t)dot.fp32((fp32_t*)vc, 1, row, 1, n);
-            }
+            dot.gemv_fp32((fp32_t*)mx, (fp32_t*)vc, (fp32_t*)avx, n, m);
             break;
         case ocl_fpp64:
-            for (int64_t j = 0; j < m; j++) {
-                fp64_t* row = (fp64_t*)mx + j * n;
-                ((fp64_t*)avx)[j] = dot.fp64((fp64_t*)vc, 1, row, 1, n);
-            }
+            dot.gemv_fp64((fp64_t*)mx, (fp64_t*)vc, (fp64_t*)avx, n, m);
             break;
         default:
             fatal_if("fpp?", "fpp: %d", fpp);
@@ -307,7 +348,7 @@ ocl_memory_t alloc(ocl_context_t* c, int access, size_t bytes) {
     return m;
 }
 
-static void test(gemv_t* g, int fpp,
+static bool test(gemv_t* g, int fpp, // false if device buffers do not fit
                  int32_t o0, int32_t o1, int32_t o2,
                  int32_t n, int32_t m,
                  fp64_t (*init_mx)(int32_t j, int32_t i, int32_t n),
@@ -326,7 +367,8 @@ static void test(gemv_t* g, int fpp,
     ocl_memory_t matrix = alloc(c, write_only, (size_t)m * n * meb + o0);
     ocl_memory_t vector = alloc(c, write_only, (size_t)n * veb + o1);
     ocl_memory_t result = alloc(c, read_only,  (size_t)m * veb + o2);
-    if (matrix != null && vector != null && result != null) {
+    const bool fits = matrix != null && vector != null && result != null;
+    if (fits) {
         byte_t* mx = ocl.map(c, CL_MAP_WRITE, matrix, 0, (size_t)m * n * meb + o0);
         byte_t* vc = ocl.map(c, CL_MAP_WRITE, vector, 0, n * veb + o1);
         init_mx_vc(fpp, mx, vc, o0, o1, n, m, init_mx, init_vc);
@@ -350,11 +392,12 @@ static void test(gemv_t* g, int fpp,
         verify(fpp, avx, cpu, o2, rs, n, m);
         // cleanup
         ocl.unmap(c, result, rs);
+        print(fpp, n, m); // performance measurements
     }
     ocl.deallocate(result);
     ocl.deallocate(vector);
     ocl.deallocate(matrix);
-    print(fpp, n, m); // performance measurements
+    return fits;
 }
 
 static fp64_t init_vc0(int32_t i) {
@@ -375,6 +418,360 @@ static fp64_t init_mx1(int32_t r, int32_t c, int32_t n) {
     return (fp32_t)(1.0 / pow(2.0, (ix % 9)));
 }
 
+static void init_vector(int fpp, void* vc, int64_t n) {
+    for (int64_t i = 0; i < n; i++) { set_accu(fpp, vc, i, init_vc1((int32_t)i)); }
+}
+
+static byte_t* host_matrix(int fpp, int32_t n, int32_t m) {
+    // large pages for the host matrix the CPU dot.gemv_*() reads too:
+    byte_t* mx = (byte_t*)huge_alloc((int64_t)m * n * ocl_fpp_bytes[fpp], null);
+    if (mx != null) { init_mx_vc(fpp, mx, null, 0, 0, n, m, init_mx1, null); }
+    return mx;
+}
+
+static fp64_t serialized(gemv_t* g, int fpp, const byte_t* mx,
+        ocl_memory_t vector, ocl_memory_t result, int32_t n, int32_t m,
+        int64_t tile_bytes) {
+    // same tiles as stream() but each one is uploaded (blocking) from
+    // pageable memory before its gemv(): no upload/compute overlap
+    ocl_context_t* c = g->c;
+    const int64_t accu = fpp == ocl_fpp64 ? 8 : 4; // accu_t bytes
+    const int64_t row_bytes = (int64_t)n * ocl_fpp_bytes[fpp];
+    if (tile_bytes <= 0) { tile_bytes = 256 * MB; } // gemv.c default
+    int64_t rows = min(max(tile_bytes / row_bytes, 1), m);
+    if (rows > 16 && rows < m) { rows = rows / 16 * 16; }
+    ocl_memory_t tile = alloc(c, CL_MEM_READ_ONLY, (size_t)(rows * row_bytes));
+    if (tile == null) { return DBL_MAX; }
+    fp64_t time = DBL_MAX;
+    for (int repeat = 0; repeat < best_of; repeat++) {
+        fp64_t user = seconds();
+        for (int64_t y = 0; y < m; y += rows) {
+            const int64_t k = min(rows, m - y);
+            ocl_event_t e = ocl.write(c, tile, 0, (size_t)(k * row_bytes),
+                mx + y * row_bytes);
+            ocl.wait(&e, 1);
+            ocl.release_event(e);
+            gemv.gemv(g, fpp, 0, tile, 0, vector, y * accu, result, n, k);
+        }
+        user = seconds() - user;
+        time = min(time, user);
+    }
+    ocl.deallocate(tile);
+    return time;
+}
+
+static void streamed(gemv_t* g, int fpp, int32_t n, int32_t m,
+                     int64_t tile_bytes) {
+    // matrix stays in host memory and is streamed through device in tiles
+    ocl_context_t* c = g->c;
+    ocl_time = DBL_MAX;
+    gpu_time = DBL_MAX; // not profiled
+    avx_time = DBL_MAX;
+    cpu_time = DBL_MAX;
+    gpu_gfps = 0;
+    const size_t veb = fpp == ocl_fpp16 ? 4 : 8; // vector bytes
+    enum { write_only = CL_MEM_WRITE_ONLY|CL_MEM_HOST_WRITE_ONLY };
+    enum { read_only  = CL_MEM_READ_ONLY|CL_MEM_HOST_READ_ONLY };
+    byte_t* mx = host_matrix(fpp, n, m);
+    ocl_memory_t vector = alloc(c, write_only, (size_t)n * veb);
+    ocl_memory_t result = alloc(c, read_only,  (size_t)m * veb);
+    if (mx != null && vector != null && result != null) {
+        byte_t* vc = ocl.map(c, CL_MAP_WRITE, vector, 0, n * veb);
+        init_vector(fpp, vc, n);
+        void* avx = malloc(m * veb);
+        fatal_if(avx == null);
+        test_avx(fpp, mx, vc, avx, n, m);
+        ocl.unmap(c, vector, vc);
+        if (verbose) {
+            println("%s %d x %d streamed tile: %lldKB (0: default)",
+                ocl_fpp_names[fpp], n, m, tile_bytes / KB);
+        }
+        for (int repeat = 0; repeat < best_of; repeat++) {
+            fp64_t user = seconds();
+            gemv.stream(g, fpp, mx, 0, vector, 0, result, n, m, tile_bytes);
+            user = seconds() - user;
+            ocl_time = min(ocl_time, user);
+        }
+        byte_t* rs = ocl.map(c, CL_MAP_READ, result, 0, m * veb);
+        verify(fpp, avx, avx, 0, rs, n, m); // avx vs gpu only
+        ocl.unmap(c, result, rs);
+        // streamed (pinned staging, upload of next tile overlaps with
+        // gemv() of the current one) vs serialized uploads:
+        const fp64_t time = serialized(g, fpp, mx, vector, result, n, m,
+            tile_bytes);
+        if (time < DBL_MAX) {
+            rs = ocl.map(c, CL_MAP_READ, result, 0, m * veb);
+            verify(fpp, avx, avx, 0, rs, n, m);
+            ocl.unmap(c, result, rs);
+            // timing depends on device, driver and load: reported, not
+            // asserted (serialized / streamed > 1 means overlap helps):
+            println("%s %d x %d streamed: %.3f ms serialized: %.3f ms "
+                "speedup: %.2f", ocl_fpp_names[fpp], n, m,
+                ocl_time * MSEC_IN_SEC, time * MSEC_IN_SEC, time / ocl_time);
+        }
+        free(avx);
+        print(fpp, n, m); // performance measurements
+    }
+    ocl.deallocate(result);
+    ocl.deallocate(vector);
+    huge_free(mx);
+}
+
+static fp64_t activate(int activation, fp64_t s) {
+    switch (activation) {
+        case gemv_relu: return s > 0 ? s : 0;
+        case gemv_gelu: return 0.5 * s * (1 + tanh(0.7978845608028654 * (s + 0.044715 * s * s * s)));
+        case gemv_silu: return s / (1 + exp(-s));
+        default: return s;
+    }
+}
+
+static void fused(gemv_t* g) {
+    // rs = activation(alpha * mx * vc + beta * rs + bias) vs fp64 reference
+    // with bias and beta, without bias (null) and with beta == 0 (rs[]
+    // holds NaNs that must not be read):
+    ocl_context_t* c = g->c;
+    enum { n = 1024, m = 129 };
+    static const char* names[] = {"identity", "relu", "gelu", "silu"};
+    enum { write_only = CL_MEM_WRITE_ONLY|CL_MEM_HOST_WRITE_ONLY };
+    enum { read_write = CL_MEM_READ_WRITE };
+    for (int fpp = ocl_fpp_first; fpp <= ocl_fpp_last; fpp++) {
+        if (!ocl.has_fpp(c, fpp)) { continue; }
+        const size_t meb = ocl_fpp_bytes[fpp]; // matrix element bytes
+        const size_t veb = fpp == ocl_fpp64 ? 8 : 4; // accu_t bytes
+        ocl_memory_t matrix = ocl.allocate(c, write_only, n * m * meb);
+        ocl_memory_t vector = ocl.allocate(c, write_only, n * veb);
+        ocl_memory_t result = ocl.allocate(c, read_write, m * veb);
+        ocl_memory_t bias   = ocl.allocate(c, write_only, m * veb);
+        byte_t* mx = ocl.map(c, CL_MAP_WRITE, matrix, 0, n * m * meb);
+        byte_t* vc = ocl.map(c, CL_MAP_WRITE, vector, 0, n * veb);
+        init_mx_vc(fpp, mx, vc, 0, 0, n, m, init_mx1, init_vc1);
+        fp64_t mv[m]; // mx * vc
+        reference(fpp, mx, vc, mv, n, m, false);
+        ocl.unmap(c, vector, vc);
+        ocl.unmap(c, matrix, mx);
+        fp64_t b[m]; // bias
+        fp64_t r[m]; // initial result
+        byte_t* bp = ocl.map(c, CL_MAP_WRITE, bias, 0, m * veb);
+        for (int y = 0; y < m; y++) {
+            b[y] = (y % 7) - 3.0;
+            r[y] = (y % 5) - 2.0;
+            set_accu(fpp, bp, y, b[y]);
+        }
+        ocl.unmap(c, bias, bp);
+        static const char* variants[] = {"bias beta", "no bias", "beta 0"};
+        for (int v = 0; v < countof(variants); v++) {
+            const bool has_bias = v != 1;
+            const fp64_t beta = v == 2 ? 0 : 2.0;
+            for (int a = 0; a < gemv_activations; a++) {
+                byte_t* rp = ocl.map(c, CL_MAP_WRITE, result, 0, m * veb);
+                for (int y = 0; y < m; y++) {
+                    set_accu(fpp, rp, y, beta == 0 ? NAN : r[y]);
+                }
+                ocl.unmap(c, result, rp);
+                gemv_epilogue_t e = {
+                    .alpha = -0.5, .beta = beta,
+                    .bias = has_bias ? bias : null, .activation = a
+                };
+                gemv.fused(g, fpp, 0, matrix, 0, vector, 0, result, n, m, &e);
+                rp = ocl.map(c, CL_MAP_READ, result, 0, m * veb);
+                for (int y = 0; y < m; y++) {
+                    const fp64_t gpu = get_accu(fpp, rp, y);
+                    const fp64_t cpu = activate(a, e.alpha * mv[y] +
+                        (beta != 0 ? beta * r[y] : 0) + (has_bias ? b[y] : 0));
+                    fatal_if(!(fabs(gpu - cpu) <= 1e-3 * (1 + fabs(cpu))),
+                        "%s %s %s [%d] gpu: %g cpu: %g", ocl_fpp_names[fpp],
+                        names[a], variants[v], y, gpu, cpu);
+                }
+                ocl.unmap(c, result, rp);
+            }
+        }
+        ocl.deallocate(bias);
+        ocl.deallocate(result);
+        ocl.deallocate(vector);
+        ocl.deallocate(matrix);
+    }
+}
+
+static void transposed(gemv_t* g) {
+    // rs[n] = mx[m][n]^T * vc[m] vs fp64 reference and timing
+    ocl_context_t* c = g->c;
+    struct { int32_t n; int32_t m; } tests[] = {
+        {   1,    1},
+        {1000,  129},
+        {1003, 4 * 1024 + 3}, // column tail and several row chunks
+        {4 * 1024, 16 * 1024}
+    };
+    enum { write_only = CL_MEM_WRITE_ONLY|CL_MEM_HOST_WRITE_ONLY };
+    enum { read_only  = CL_MEM_READ_ONLY|CL_MEM_HOST_READ_ONLY };
+    for (int fpp = ocl_fpp_first; fpp <= ocl_fpp_last; fpp++) {
+        if (!ocl.has_fpp(c, fpp)) { continue; }
+        const size_t meb = ocl_fpp_bytes[fpp]; // matrix element bytes
+        const size_t veb = fpp == ocl_fpp64 ? 8 : 4; // accu_t bytes
+        for (int k = 0; k < countof(tests); k++) {
+            const int32_t n = tests[k].n;
+            const int32_t m = tests[k].m;
+            const size_t mbytes = (size_t)n * m * meb;
+            ocl_memory_t matrix = ocl.allocate(c, write_only, mbytes);
+            ocl_memory_t vector = ocl.allocate(c, write_only, m * veb);
+            ocl_memory_t result = ocl.allocate(c, read_only,  n * veb);
+            byte_t* mx = ocl.map(c, CL_MAP_WRITE, matrix, 0, mbytes);
+            byte_t* vc = ocl.map(c, CL_MAP_WRITE, vector, 0, m * veb);
+            init_mx_vc(fpp, mx, vc, 0, 0, n, m, init_mx1, null);
+            init_vector(fpp, vc, m);
+            fp64_t* cpu = (fp64_t*)malloc(n * sizeof(fp64_t));
+            fatal_if(cpu == null);
+            reference(fpp, mx, vc, cpu, n, m, true);
+            ocl.unmap(c, vector, vc);
+            ocl.unmap(c, matrix, mx);
+            fp64_t time = DBL_MAX;
+            for (int repeat = 0; repeat < best_of; repeat++) {
+                fp64_t user = seconds();
+                gemv.transposed(g, fpp, 0, matrix, 0, vector, 0, result, n, m);
+                user = seconds() - user;
+                time = min(time, user);
+            }
+            byte_t* rs = ocl.map(c, CL_MAP_READ, result, 0, n * veb);
+            for (int32_t x = 0; x < n; x++) {
+                const fp64_t gpu = get_accu(fpp, rs, x);
+                fatal_if(fabs(gpu - cpu[x]) > CL_FLT_EPSILON * m * (1 + fabs(cpu[x])),
+                    "%s %d x %d [%d] gpu: %g cpu: %g", ocl_fpp_names[fpp],
+                    n, m, x, gpu, cpu[x]);
+            }
+            ocl.unmap(c, result, rs);
+            free(cpu);
+            if (n > 64 && m > 64) {
+                const fp64_t bytes = (fp64_t)mbytes + (m + n) * veb;
+                println("%s %5d x %-5d transposed: %9.3f ms %5.1fGB/s",
+                    ocl_fpp_names[fpp], n, m, time * MSEC_IN_SEC,
+                    bytes / (time * NSEC_IN_SEC));
+            }
+            ocl.deallocate(result);
+            ocl.deallocate(vector);
+            ocl.deallocate(matrix);
+        }
+    }
+}
+
+static void batched(gemv_t* g) {
+    // rs[batch][m] = mx[m][n] * vc[batch][n] vs fp64 reference and timing
+    ocl_context_t* c = g->c;
+    struct { int32_t n; int32_t m; int32_t batch; } tests[] = {
+        {  32,    3,  3},
+        {1000,  129,  5}, // n % 16 != 0: gemv() per vector
+        {  64,   65, 20}, // more than gemv_max_batch vectors
+        {4 * 1024, 16 * 1024,  1},
+        {4 * 1024, 16 * 1024,  2},
+        {4 * 1024, 16 * 1024,  4},
+        {4 * 1024, 16 * 1024,  8},
+        {4 * 1024, 16 * 1024, 16}
+    };
+    enum { write_only = CL_MEM_WRITE_ONLY|CL_MEM_HOST_WRITE_ONLY };
+    enum { read_only  = CL_MEM_READ_ONLY|CL_MEM_HOST_READ_ONLY };
+    for (int fpp = ocl_fpp_first; fpp <= ocl_fpp_last; fpp++) {
+        if (!ocl.has_fpp(c, fpp)) { continue; }
+        const size_t meb = ocl_fpp_bytes[fpp]; // matrix element bytes
+        const size_t veb = fpp == ocl_fpp64 ? 8 : 4; // accu_t bytes
+        for (int k = 0; k < countof(tests); k++) {
+            const int32_t n = tests[k].n;
+            const int32_t m = tests[k].m;
+            const int32_t batch = tests[k].batch;
+            const size_t mbytes = (size_t)n * m * meb;
+            const size_t vbytes = (size_t)batch * n * veb;
+            const size_t rbytes = (size_t)batch * m * veb;
+            ocl_memory_t matrix = ocl.allocate(c, write_only, mbytes);
+            ocl_memory_t vector = ocl.allocate(c, write_only, vbytes);
+            ocl_memory_t result = ocl.allocate(c, read_only,  rbytes);
+            byte_t* mx = ocl.map(c, CL_MAP_WRITE, matrix, 0, mbytes);
+            byte_t* vc = ocl.map(c, CL_MAP_WRITE, vector, 0, vbytes);
+            init_mx_vc(fpp, mx, vc, 0, 0, n, m, init_mx1, init_vc1);
+            // vc[b][x] = vc[0][x] * (b + 1) so that results differ
+            for (int32_t b = 1; b < batch; b++) {
+                for (int32_t x = 0; x < n; x++) {
+                    set_accu(fpp, vc, b * n + x, get_accu(fpp, vc, x) * (b + 1));
+                }
+            }
+            fp64_t* cpu = (fp64_t*)malloc((size_t)batch * m * sizeof(fp64_t));
+            fatal_if(cpu == null);
+            reference(fpp, mx, vc, cpu, n, m, false); // mx * vc[0]
+            for (int32_t b = 1; b < batch; b++) {
+                for (int32_t y = 0; y < m; y++) { cpu[b * m + y] = cpu[y] * (b + 1); }
+            }
+            ocl.unmap(c, vector, vc);
+            ocl.unmap(c, matrix, mx);
+            fp64_t time = DBL_MAX;
+            for (int repeat = 0; repeat < best_of; repeat++) {
+                fp64_t user = seconds();
+                gemv.batch(g, fpp, 0, matrix, 0, vector, 0, result,
+                    n, m, batch);
+                user = seconds() - user;
+                time = min(time, user);
+            }
+            byte_t* rs = ocl.map(c, CL_MAP_READ, result, 0, rbytes);
+            for (int32_t i = 0; i < batch * m; i++) {
+                const fp64_t gpu = get_accu(fpp, rs, i);
+                fatal_if(fabs(gpu - cpu[i]) > CL_FLT_EPSILON * n * (1 + fabs(cpu[i])),
+                    "%s %d x %d batch: %d [%d][%d] gpu: %g cpu: %g",
+                    ocl_fpp_names[fpp], n, m, batch, i / m, i % m, gpu, cpu[i]);
+            }
+            ocl.unmap(c, result, rs);
+            free(cpu);
+            if (n > 64 && m > 64) {
+                println("%s %5d x %-5d batch: %2d %9.3f ms %9.3f ms/vector",
+                    ocl_fpp_names[fpp], n, m, batch, time * MSEC_IN_SEC,
+                    time * MSEC_IN_SEC / batch);
+            }
+            ocl.deallocate(result);
+            ocl.deallocate(vector);
+            ocl.deallocate(matrix);
+        }
+    }
+}
+
+static void async(gemv_t* g) {
+    // two chained non-blocking gemv() (second uses result of the first
+    // as vector) must match blocking gemv() results exactly:
+    ocl_context_t* c = g->c;
+    enum { n = 1024 };
+    enum { write_only = CL_MEM_WRITE_ONLY|CL_MEM_HOST_WRITE_ONLY };
+    enum { read_write = CL_MEM_READ_WRITE };
+    for (int fpp = ocl_fpp_first; fpp <= ocl_fpp_last; fpp++) {
+        if (!ocl.has_fpp(c, fpp)) { continue; }
+        const size_t meb = ocl_fpp_bytes[fpp]; // matrix element bytes
+        const size_t veb = fpp == ocl_fpp64 ? 8 : 4; // accu_t bytes
+        ocl_memory_t matrix = ocl.allocate(c, write_only, n * n * meb);
+        ocl_memory_t vector = ocl.allocate(c, write_only, n * veb);
+        ocl_memory_t r[4] = { // async 0, 1 and blocking 0, 1
+            ocl.allocate(c, read_write, n * veb),
+            ocl.allocate(c, read_write, n * veb),
+            ocl.allocate(c, read_write, n * veb),
+            ocl.allocate(c, read_write, n * veb)
+        };
+        byte_t* mx = ocl.map(c, CL_MAP_WRITE, matrix, 0, n * n * meb);
+        byte_t* vc = ocl.map(c, CL_MAP_WRITE, vector, 0, n * veb);
+        init_mx_vc(fpp, mx, vc, 0, 0, n, n, init_mx1, init_vc1);
+        ocl.unmap(c, vector, vc);
+        ocl.unmap(c, matrix, mx);
+        ocl_event_t e0 = gemv.async(g, fpp, 0, matrix, 0, vector, 0, r[0],
+            n, n, null, 0, null);
+        ocl_event_t e1 = gemv.async(g, fpp, 0, matrix, 0, r[0], 0, r[1],
+            n, n, null, 1, &e0);
+        ocl.wait(&e1, 1);
+        ocl.release_event(e1);
+        ocl.release_event(e0);
+        gemv.gemv(g, fpp, 0, matrix, 0, vector, 0, r[2], n, n);
+        gemv.gemv(g, fpp, 0, matrix, 0, r[2], 0, r[3], n, n);
+        byte_t* a = ocl.map(c, CL_MAP_READ, r[1], 0, n * veb);
+        byte_t* b = ocl.map(c, CL_MAP_READ, r[3], 0, n * veb);
+        fatal_if(memcmp(a, b, n * veb) != 0, "%s", ocl_fpp_names[fpp]);
+        ocl.unmap(c, r[3], b);
+        ocl.unmap(c, r[1], a);
+        for (int i = 0; i < countof(r); i++) { ocl.deallocate(r[i]); }
+        ocl.deallocate(vector);
+        ocl.deallocate(matrix);
+    }
+}
+
 // TODO test with offsets 1..65
 
 static void permutations(gemv_t* g) {
@@ -429,19 +826,25 @@ static void performance(gemv_t* g) {
                 const int64_t m = tests[k].m;
                 const int64_t bytes = n * m * ocl_fpp_bytes[fpp];
                 const ocl_device_t* d = &ocl.devices[g->c->ix];
-                if (bytes < d->global_memory) {
 #if 0
-                    double gb = bytes / (double)GB;
-                    double dgb = d->global_memory / (double)GB;
-                    println("%d x %d %.3fGB of %.3fGB", n, m, gb, dgb);
-                    println("press any key to continue");
-                    while (_kbhit() == 0) { sleep(1.0 / 64); }
-                    getch();
+                double gb = bytes / (double)GB;
+                double dgb = d->global_memory / (double)GB;
+                println("%d x %d %.3fGB of %.3fGB", n, m, gb, dgb);
+                println("press any key to continue");
+                while (_kbhit() == 0) { sleep(1.0 / 64); }
+                getch();
 #endif
-                    test(g, fpp, 0, 0, 0, tests[k].n, tests[k].m,
-                        init_mx1, init_vc1);
+                // does not fit into device memory or exceeds single
+                // allocation (CL_DEVICE_MAX_MEM_ALLOC_SIZE) or mapping
+                // limits: stream from host memory
+                if (bytes >= d->global_memory ||
+                    !test(g, fpp, 0, 0, 0, tests[k].n, tests[k].m,
+                          init_mx1, init_vc1)) {
+                    streamed(g, fpp, tests[k].n, tests[k].m, 0);
                 }
             }
+            // many small tiles, odd number of rows in the last tile:
+            streamed(g, fpp, 4 * 1024, 4 * 1024 + 3, 1 * MB);
         }
     }
 }
@@ -462,12 +865,78 @@ static void tests(bool profile) {
         gemv_t g = {0};
         gemv.init(&g, &c);
         if (profile) { permutations(&g); } // only once on the first pass
+        if (profile) { fused(&g); }
+        if (profile) { transposed(&g); }
+        if (profile) { batched(&g); }
+        if (profile) { async(&g); }
         performance(&g);
         gemv.fini(&g);
         ocl.close(&c);
     }
 }
 
+static void multi_device(void) {
+    // all devices at once: rows split by calibrated throughput.
+    // A single device still runs multi_init()/multi()/multi_fini():
+    const int count = min(ocl.count, gemv_max_devices);
+    if (count < 1) { return; }
+    static ocl_context_t c[gemv_max_devices];
+    static gemv_t g[gemv_max_devices];
+    gemv_t* gp[gemv_max_devices];
+    for (int i = 0; i < count; i++) {
+        c[i] = ocl.open(i, null);
+        gemv.init(&g[i], &c[i]);
+        gp[i] = &g[i];
+    }
+    enum { n = 4 * 1024, m = 16 * 1024 };
+    for (int fpp = ocl_fpp_first; fpp <= ocl_fpp_last; fpp++) {
+        int capable = 0;
+        for (int i = 0; i < count; i++) { capable += ocl.has_fpp(&c[i], fpp); }
+        if (capable == 0) { continue; }
+        const size_t veb = fpp == ocl_fpp64 ? 8 : 4; // accu_t bytes
+        byte_t* mx = host_matrix(fpp, n, m);
+        byte_t* vc = (byte_t*)malloc(n * veb);
+        byte_t* rs = (byte_t*)malloc(m * veb);
+        byte_t* avx = (byte_t*)malloc(m * veb);
+        fatal_if(mx == null || vc == null || rs == null || avx == null);
+        init_vector(fpp, vc, n);
+        avx_time = DBL_MAX;
+        test_avx(fpp, mx, vc, avx, n, m);
+        for (int i = 0; i < count; i++) { gemv.calibrate(&g[i], fpp); }
+        gemv_multi_t mm;
+        gemv.multi_init(&mm, gp, count, fpp, mx, n, m);
+        fp64_t time = DBL_MAX;
+        for (int repeat = 0; repeat < best_of; repeat++) {
+            memset(rs, 0, m * veb);
+            fp64_t user = seconds();
+            gemv.multi(&mm, vc, rs);
+            user = seconds() - user;
+            time = min(time, user);
+            verify(fpp, avx, avx, 0, rs, n, m); // avx vs gpu only
+        }
+        println("%s %5d x %-5d %d devices: %9.3f ms avx: %9.3f ms",
+            ocl_fpp_names[fpp], n, m, capable, time * MSEC_IN_SEC,
+            avx_time * MSEC_IN_SEC);
+        for (int i = 0; i < count; i++) {
+            if (mm.rows[i] > 0) {
+                println("    %s: %lld rows %s gemv: %.1fGB/s stream: %.1fGB/s",
+                    ocl.devices[i].name, mm.rows[i],
+                    mm.resident[i] != null ? "resident" : "streamed",
+                    g[i].throughput[fpp] / GB, g[i].streaming[fpp] / GB);
+            }
+        }
+        gemv.multi_fini(&mm);
+        free(avx);
+        free(rs);
+        free(vc);
+        huge_free(mx);
+    }
+    for (int i = 0; i < count; i++) {
+        gemv.fini(&g[i]);
+        ocl.close(&c[i]);
+    }
+}
+
 int32_t main(int32_t argc, const char* argv[]) {
     (void)argc; (void)argv;
     ocl.init();
@@ -480,8 +949,10 @@ int32_t main(int32_t argc, const char* argv[]) {
     } else {
         tests(true);  // with profiling
         tests(false); // w/o  profiling
+        multi_device();
     }
     if (dot.test != null) { dot.test(); }
+    if (tensor.test != null) { tensor.test(); }
 }
 
 #if 0
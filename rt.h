@@ -1,6 +1,7 @@
 #pragma once
 #include <assert.h>
 #include <ctype.h>
+#include <errno.h>
 #include <float.h>
 #include <io.h>
 #include <malloc.h>
@@ -32,9 +33,51 @@ int64_t  nanoseconds(); // nanoseconds since boot (3/10MHz resolution)
 void     printline(const char* file, int line, const char* func,
                    const char* format, ...);
 int      memmap_resource(const char* label, void* *data, int64_t *bytes);
+// memmap_file() maps whole non empty file read only, returns 0 or errno:
+int      memmap_file(const char* filename, void* *data, int64_t *bytes);
+void     memunmap_file(void* data);
 void*    load_dl(const char* pathname); // dlopen | LoadLibrary
 void*    find_symbol(void* dl, const char* symbol); // dlsym | GetProcAddress
 void     sleep(double seconds);
+int32_t  cores(void);   // number of logical processors
+// parallel() calls task(that, i) for i in [0..count - 1] on a persistent
+// pool of cores() worker threads (calling thread is one of them) and
+// returns when all tasks are done. Thread safe: concurrent calls from
+// different threads are serialized and each one gets the whole pool in turn.
+// Not reentrant: task() must not call it (deadlocks on the pool lock).
+void     parallel(int32_t count, void (*task)(void* that, int32_t i), void* that);
+// mutex_t is Win32 SRWLOCK, zero initialized mutex is unlocked. Not recursive:
+typedef struct mutex_s { void* lock; } mutex_t;
+void     mutex_lock(mutex_t* m);
+void     mutex_unlock(mutex_t* m);
+
+// NUMA: nodes are numbered [0..numa_nodes() - 1], single node on UMA systems
+typedef struct numa_affinity_s { // Win32 GROUP_AFFINITY
+    uint64_t mask;
+    uint16_t group;
+    uint16_t reserved[3];
+} numa_affinity_t;
+
+int32_t  numa_nodes(void);
+int32_t  numa_cores(int32_t node); // logical processors of the node
+// numa_reserve() reserves page aligned address space, numa_commit() commits
+// pages of [p..p + bytes - 1] physically placed on the node (or anywhere
+// for node < 0) on the first touch, numa_free() releases reserved memory:
+void*    numa_reserve(int64_t bytes);
+bool     numa_commit(void* p, int64_t bytes, int32_t node);
+void     numa_free(void* p);
+// numa_bind() restricts calling thread to the node processors and returns
+// previous affinity for numa_unbind():
+bool     numa_bind(int32_t node, numa_affinity_t* previous);
+void     numa_unbind(const numa_affinity_t* previous);
+
+// huge_alloc() returns zeroed memory aligned at least to 64KB and backed by
+// large (2MB on x64) pages when the process holds SeLockMemoryPrivilege
+// ("Lock pages in memory" user right) or by regular 4KB pages otherwise.
+// page_size (can be null) receives the size of the pages used. Large pages reduce TLB misses while streaming gigabytes
+// of gemv weights.
+void*    huge_alloc(int64_t bytes, int64_t* page_size);
+void     huge_free(void* p);
 
 #if defined(__GNUC__) || defined(__clang__)
 #define attribute_packed __attribute__((packed))
@@ -138,6 +181,51 @@ void*    __stdcall LoadResource(void* module, void* res);
 void*    __stdcall LockResource(void* res);
 void*    __stdcall LoadLibraryA(const char* pathname);
 void*    __stdcall GetProcAddress(void* module, const char* pathname);
+void*    __stdcall CreateThread(void* attributes, size_t stack_size,
+                    uint32_t (__stdcall *start)(void* that), void* that,
+                    uint32_t flags, uint32_t* id);
+void*    __stdcall CreateEventA(void* attributes, int32_t manual_reset,
+                    int32_t initial_state, const char* name);
+int32_t  __stdcall SetEvent(void* event);
+uint32_t __stdcall WaitForSingleObject(void* handle, uint32_t milliseconds);
+uint32_t __stdcall WaitForMultipleObjects(uint32_t count, void* const* handles,
+                    int32_t wait_all, uint32_t milliseconds);
+uint32_t __stdcall GetActiveProcessorCount(uint16_t group);
+void     __stdcall AcquireSRWLockExclusive(void* lock);
+void     __stdcall ReleaseSRWLockExclusive(void* lock);
+int32_t  __stdcall GetNumaHighestNodeNumber(uint32_t* highest);
+int32_t  __stdcall GetNumaNodeProcessorMaskEx(uint16_t node,
+                    numa_affinity_t* affinity);
+void*    __stdcall GetCurrentThread(void);
+void*    __stdcall GetCurrentProcess(void);
+int32_t  __stdcall SetThreadGroupAffinity(void* thread,
+                    const numa_affinity_t* affinity, numa_affinity_t* previous);
+void*    __stdcall VirtualAllocExNuma(void* process, void* address,
+                    size_t bytes, uint32_t type, uint32_t protect,
+                    uint32_t node);
+int32_t  __stdcall VirtualFree(void* address, size_t bytes, uint32_t type);
+void*    __stdcall VirtualAlloc(void* address, size_t bytes, uint32_t type,
+                    uint32_t protect);
+size_t   __stdcall GetLargePageMinimum(void);
+int32_t  __stdcall OpenProcessToken(void* process, uint32_t access,
+                    void* *token);
+int32_t  __stdcall LookupPrivilegeValueA(const char* system, const char* name,
+                    void* luid);
+int32_t  __stdcall AdjustTokenPrivileges(void* token, int32_t disable_all,
+                    void* state, uint32_t bytes, void* previous,
+                    uint32_t* length);
+uint32_t __stdcall GetLastError(void);
+int32_t  __stdcall CloseHandle(void* handle);
+void*    __stdcall CreateFileA(const char* filename, uint32_t access,
+                    uint32_t share, void* security, uint32_t disposition,
+                    uint32_t flags, void* template_file);
+int32_t  __stdcall GetFileSizeEx(void* file, int64_t* bytes);
+void*    __stdcall CreateFileMappingA(void* file, void* security,
+                    uint32_t protect, uint32_t size_high, uint32_t size_low,
+                    const char* name);
+void*    __stdcall MapViewOfFile(void* mapping, uint32_t access,
+                    uint32_t offset_high, uint32_t offset_low, size_t bytes);
+int32_t  __stdcall UnmapViewOfFile(const void* address);
 
 
 double seconds() { // since_boot
@@ -194,6 +282,58 @@ int memmap_resource(const char* label, void* *data, int64_t *bytes) {
     return *data != null ? 0 : 1;
 }
 
+#define GENERIC_READ           0x80000000
+#define FILE_SHARE_READ        0x00000001
+#define OPEN_EXISTING          3
+#define FILE_ATTRIBUTE_NORMAL  0x00000080
+#define PAGE_READONLY          0x02
+#define FILE_MAP_READ          0x0004
+#define INVALID_HANDLE_VALUE   ((void*)(intptr_t)-1)
+
+static int memmap_errno(void) { // GetLastError() -> errno
+    switch (GetLastError()) {
+        case 2:    return ENOENT; // ERROR_FILE_NOT_FOUND
+        case 3:    return ENOENT; // ERROR_PATH_NOT_FOUND
+        case 5:    return EACCES; // ERROR_ACCESS_DENIED
+        case 8:    return ENOMEM; // ERROR_NOT_ENOUGH_MEMORY
+        case 32:   return EACCES; // ERROR_SHARING_VIOLATION
+        case 1455: return ENOMEM; // ERROR_COMMITMENT_LIMIT
+        default:   return EIO;
+    }
+}
+
+int memmap_file(const char* filename, void* *data, int64_t *bytes) {
+    *data = null;
+    *bytes = 0;
+    int r = 0;
+    void* file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, null,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, null);
+    if (file == INVALID_HANDLE_VALUE) {
+        r = memmap_errno();
+    } else {
+        if (!GetFileSizeEx(file, bytes)) {
+            r = memmap_errno();
+        } else if (*bytes == 0) {
+            r = EINVAL; // empty files can not be mapped
+        } else {
+            // the view keeps the mapping and the file open after close:
+            void* mapping = CreateFileMappingA(file, null, PAGE_READONLY,
+                                               0, 0, null);
+            *data = mapping == null ? null :
+                MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (*data == null) { r = memmap_errno(); }
+            if (mapping != null) { fatal_if(!CloseHandle(mapping)); }
+        }
+        fatal_if(!CloseHandle(file));
+    }
+    if (r != 0) { *bytes = 0; }
+    return r;
+}
+
+void memunmap_file(void* data) {
+    if (data != null) { fatal_if(!UnmapViewOfFile(data)); }
+}
+
 // posix
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/dlsym.html
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/dlopen.html
@@ -229,6 +369,223 @@ void sleep(double seconds) {
     NtDelayExecution(false, &delay);
 }
 
+enum { INFINITE_WAIT = 0xFFFFFFFF, ALL_PROCESSOR_GROUPS = 0xFFFF };
+
+int32_t cores(void) {
+    static int32_t count;
+    if (count == 0) {
+        count = (int32_t)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+        if (count <= 0) { count = 1; }
+    }
+    return count;
+}
+
+void mutex_lock(mutex_t* m)   { AcquireSRWLockExclusive(&m->lock); }
+
+void mutex_unlock(mutex_t* m) { ReleaseSRWLockExclusive(&m->lock); }
+
+// WaitForMultipleObjects() is limited to 64 handles:
+enum { parallel_max_threads = 64 };
+
+static struct {
+    mutex_t lock;         // serializes parallel() calls and lazy init
+    int32_t threads;      // including the calling thread
+    void*   go[parallel_max_threads];   // auto-reset events
+    void*   done[parallel_max_threads];
+    // current parallel() invocation:
+    int32_t count;
+    void  (*task)(void* that, int32_t i);
+    void*   that;
+} parallel_pool;
+
+static void parallel_run(int32_t k) { // k-th thread share of tasks
+    for (int32_t i = k; i < parallel_pool.count; i += parallel_pool.threads) {
+        parallel_pool.task(parallel_pool.that, i);
+    }
+}
+
+static uint32_t __stdcall parallel_worker(void* that) {
+    const int32_t k = (int32_t)(intptr_t)that;
+    for (;;) {
+        WaitForSingleObject(parallel_pool.go[k], INFINITE_WAIT);
+        parallel_run(k);
+        SetEvent(parallel_pool.done[k]);
+    }
+}
+
+static void parallel_init(void) {
+    int32_t n = min(cores(), parallel_max_threads);
+    for (int32_t k = 1; k < n; k++) {
+        parallel_pool.go[k]   = CreateEventA(null, false, false, null);
+        parallel_pool.done[k] = CreateEventA(null, false, false, null);
+        fatal_if(parallel_pool.go[k] == null || parallel_pool.done[k] == null);
+        void* thread = CreateThread(null, 0, parallel_worker,
+            (void*)(intptr_t)k, 0, null);
+        fatal_if(thread == null);
+    }
+    parallel_pool.threads = n;
+}
+
+void parallel(int32_t count, void (*task)(void* that, int32_t i), void* that) {
+    mutex_lock(&parallel_pool.lock);
+    if (parallel_pool.threads == 0) { parallel_init(); }
+    const int32_t n = min(parallel_pool.threads, count); // threads to wake
+    if (n <= 1) {
+        for (int32_t i = 0; i < count; i++) { task(that, i); }
+    } else {
+        parallel_pool.count = count;
+        parallel_pool.task  = task;
+        parallel_pool.that  = that;
+        for (int32_t k = 1; k < n; k++) { SetEvent(parallel_pool.go[k]); }
+        parallel_run(0);
+        WaitForMultipleObjects(n - 1, &parallel_pool.done[1], true,
+            INFINITE_WAIT);
+    }
+    mutex_unlock(&parallel_pool.lock);
+}
+
+enum {
+    MEM_COMMIT  = 0x00001000,
+    MEM_RESERVE = 0x00002000,
+    MEM_RELEASE = 0x00008000,
+    PAGE_READWRITE = 0x04,
+    NUMA_NO_PREFERRED_NODE = 0xFFFFFFFF
+};
+
+int32_t numa_nodes(void) {
+    static int32_t count;
+    if (count == 0) {
+        uint32_t highest = 0;
+        count = GetNumaHighestNodeNumber(&highest) ? (int32_t)highest + 1 : 1;
+    }
+    return count;
+}
+
+int32_t numa_cores(int32_t node) {
+    numa_affinity_t a = {0};
+    int32_t count = 0;
+    if (GetNumaNodeProcessorMaskEx((uint16_t)node, &a)) {
+        for (uint64_t m = a.mask; m != 0; m &= m - 1) { count++; }
+    }
+    return count;
+}
+
+void* numa_reserve(int64_t bytes) {
+    return VirtualAllocExNuma(GetCurrentProcess(), null, (size_t)bytes,
+        MEM_RESERVE, PAGE_READWRITE, NUMA_NO_PREFERRED_NODE);
+}
+
+bool numa_commit(void* p, int64_t bytes, int32_t node) {
+    // committing already committed pages does not move them:
+    const uint32_t preferred = node < 0 ? NUMA_NO_PREFERRED_NODE : (uint32_t)node;
+    return VirtualAllocExNuma(GetCurrentProcess(), p, (size_t)bytes,
+        MEM_COMMIT, PAGE_READWRITE, preferred) != null;
+}
+
+void numa_free(void* p) {
+    if (p != null) { fatal_if(!VirtualFree(p, 0, MEM_RELEASE)); }
+}
+
+bool numa_bind(int32_t node, numa_affinity_t* previous) {
+    numa_affinity_t a = {0};
+    return GetNumaNodeProcessorMaskEx((uint16_t)node, &a) &&
+           SetThreadGroupAffinity(GetCurrentThread(), &a, previous);
+}
+
+void numa_unbind(const numa_affinity_t* previous) {
+    fatal_if(!SetThreadGroupAffinity(GetCurrentThread(), previous, null));
+}
+
+#pragma comment(lib, "advapi32")
+
+enum {
+    MEM_LARGE_PAGES = 0x20000000,
+    TOKEN_QUERY             = 0x0008,
+    TOKEN_ADJUST_PRIVILEGES = 0x0020,
+    SE_PRIVILEGE_ENABLED    = 0x0002
+};
+
+typedef struct huge_privilege_s { // TOKEN_PRIVILEGES with single privilege
+    uint32_t count;
+    uint32_t luid_low;
+    int32_t  luid_high;
+    uint32_t attributes;
+} huge_privilege_t;
+
+static int64_t huge_page_size(void) { // 0 if large pages are not permitted
+    static int64_t size = -1;
+    if (size < 0) {
+        size = 0;
+        void* token = null;
+        if (OpenProcessToken(GetCurrentProcess(),
+                TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+            huge_privilege_t p = { .count = 1, .attributes = SE_PRIVILEGE_ENABLED };
+            // AdjustTokenPrivileges() succeeds with ERROR_NOT_ALL_ASSIGNED
+            // when the user does not have the right:
+            if (LookupPrivilegeValueA(null, "SeLockMemoryPrivilege", &p.luid_low) &&
+                AdjustTokenPrivileges(token, false, &p, 0, null, null) &&
+                GetLastError() == 0) {
+                size = (int64_t)GetLargePageMinimum();
+            }
+            CloseHandle(token);
+        }
+    }
+    return size;
+}
+
+void* huge_alloc(int64_t bytes, int64_t* page_size) {
+    assert(bytes > 0);
+    const int64_t large = huge_page_size();
+    void* p = null;
+    if (large > 0) {
+        const int64_t rounded = (bytes + large - 1) / large * large;
+        p = VirtualAlloc(null, (size_t)rounded,
+            MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+    }
+    if (page_size != null) { *page_size = p != null ? large : 4 * 1024; }
+    if (p == null) {
+        p = VirtualAlloc(null, (size_t)bytes, MEM_RESERVE | MEM_COMMIT,
+                         PAGE_READWRITE);
+    }
+    return p;
+}
+
+void huge_free(void* p) {
+    if (p != null) { fatal_if(!VirtualFree(p, 0, MEM_RELEASE)); }
+}
+
+/* POSIX: MAP_HUGETLB pages reserved in hugetlbfs or, if none, transparent
+   huge pages which the kernel may still back by 4KB pages. munmap() needs
+   address and size of the whole mapping: keep them in front of the 2MB
+   aligned memory (costs one extra 2MB page):
+#include <sys/mman.h>
+void* huge_alloc(int64_t bytes, int64_t* page_size) {
+    const int64_t huge = 2 * 1024 * 1024;
+    const int64_t rounded = (bytes + 16 + huge - 1) / huge * huge + huge;
+    int64_t size = huge;
+    uint8_t* p = mmap(null, rounded, PROT_READ|PROT_WRITE,
+                      MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (p == MAP_FAILED) {
+        p = mmap(null, rounded, PROT_READ|PROT_WRITE,
+                 MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        size = p != MAP_FAILED && madvise(p, rounded, MADV_HUGEPAGE) == 0 ?
+               huge : 4 * 1024;
+    }
+    if (page_size != null) { *page_size = size; }
+    if (p == MAP_FAILED) { return null; }
+    uint8_t* a = (uint8_t*)(((uintptr_t)p + 16 + huge - 1) & ~(huge - 1));
+    ((int64_t*)a)[-2] = (int64_t)p;
+    ((int64_t*)a)[-1] = rounded;
+    return a;
+}
+void huge_free(void* p) {
+    if (p != null) {
+        const int64_t* h = (const int64_t*)p - 2;
+        fatal_if(munmap((void*)h[0], h[1]) != 0);
+    }
+}
+*/
+
 /* POSIX:
 #include <time.h>
 void sleep(double seconds) {
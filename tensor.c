@@ -0,0 +1,267 @@
+#include <errno.h>
+#include "tensor.h"
+#include "dot.h"
+
+static_assertion(sizeof(tensor_header_t) == 16);
+static_assertion(sizeof(tensor_t) == 160);
+
+static bool tensor_mul(int64_t a, int64_t b, int64_t* r) { // a, b >= 0
+    if (a != 0 && b > INT64_MAX / a) { return false; }
+    *r = a * b;
+    return true;
+}
+
+static bool tensor_add(int64_t a, int64_t b, int64_t* r) { // a, b >= 0
+    if (b > INT64_MAX - a) { return false; }
+    *r = a + b;
+    return true;
+}
+
+// payload bytes of the span of elements addressed by shape and strides or
+// -1 if it does not fit into int64_t or does not hold all the elements
+// (strides must not alias elements). t must be tensor_valid():
+static int64_t tensor_bytes(const tensor_t* t) {
+    int64_t span = 1;
+    int64_t elements = 1;
+    bool ok = true;
+    for (int32_t i = 0; ok && i < t->rank; i++) {
+        int64_t delta = 0;
+        ok = tensor_mul(t->shape[i] - 1, t->strides[i], &delta) &&
+             tensor_add(span, delta, &span) &&
+             tensor_mul(elements, t->shape[i], &elements);
+    }
+    int64_t bytes = -1;
+    if (ok && span >= elements) {
+        switch (t->type) {
+            case tensor_fp16: ok = tensor_mul(span, sizeof(fp16_t), &bytes); break;
+            case tensor_bf16: ok = tensor_mul(span, sizeof(bf16_t), &bytes); break;
+            case tensor_fp32: ok = tensor_mul(span, sizeof(fp32_t), &bytes); break;
+            case tensor_fp64: ok = tensor_mul(span, sizeof(fp64_t), &bytes); break;
+            case tensor_q8:   ok = tensor_mul(span / q8_block, sizeof(q8_t), &bytes); break;
+            case tensor_q4:   ok = tensor_mul(span / q4_block, sizeof(q4_t), &bytes); break;
+            case tensor_q4m:  ok = tensor_mul(span / q4_block, sizeof(q4m_t), &bytes); break;
+            default: ok = false; break;
+        }
+    }
+    return ok && bytes > 0 ? bytes : -1;
+}
+
+static bool tensor_valid(const tensor_t* t) {
+    bool valid = 0 <= t->type && t->type < tensor_types &&
+        1 <= t->rank && t->rank <= tensor_max_rank &&
+        memchr(t->name, 0, sizeof(t->name)) != null;
+    for (int32_t i = 0; valid && i < t->rank; i++) {
+        valid = t->shape[i] > 0 && t->strides[i] >= 0;
+    }
+    if (valid && t->type >= tensor_q8) { // quantized must be contiguous
+        const int64_t block = t->type == tensor_q8 ? q8_block : q4_block;
+        int64_t stride = 1;
+        for (int32_t i = t->rank - 1; valid && i >= 0; i--) {
+            valid = t->strides[i] == stride;
+            if (!tensor_mul(stride, t->shape[i], &stride)) { stride = INT64_MAX; }
+        }
+        valid = valid && t->shape[t->rank - 1] % block == 0;
+    }
+    return valid;
+}
+
+static uint64_t tensor_checksum(const uint8_t* p, int64_t bytes) {
+    uint64_t h = 0xCBF29CE484222325ULL; // FNV-1a 64
+    for (int64_t i = 0; i < bytes; i++) { h = (h ^ p[i]) * 0x100000001B3ULL; }
+    return h;
+}
+
+static int64_t tensor_aligned(int64_t offset) {
+    return (offset + tensor_alignment - 1) / tensor_alignment * tensor_alignment;
+}
+
+static int tensor_write(const char* filename, tensor_t* tensors,
+        const void* const* data, int32_t count) {
+    int r = 0;
+    int64_t offset = sizeof(tensor_header_t) + count * sizeof(tensor_t);
+    for (int32_t k = 0; k < count && r == 0; k++) {
+        tensor_t* t = &tensors[k];
+        bool row_major = true;
+        for (int32_t i = 0; i < t->rank && i < tensor_max_rank; i++) {
+            row_major = row_major && t->strides[i] == 0;
+        }
+        if (row_major && 1 <= t->rank && t->rank <= tensor_max_rank) {
+            int64_t stride = 1; // overflow is caught by tensor_bytes()
+            for (int32_t i = t->rank - 1; i >= 0; i--) {
+                t->strides[i] = stride;
+                if (!tensor_mul(stride, max(t->shape[i], 0), &stride)) {
+                    stride = INT64_MAX;
+                }
+            }
+        }
+        const int64_t bytes = tensor_valid(t) ? tensor_bytes(t) : -1;
+        int64_t end = 0;
+        if (bytes < 0 || offset > INT64_MAX - tensor_alignment ||
+            !tensor_add(tensor_aligned(offset), bytes, &end)) {
+            r = EINVAL;
+        } else {
+            t->offset = tensor_aligned(offset);
+            t->bytes = bytes;
+            t->checksum = tensor_checksum((const uint8_t*)data[k], t->bytes);
+            offset = end;
+        }
+    }
+    FILE* f = r == 0 ? fopen(filename, "wb") : null;
+    if (r == 0 && f == null) { r = errno; }
+    if (f != null) {
+        static const uint8_t zeros[tensor_alignment];
+        tensor_header_t h = { .magic = tensor_magic,
+            .version = tensor_version, .count = count };
+        bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+            fwrite(tensors, sizeof(tensor_t), count, f) == (size_t)count;
+        offset = sizeof(tensor_header_t) + count * sizeof(tensor_t);
+        for (int32_t k = 0; k < count && ok; k++) {
+            const size_t padding = (size_t)(tensors[k].offset - offset);
+            ok = fwrite(zeros, 1, padding, f) == padding &&
+                 fwrite(data[k], 1, (size_t)tensors[k].bytes, f) ==
+                    (size_t)tensors[k].bytes;
+            offset = tensors[k].offset + tensors[k].bytes;
+        }
+        if (!ok) { r = errno != 0 ? errno : EIO; }
+        if (fclose(f) != 0 && r == 0) { r = errno; }
+        if (r != 0) { remove(filename); }
+    }
+    return r;
+}
+
+static void tensor_close(tensor_file_t* f) {
+    memunmap_file((void*)f->data);
+    memset(f, 0, sizeof(*f));
+}
+
+static int tensor_validate(tensor_file_t* f) {
+    const tensor_header_t* h = (const tensor_header_t*)f->data;
+    bool valid = f->bytes >= (int64_t)sizeof(*h) &&
+        h->magic == tensor_magic && h->version == tensor_version &&
+        h->count >= 0 && (f->bytes - (int64_t)sizeof(*h)) /
+            (int64_t)sizeof(tensor_t) >= h->count;
+    if (valid) {
+        f->count = h->count;
+        f->tensors = (const tensor_t*)(f->data + sizeof(*h));
+    }
+    for (int32_t k = 0; valid && k < f->count; k++) {
+        const tensor_t* t = &f->tensors[k];
+        valid = tensor_valid(t) && t->bytes > 0 && t->bytes == tensor_bytes(t) &&
+            t->offset % tensor_alignment == 0 && t->offset > 0 &&
+            t->offset <= f->bytes && t->bytes <= f->bytes - t->offset;
+    }
+    return valid ? 0 : EINVAL;
+}
+
+static int tensor_open(tensor_file_t* f, const char* filename) {
+    memset(f, 0, sizeof(*f));
+    void* data = null;
+    int r = memmap_file(filename, &data, &f->bytes);
+    f->data = (const uint8_t*)data;
+    if (r == 0) { r = tensor_validate(f); }
+    if (r != 0) { tensor_close(f); }
+    return r;
+}
+
+static const tensor_t* tensor_find(const tensor_file_t* f, const char* name) {
+    for (int32_t k = 0; k < f->count; k++) {
+        if (strcmp(f->tensors[k].name, name) == 0) { return &f->tensors[k]; }
+    }
+    return null;
+}
+
+static const void* tensor_data(const tensor_file_t* f, const tensor_t* t) {
+    assert(f->tensors <= t && t < f->tensors + f->count);
+    return f->data + t->offset;
+}
+
+static bool tensor_verify(const tensor_file_t* f, const tensor_t* t) {
+    return tensor_checksum((const uint8_t*)tensor_data(f, t), t->bytes) ==
+           t->checksum;
+}
+
+#define TENSOR_TEST
+// #undef TENSOR_TEST
+
+#ifdef TENSOR_TEST
+
+static void tensor_test(void) {
+    // gemv over memory mapped matrix must be the same as over the original
+    enum { n = 1024, m = 129 };
+    static const char* filename = "tensor_test.bin";
+    fp32_t* mx = (fp32_t*)malloc(n * m * sizeof(fp32_t));
+    fp32_t* vc = (fp32_t*)malloc(n * sizeof(fp32_t));
+    q8_t*   q8 = (q8_t*)malloc(n / q8_block * sizeof(q8_t));
+    fp32_t* r0 = (fp32_t*)malloc(m * sizeof(fp32_t));
+    fp32_t* r1 = (fp32_t*)malloc(m * sizeof(fp32_t));
+    fatal_if(mx == null || vc == null || q8 == null || r0 == null || r1 == null);
+    uint32_t seed = 1;
+    for (int i = 0; i < n; i++) { vc[i] = (random32(&seed) % 64) / 8.0f - 4; }
+    for (int i = 0; i < n * m; i++) { mx[i] = (random32(&seed) % 64) / 8.0f - 4; }
+    dot.quantize_q8(vc, q8, n);
+    tensor_t t[2] = {
+        { .name = "mx", .type = tensor_fp32, .rank = 2, .shape = { m, n } },
+        { .name = "q8", .type = tensor_q8,   .rank = 1, .shape = { n } }
+    };
+    const void* data[2] = { mx, q8 };
+    fatal_if(tensor_write(filename, t, data, countof(t)) != 0);
+    tensor_file_t f = {0};
+    fatal_if(tensor_open(&f, filename) != 0);
+    fatal_if(f.count != 2);
+    const tensor_t* tm = tensor_find(&f, "mx");
+    const tensor_t* tq = tensor_find(&f, "q8");
+    fatal_if(tm == null || tq == null || tensor_find(&f, "foo") != null);
+    fatal_if(tm->strides[0] != n || tm->strides[1] != 1);
+    fatal_if(tm->bytes != n * m * sizeof(fp32_t));
+    fatal_if(tq->bytes != n / q8_block * sizeof(q8_t));
+    fatal_if(!tensor_verify(&f, tm) || !tensor_verify(&f, tq));
+    const fp32_t* mapped = (const fp32_t*)tensor_data(&f, tm);
+    fatal_if((uintptr_t)mapped % tensor_alignment != 0);
+    fatal_if(memcmp(mapped, mx, tm->bytes) != 0);
+    fatal_if(memcmp(tensor_data(&f, tq), q8, tq->bytes) != 0);
+    dot.gemv_fp32(mx, vc, r0, n, m);
+    dot.gemv_fp32(mapped, vc, r1, n, m);
+    fatal_if(memcmp(r0, r1, m * sizeof(fp32_t)) != 0);
+    tensor_close(&f);
+    fatal_if(remove(filename) != 0);
+    // invalid descriptors are rejected:
+    tensor_t bad = { .name = "q4", .type = tensor_q4, .rank = 1, .shape = { 33 } };
+    fatal_if(tensor_write(filename, &bad, data, 1) != EINVAL);
+    fatal_if(remove(filename) == 0); // must not be created
+    // shape and strides span overflowing int64_t is rejected:
+    tensor_t huge = { .name = "huge", .type = tensor_fp64, .rank = 2,
+                      .shape = { 1LL << 40, 1LL << 40 } };
+    fatal_if(tensor_write(filename, &huge, data, 1) != EINVAL);
+    tensor_t wide = { .name = "wide", .type = tensor_fp32, .rank = 1,
+                      .shape = { 2 }, .strides = { INT64_MAX / 2 } };
+    fatal_if(tensor_write(filename, &wide, data, 1) != EINVAL);
+    fatal_if(remove(filename) == 0);
+    // truncated file is rejected:
+    FILE* truncated = fopen(filename, "wb");
+    fatal_if(truncated == null);
+    tensor_header_t h = { .magic = tensor_magic, .version = tensor_version,
+                          .count = 1 };
+    fatal_if(fwrite(&h, sizeof(h), 1, truncated) != 1);
+    fclose(truncated);
+    fatal_if(tensor_open(&f, filename) != EINVAL);
+    fatal_if(remove(filename) != 0);
+    free(r1);
+    free(r0);
+    free(q8);
+    free(vc);
+    free(mx);
+}
+
+#endif // TENSOR_TEST
+
+tensor_if tensor = {
+    .write  = tensor_write,
+    .open   = tensor_open,
+    .find   = tensor_find,
+    .data   = tensor_data,
+    .verify = tensor_verify,
+    .close  = tensor_close,
+#ifdef TENSOR_TEST
+    .test   = tensor_test
+#endif
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include "rt.h"
+
+#ifdef cplusplus
+extern "C" {
+#endif
+
+// Tensor file: header, descriptors and payloads aligned to 4KB so that
+// memory mapped payloads can be used in place by dot.c kernels and gemv.
+//
+//  tensor_header_t
+//  tensor_t[count]
+//  ... zero padding to tensor_alignment
+//  payload of tensor[0] (offset is multiple of tensor_alignment)
+//  ... zero padding
+//  payload of tensor[1]
+//  ...
+//
+// All integers are little endian. Quantized (q8_t, q4_t, q4m_t see fp16.h)
+// tensors must be contiguous and shape[rank - 1] must be a multiple of
+// the block size.
+
+enum {
+    tensor_fp16 = 0,
+    tensor_bf16 = 1,
+    tensor_fp32 = 2,
+    tensor_fp64 = 3,
+    tensor_q8   = 4,
+    tensor_q4   = 5,
+    tensor_q4m  = 6,
+    tensor_types
+};
+
+enum {
+    tensor_magic     = 0x4654424F, // "OBTF" oblast tensor file
+    tensor_version   = 1,
+    tensor_alignment = 4096,
+    tensor_max_rank  = 4,
+    tensor_max_name  = 64
+};
+
+typedef struct tensor_header_s {
+    uint32_t magic;
+    uint32_t version;
+    int32_t  count;    // number of tensor_t descriptors that follow
+    uint32_t reserved;
+} tensor_header_t;
+
+typedef struct tensor_s {
+    char     name[tensor_max_name]; // zero terminated
+    int32_t  type;  // tensor_fp16, ...
+    int32_t  rank;  // [1..tensor_max_rank]
+    int64_t  shape[tensor_max_rank];   // elements
+    int64_t  strides[tensor_max_rank]; // elements, 0s: row major contiguous
+    int64_t  offset;   // payload offset in the file
+    int64_t  bytes;    // payload bytes
+    uint64_t checksum; // FNV-1a 64 of payload bytes
+} tensor_t;
+
+typedef struct tensor_file_s {
+    const uint8_t* data;  // mapped read only file
+    int64_t        bytes;
+    int32_t        count;
+    const tensor_t* tensors; // [count] in mapped memory
+} tensor_file_t;
+
+typedef struct tensor_if {
+    // write() fills offset, bytes, checksum (and row major strides if all
+    // zero) of tensors[count] and writes them with payloads data[count].
+    // Returns 0 or errno:
+    int (*write)(const char* filename, tensor_t* tensors,
+        const void* const* data, int32_t count);
+    // open() memory maps file and validates header and descriptors (not
+    // payloads checksums). Returns 0 or errno (ENOENT, EACCES, EINVAL...):
+    int (*open)(tensor_file_t* f, const char* filename);
+    const tensor_t* (*find)(const tensor_file_t* f, const char* name); // or null
+    const void* (*data)(const tensor_file_t* f, const tensor_t* t); // in place
+    bool (*verify)(const tensor_file_t* f, const tensor_t* t); // checksum
+    void (*close)(tensor_file_t* f);
+    void (*test)(void); // can be null
+} tensor_if;
+
+extern tensor_if tensor;
+
+#ifdef cplusplus
+} // extern "C"
+#endif